@@ -9,12 +9,15 @@
 #endif //_WIN32
 
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 #include <time.h> //<ctime>
+#include "LogLevel.h"
 
 #ifdef __linux__
 #include <sys/time.h> // struct timeval & gettimeofday()
 #include <semaphore.h>	/* semaphore */
+#include <pthread.h>	/* pthread (log flusher) */
 #include <syslog.h>     /* syslog */
 
 #else // _WIN32
@@ -55,6 +58,21 @@
 #define PATH_LEN_MAX 512
 #endif //LOG_BUF_SIZE
 
+// Asynchronous Log File (Persistent File Descriptor + Ring Buffer + Flusher Thread)
+#if defined(__linux__) && defined(__ENABLE_LOG_FILE_DEBUG__) && !defined(__DISABLE_ASYNC_LOG_FILE__)
+#define __ENABLE_ASYNC_LOG_FILE__
+#endif //__linux__ && __ENABLE_LOG_FILE_DEBUG__ && !__DISABLE_ASYNC_LOG_FILE__
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE (256 * 1024) // Must be Power of 2
+#endif //LOG_RING_SIZE
+
+#ifndef LOG_FLUSH_INTERVAL_MSEC
+#define LOG_FLUSH_INTERVAL_MSEC 50
+#endif //LOG_FLUSH_INTERVAL_MSEC
+#endif //__ENABLE_ASYNC_LOG_FILE__
+
 //////////////////////////////////////////////////////////////////////
 // Global Variable
 //////////////////////////////////////////////////////////////////////
@@ -67,33 +85,53 @@ extern bool g_bEnableErrorMsg;
 // Macro
 //////////////////////////////////////////////////////////////////////
 
+// [Note] Console echo and the debug log file both follow the runtime level
+// (g_nLogLevel, see LogLevel.h), the file additionally g_bEnableDebug. Errors
+// always reach the file while g_bEnableErrorMsg is set. Everything below
+// LOG_LEVEL_MIN is compiled away.
 #ifdef __linux__
-#define DEBUG(format, args...) if(g_bEnableDebug)    DebugLogFormat(format, ##args)
-#define   DBG(format, args...) if(g_bEnableDebug)    DebugLogFormat(format, ##args)
+#define DEBUG(format, args...) \
+do{\
+   if(LOG_ENABLED(LOG_LEVEL_DEBUG) && g_bEnableDebug) \
+      DebugLogFormat(format, ##args); \
+}while(0)
+
+#define DBG(format, args...) \
+do{\
+   if(LOG_ENABLED(LOG_LEVEL_DEBUG) && g_bEnableDebug) \
+      DebugLogFormat(format, ##args); \
+}while(0)
 
 #define ERROR(format, args...) \
 do{\
-   printf("[ERROR] " format "\r\n", ##args); \
-   if(g_bEnableErrorMsg) \
+   ERROR_PRINTF("[ERROR] " format "\r\n", ##args); \
+   if(LOG_COMPILED(LOG_LEVEL_ERROR) && g_bEnableErrorMsg) \
       ErrorLogFormat(format, ##args); \
 }while(0)
 
 #define ERR(format, args...) \
 do{\
-   printf("[ERR] " format "\r\n", ##args); \
-   if(g_bEnableErrorMsg) \
+   ERROR_PRINTF("[ERR] " format "\r\n", ##args); \
+   if(LOG_COMPILED(LOG_LEVEL_ERROR) && g_bEnableErrorMsg) \
       ErrorLogFormat(format, ##args); \
 }while(0)
 
 #define INFO(format, args...) \
 do{\
-   printf("[INFO] " format "\r\n", ##args); \
-   if(g_bEnableDebug) \
+   INFO_PRINTF("[INFO] " format "\r\n", ##args); \
+   if(LOG_ENABLED(LOG_LEVEL_INFO) && g_bEnableDebug) \
       DebugLogFormat(format, ##args); \
 }while(0)
+
+// Raw Buffer Dump (Trace Level, -vv)
+#define DBG_BUFFER(name, buf, len) \
+do{\
+   if(LOG_ENABLED(LOG_LEVEL_TRACE) && g_bEnableDebug) \
+      DebugPrintBuffer(name, buf, len); \
+}while(0)
 #else // _WIN32
-#define DEBUG(format, ...) if(g_bEnableDebug) DebugLogFormat(format, __VA_ARGS__)
-#define   DBG(format, ...) if(g_bEnableDebug) DebugLogFormat(format, __VA_ARGS__)
+#define DEBUG(format, ...) if(LOG_ENABLED(LOG_LEVEL_DEBUG) && g_bEnableDebug) DebugLogFormat(format, __VA_ARGS__)
+#define   DBG(format, ...) if(LOG_ENABLED(LOG_LEVEL_DEBUG) && g_bEnableDebug) DebugLogFormat(format, __VA_ARGS__)
 
 /* warning C4005: 'ERROR' macro redefinition. (Win10 SDK: wingdi.h)
 #define ERROR(format, ...) \
@@ -106,17 +144,26 @@ do{\
 
 #define ERR(format, ...) \
 do{\
-   printf("[ERROR] " format "\r\n", __VA_ARGS__); \
-   if(g_bEnableErrorMsg) \
+   if(LOG_ENABLED(LOG_LEVEL_ERROR)) \
+      fprintf(stderr, "[ERROR] " format "\r\n", __VA_ARGS__); \
+   if(LOG_COMPILED(LOG_LEVEL_ERROR) && g_bEnableErrorMsg) \
       ErrorLogFormat(format, __VA_ARGS__); \
 }while(0)
 
 #define INFO(format, ...) \
 do{\
-   printf("[INFO] " format "\r\n", __VA_ARGS__); \
-   if(g_bEnableDebug) \
+   if(LOG_ENABLED(LOG_LEVEL_INFO)) \
+      printf("[INFO] " format "\r\n", __VA_ARGS__); \
+   if(LOG_ENABLED(LOG_LEVEL_INFO) && g_bEnableDebug) \
       DebugLogFormat(format, __VA_ARGS__); \
 }while(0)
+
+// Raw Buffer Dump (Trace Level, -vv)
+#define DBG_BUFFER(name, buf, len) \
+do{\
+   if(LOG_ENABLED(LOG_LEVEL_TRACE) && g_bEnableDebug) \
+      DebugPrintBuffer(name, buf, len); \
+}while(0)
 #endif // __linux__
 
 //////////////////////////////////////////////////////////////////////
@@ -140,6 +187,12 @@ public:
     void DebugPrintBuffer(unsigned char *pbyBuf, int nLen);
     void DebugPrintBuffer(const char *pszBufName, unsigned char *pbyBuf, int nLen);
 
+    // Write All Pending Log Records to Log File
+    void FlushLog(void);
+
+    // Hex. Dump (" xx" per Byte, Truncated to Fit); Return Number of Bytes Encoded
+    static int EncodeHexString(char *pszDest, size_t nDestSize, const unsigned char *pbyBuf, int nLen);
+
 #ifdef __ENABLE_LOG_FILE_DEBUG__
     // File Operation
     int CleanFileContentWithPath(const char *pszFilePath);
@@ -187,6 +240,35 @@ protected:
     CRITICAL_SECTION m_csFileIoMutex;
 #endif //__linux__
     int m_nFileIoLockCounter;
+
+#ifdef __ENABLE_LOG_FILE_DEBUG__
+    // Log Record (Time Stamp + Tag + Message)
+    void WriteLogRecord(const char *pszTag, const char *pszFormat, ...);
+    void WriteLogRecordV(const char *pszTag, const char *pszFormat, va_list pArgs);
+    int FormatTimeStamp(char *pszBuffer, size_t nBufferSize);
+#endif //__ENABLE_LOG_FILE_DEBUG__
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+    // Asynchronous Log File (One Sink per Process, Shared by Every Instance)
+    int OpenLogFile(void);
+    void CloseLogFile(void);
+    static void PushLogRecord(const char *pszRecord, size_t nLen);
+    static void DrainLogRing(void);
+    static void *LogFlushThread(void *pArg);
+
+    static int s_nLogRefCount;		// Instances Using the Sink (Guarded by s_mtxLogSink)
+    static int s_nLogFd;
+    static char *s_pLogRing;
+    static volatile unsigned int s_nLogRingHead;	// Written by Producers (Serialized by s_mtxLogSink)
+    static volatile unsigned int s_nLogRingTail;	// Written by Consumer (Serialized by s_mtxLogDrain)
+    static volatile unsigned int s_nLogDropCount;
+    static pthread_mutex_t s_mtxLogSink;
+    static pthread_mutex_t s_mtxLogDrain;
+    static sem_t s_semLogFlush;
+    static pthread_t s_tidLogFlusher;
+    static bool s_bLogFlusherRunning;
+    static volatile bool s_bLogFlusherStop;
+#endif //__ENABLE_ASYNC_LOG_FILE__
 }; //CBaseLog
 
 #endif //ndef __BASELOG_H__
@@ -138,10 +138,4 @@ int gen8_get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_si
 int gen8_update_info_page(struct update_info *p_update_info, size_t update_info_size, unsigned char *p_info_page_buf, size_t info_page_buf_size);
 int gen8_get_and_update_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size);
 
-int gen8_set_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int value);
-int gen8_set_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int value);
-
-int gen8_get_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int *p_value);
-int gen8_get_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int *p_value);
-
 #endif //_ELAN_GEN8_TS_FUNC_API_H_
@@ -77,8 +77,8 @@ typedef struct erase_script ERASE_SCRIPT, *P_ERASE_SCRIPT;
  * Global Variables Declaration
  ***************************************************/
 
-// Firmware File Information
-extern int g_firmware_fd;
+// Firmware File Information (of the Calling Thread)
+extern __thread int g_firmware_fd;
 
 /***************************************************
  * Extern Variables Declaration
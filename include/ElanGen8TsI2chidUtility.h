@@ -20,11 +20,18 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include "LogLevel.h"
+#include "HidrawResponseMatcher.h"
 
 /***************************************************
  * Definitions
  ***************************************************/
 
+// Response Signatures for read_response() (See HidrawResponseMatcher.h)
+const struct hidraw_response_pattern ELAN_GEN8_RESPONSE_TEST_VERSION			= {2, {0x52, 0xE0}, {0xFF, 0xF0}};
+const struct hidraw_response_pattern ELAN_GEN8_RESPONSE_ROM_DATA				= {1, {0x95}, {0xFF}};
+const struct hidraw_response_pattern ELAN_GEN8_RESPONSE_ERASE_FLASH_SECTION	= {2, {0xAA, 0xAA}, {0xFF, 0xFF}};
+
 /***************************************************
  * Global Data Structure Declaration
  ***************************************************/
@@ -36,13 +43,7 @@
 // Debug
 extern bool g_debug;
 
-#ifndef DEBUG_PRINTF
-#define DEBUG_PRINTF(fmt, argv...) if(g_debug) printf(fmt, ##argv)
-#endif //DEBUG_PRINTF
-
-#ifndef ERROR_PRINTF
-#define ERROR_PRINTF(fmt, argv...) fprintf(stderr, fmt, ##argv)
-#endif //ERROR_PRINTF
+// DEBUG_PRINTF / ERROR_PRINTF: See LogLevel.h
 
 /***************************************************
  * Extern Variables Declaration
@@ -54,6 +55,9 @@ extern int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 // Read Data
 extern int read_data(unsigned char *data_buf, int len, int timeout_ms);
 
+// Read Response Matching Signature (Unrelated Reports Kept for Later Reads)
+extern int read_response(const struct hidraw_response_pattern *p_pattern, unsigned char *data_buf, int len, int timeout_ms);
+
 // Write Vendor Command
 extern int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 
@@ -61,6 +65,10 @@ extern int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 extern int __hidraw_write(unsigned char* buf, int len, int timeout_ms);
 extern int __hidraw_read(unsigned char* buf, int len, int timeout_ms);
 
+// Output Report Geometry
+extern int get_output_report_id(void);
+extern int get_output_report_length(void);
+
 /***************************************************
  * Function Prototype
  ***************************************************/
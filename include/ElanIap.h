@@ -0,0 +1,119 @@
+/** @file
+
+  Header of Reentrant Library API (libelaniap) for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanIap.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_IAP_H_
+#define _ELAN_IAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Connect to Any Elan Touch Device
+#ifndef ELAN_IAP_ANY_PID
+#define ELAN_IAP_ANY_PID	0x0
+#endif //ELAN_IAP_ANY_PID
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Opaque Contexts
+ *
+ * A device context owns one hidraw connection, an image context owns one
+ * opened firmware file. Calls on one device are serialized by the library;
+ * different devices may be driven from different threads at the same time.
+ */
+struct elan_iap_device;
+struct elan_iap_image;
+struct elan_iap_calibration;
+
+// Page-Write Progress of elan_iap_update_firmware() (block_done of block_count)
+typedef void (*elan_iap_progress_callback)(int block_done, int block_count, void *p_user_data);
+
+// Firmware Information
+struct elan_iap_fw_info
+{
+    unsigned short fw_id;
+    unsigned short fw_version;
+    unsigned short test_version;
+    unsigned short bc_version;
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+/*
+ * All functions return TP_SUCCESS (0) or an error code of ErrCode.h.
+ * In recovery mode only elan_iap_update_firmware() is available; the others
+ * return TP_ERR_COMMAND_NOT_SUPPORT.
+ * When a device call fails, the last hidraw traffic of that device is
+ * dumped to its flight recorder file.
+ */
+
+// Device Context (Connect, then Detect Gen8 / Recovery Mode from Hello Packet)
+int elan_iap_device_open(int pid, struct elan_iap_device **pp_device);
+int elan_iap_device_open_path(const char *device_path, struct elan_iap_device **pp_device);
+void elan_iap_device_close(struct elan_iap_device *p_device);
+int elan_iap_device_get_vid_pid(struct elan_iap_device *p_device, unsigned int *p_vid, unsigned int *p_pid);
+int elan_iap_device_get_state(struct elan_iap_device *p_device, int *p_gen8, int *p_recovery);
+void elan_iap_device_set_progress_callback(struct elan_iap_device *p_device, elan_iap_progress_callback p_callback, void *p_user_data);
+void elan_iap_device_set_reopen_timeout(struct elan_iap_device *p_device, int timeout_ms);	// Node Removed by Panel Reset (0: No Reopen)
+
+// Firmware Information & Calibration
+int elan_iap_get_fw_info(struct elan_iap_device *p_device, struct elan_iap_fw_info *p_fw_info);
+int elan_iap_get_calibration_counter(struct elan_iap_device *p_device, unsigned short *p_calibration_counter);
+int elan_iap_calibrate(struct elan_iap_device *p_device);
+
+/*
+ * Asynchronous Calibration (Gen5/6/7)
+ *
+ * elan_iap_calibrate_async() sends Re-K to one device and returns at once;
+ * elan_iap_calibrate_poll() then waits on any number of started
+ * calibrations together, so N panels take about as long as the slowest
+ * one. poll() returns the number still pending, or a negative error code.
+ * Until its calibration is freed, other calls on the device return
+ * TP_ERR_DEVICE_BUSY; free it before closing the device.
+ */
+int elan_iap_calibrate_async(struct elan_iap_device *p_device, struct elan_iap_calibration **pp_calibration);
+int elan_iap_calibrate_poll(struct elan_iap_calibration **pp_calibrations, int count, int timeout_ms);
+int elan_iap_calibration_get_result(const struct elan_iap_calibration *p_calibration);	// TP_ERR_IO_PENDING Until Completed
+void elan_iap_calibration_free(struct elan_iap_calibration *p_calibration);
+
+// Image Context (Firmware File)
+int elan_iap_image_open(const char *filename, struct elan_iap_image **pp_image);
+void elan_iap_image_close(struct elan_iap_image *p_image);
+
+/*
+ * Firmware Update
+ *
+ * Runs the same flow as "-f": remark ID check, erase, page writes and
+ * information page update. Re-calibration after update is left to the
+ * caller (elan_iap_calibrate() on Gen5/6/7, a 300ms wait on Gen8).
+ */
+int elan_iap_update_firmware(struct elan_iap_device *p_device, struct elan_iap_image *p_image, int skip_action_code);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //_ELAN_IAP_H_
@@ -0,0 +1,91 @@
+/** @file
+
+  Header of Event-Driven Calibration for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsAsyncCalibration.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_ASYNC_CALIBRATION_H_
+#define _ELAN_TS_ASYNC_CALIBRATION_H_
+
+#include "I2CHIDLinuxGet.h"
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Interval of WAITING Progress Callbacks
+#ifndef ASYNC_CALIBRATION_PROGRESS_INTERVAL_MSEC
+#define ASYNC_CALIBRATION_PROGRESS_INTERVAL_MSEC	500
+#endif //ASYNC_CALIBRATION_PROGRESS_INTERVAL_MSEC
+
+// Most Panels Handled by One async_calibration_poll() Call (Bounds Its pollfd Array, Not the fd Values)
+#ifndef ASYNC_CALIBRATION_MAX_HANDLES
+#define ASYNC_CALIBRATION_MAX_HANDLES				1024
+#endif //ASYNC_CALIBRATION_MAX_HANDLES
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+enum async_calibration_state
+{
+    ASYNC_CALIBRATION_WAITING = 0,	// Re-K Command Sent, Waiting for Response
+    ASYNC_CALIBRATION_RETRYING,		// Response Timed Out, Re-K Command Re-Sent
+    ASYNC_CALIBRATION_DONE,			// Response Received
+    ASYNC_CALIBRATION_FAILED		// Out of Retries or I/O Error
+};
+
+// Opaque Handle of One Panel's Calibration
+struct async_calibration;
+
+/*
+ * Progress Callback
+ *
+ * Called from async_calibration_poll() on every state change, and every
+ * ASYNC_CALIBRATION_PROGRESS_INTERVAL_MSEC while WAITING. attempt counts
+ * from 1; elapsed_ms is measured from async_calibration_start().
+ */
+typedef void (*async_calibration_callback)(struct async_calibration *p_calibration, enum async_calibration_state state,
+        int attempt, unsigned int elapsed_ms, void *p_user_data);
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+/*
+ * Same protocol as calibrate_touch_with_error_retry(), without blocking:
+ * start() sends the Re-K command to one panel (hidraw node dev_idx of
+ * p_intf, as g_dev_idx) and returns; poll() waits on
+ * all given panels at once with poll(), and completes each one when its
+ * response report arrives or retries it when its 10s deadline passes.
+ * Calibrating N panels therefore takes about as long as the slowest one.
+ * Write Flash Key & Re-K never go through the feature channel (see
+ * CI2CHIDLinuxGet::SetFeatureChannel()), so the response is always an input
+ * report, and the hidraw fd turns readable when it arrives.
+ */
+int async_calibration_start(CI2CHIDLinuxGet *p_intf, int dev_idx, int retry_count, async_calibration_callback p_callback, void *p_user_data,
+                            struct async_calibration **pp_calibration);
+
+// Dispatch Events for up to timeout_ms (-1: Until All Complete), Return Number Still Pending or Negative Error
+int async_calibration_poll(struct async_calibration **pp_calibrations, int count, int timeout_ms);
+int async_calibration_wait_all(struct async_calibration **pp_calibrations, int count);
+
+// State & Result (TP_ERR_IO_PENDING Until Completed)
+enum async_calibration_state async_calibration_get_state(const struct async_calibration *p_calibration);
+int async_calibration_get_result(const struct async_calibration *p_calibration);
+CI2CHIDLinuxGet *async_calibration_get_interface(const struct async_calibration *p_calibration);
+
+void async_calibration_free(struct async_calibration *p_calibration);
+
+#endif //_ELAN_TS_ASYNC_CALIBRATION_H_
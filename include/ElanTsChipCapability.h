@@ -0,0 +1,78 @@
+/** @file
+
+  Header of Chip Capability Table for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsChipCapability.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_CHIP_CAPABILITY_H_
+#define _ELAN_TS_CHIP_CAPABILITY_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Key Not Used for Lookup (Solution ID / BC Version High Byte)
+#ifndef CHIP_KEY_NONE
+#define CHIP_KEY_NONE	-1
+#endif //CHIP_KEY_NONE
+
+// ROM Read Selector (byte[5] of Read ROM Command)
+#ifndef ELAN_ROM_READ_SELECTOR_53XX
+#define ELAN_ROM_READ_SELECTOR_53XX		0x11
+#endif //ELAN_ROM_READ_SELECTOR_53XX
+
+#ifndef ELAN_ROM_READ_SELECTOR_63XX
+#define ELAN_ROM_READ_SELECTOR_63XX		0x21
+#endif //ELAN_ROM_READ_SELECTOR_63XX
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Chip Generation
+ */
+enum chip_generation
+{
+    CHIP_GEN5 = 5,	// 53XX, 32k Flash
+    CHIP_GEN6 = 6,	// 63XX, 64k Flash
+    CHIP_GEN7 = 7,	// 73XX, 64k Flash
+    CHIP_GEN8 = 8	// EM32F90X, eKTL Firmware
+};
+
+// Chip Capability
+struct chip_capability
+{
+    const char *name;
+    int solution_id;				// High Byte of FW Version (Normal Mode), or CHIP_KEY_NONE
+    int bc_ver_high_byte;			// High Byte of BC Version (Recovery Mode), or CHIP_KEY_NONE
+    enum chip_generation generation;
+    unsigned char rom_read_selector;	// 0x21 / 0x11
+    unsigned int info_page_address;		// Address to Write Information Page
+    unsigned int flash_size_kb;
+};
+typedef struct chip_capability CHIP_CAPABILITY, *P_CHIP_CAPABILITY;
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Lookup (Never Return NULL; Unlisted Parts Get the Default 53XX Record)
+const struct chip_capability *get_chip_capability_by_solution_id(unsigned char solution_id);
+const struct chip_capability *get_chip_capability_by_bc_ver_high_byte(unsigned char bc_ver_high_byte);
+
+#endif //_ELAN_TS_CHIP_CAPABILITY_H_
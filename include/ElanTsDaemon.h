@@ -0,0 +1,76 @@
+/** @file
+
+  Header of Daemon Mode (Unix-Socket RPC) for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsDaemon.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_DAEMON_H_
+#define _ELAN_TS_DAEMON_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Most Devices Held Open at Once
+#ifndef DAEMON_MAX_DEVICES
+#define DAEMON_MAX_DEVICES			16
+#endif //DAEMON_MAX_DEVICES
+
+// Longest hidraw Node Path ("/dev/hidrawN")
+#ifndef DAEMON_DEVICE_PATH_LEN
+#define DAEMON_DEVICE_PATH_LEN		64
+#endif //DAEMON_DEVICE_PATH_LEN
+
+// Longest Request Line (Command, Selector & Arguments)
+#ifndef DAEMON_REQUEST_LENGTH_MAX
+#define DAEMON_REQUEST_LENGTH_MAX	512
+#endif //DAEMON_REQUEST_LENGTH_MAX
+
+// Access Mode of the Socket File (Requests Can Write Flash)
+#ifndef DAEMON_SOCKET_MODE
+#define DAEMON_SOCKET_MODE			0660
+#endif //DAEMON_SOCKET_MODE
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+/*
+ * Serve Requests on a Unix Stream Socket until SIGINT / SIGTERM
+ *
+ * One request per line, one JSON object per reply line:
+ *
+ *   info <selector>                          FW ID / version / test version / BC version
+ *   counter <selector>                       Calibration counter
+ *   calibrate <selector>                     Re-calibrate (Gen5/6/7)
+ *   update <selector> <file> [skip_action]   FW update, then calibrate as "-f" does
+ *   refresh <selector>                       Drop cached state & close the handle
+ *   list                                     Devices held open
+ *
+ * selector takes the forms of a manifest entry (see ElanTsManifest.h): a
+ * hidraw node ("/dev/hidraw3") or an Elan PID in hex, optionally pinned to
+ * an I2C adapter ("2a03@i2c-1"). A bare PID picks the first matching node.
+ *
+ * Selectors are resolved to the hidraw node and its physical path, which
+ * key the device, so "info 0" and "info 2a03" of one panel share a handle
+ * and panels with the same PID stay apart. Each device is opened on first
+ * use, kept open, and served by its own worker thread in request order,
+ * so writes to one device are serialized while different devices run in
+ * parallel. Results of info and counter
+ * are cached until the next calibrate / update / refresh of that device,
+ * and repeated queries are answered without touching the device.
+ */
+int daemon_run(const char *socket_path);
+
+#endif //_ELAN_TS_DAEMON_H_
@@ -0,0 +1,99 @@
+/** @file
+
+  Header of Device I/O Binding for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsDeviceIo.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_DEVICE_IO_H_
+#define _ELAN_TS_DEVICE_IO_H_
+
+#include "I2CHIDLinuxGet.h"
+
+/***************************************************
+ * Global Variables Declaration
+ ***************************************************/
+
+/*
+ * Device & Firmware File of the Calling Thread
+ *
+ * All protocol code reaches the touch through write_cmd() / read_data() /
+ * read_response() / write_vendor_cmd() / __hidraw_write() /
+ * __hidraw_read(), which use device g_dev_idx of g_pIntfGet, and reads
+ * firmware pages from g_firmware_fd. All are thread-local, so threads driving different panels
+ * never share them.
+ */
+extern __thread CI2CHIDLinuxGet *g_pIntfGet;
+extern __thread int g_dev_idx;
+extern __thread int g_firmware_fd;
+
+// Debug (Process-Wide)
+extern bool g_debug;
+
+/***************************************************
+ * Class
+ ***************************************************/
+
+/*
+ * Bind a Device (& Firmware File) to the Calling Thread for the Enclosing Block
+ *
+ * The previous binding is restored on scope exit, so one thread may serve
+ * several devices in turn. Declare it first in a function body, so
+ * goto-to-exit paths never jump over its construction.
+ */
+class CDeviceIoBinding
+{
+public:
+    CDeviceIoBinding(CI2CHIDLinuxGet *pIntfGet, int nFirmwareFd = -1, int nDevIdx = 0) : m_pSavedIntfGet(g_pIntfGet), m_nSavedDevIdx(g_dev_idx), m_nSavedFirmwareFd(g_firmware_fd)
+    {
+        g_pIntfGet = pIntfGet;
+        g_dev_idx = nDevIdx;
+        g_firmware_fd = nFirmwareFd;
+    }
+
+    ~CDeviceIoBinding(void)
+    {
+        g_pIntfGet = m_pSavedIntfGet;
+        g_dev_idx = m_nSavedDevIdx;
+        g_firmware_fd = m_nSavedFirmwareFd;
+    }
+
+private:
+    // Non-Copyable
+    CDeviceIoBinding(const CDeviceIoBinding &);
+    CDeviceIoBinding &operator=(const CDeviceIoBinding &);
+
+    CI2CHIDLinuxGet *m_pSavedIntfGet;
+    int m_nSavedDevIdx;
+    int m_nSavedFirmwareFd;
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// HID Raw I/O Function
+int __hidraw_write(unsigned char* buf, int len, int timeout_ms);
+int __hidraw_read(unsigned char* buf, int len, int timeout_ms);
+
+// Abstract Device I/O Function
+int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
+int read_data(unsigned char *data_buf, int len, int timeout_ms);
+int read_response(const struct hidraw_response_pattern *p_pattern, unsigned char *data_buf, int len, int timeout_ms);
+int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
+
+// Vendor Output Report of the Bound Device (from Report Descriptor, Defaults if Unbound)
+int get_output_report_id(void);
+int get_output_report_length(void);	// Report ID Byte Included
+
+#endif //_ELAN_TS_DEVICE_IO_H_
@@ -23,6 +23,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "LogLevel.h"
 
 /***************************************************
  * Definitions
@@ -136,13 +137,7 @@ typedef struct update_info UPDATE_INFO, *P_UPDATE_INFO;
 // Debug
 extern bool g_debug;
 
-#ifndef DEBUG_PRINTF
-#define DEBUG_PRINTF(fmt, argv...) if(g_debug) printf(fmt, ##argv)
-#endif //DEBUG_PRINTF
-
-#ifndef ERROR_PRINTF
-#define ERROR_PRINTF(fmt, argv...) fprintf(stderr, fmt, ##argv)
-#endif //ERROR_PRINTF
+// DEBUG_PRINTF / ERROR_PRINTF: See LogLevel.h
 
 /***************************************************
  * Extern Variables Declaration
@@ -193,14 +188,6 @@ int get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_size, s
 int update_info_page(struct update_info *p_update_info, size_t update_info_size, unsigned char *p_info_page_buf, size_t info_page_buf_size);
 int get_and_update_info_page(unsigned char solution_id, unsigned char *p_info_page_buf, size_t info_page_buf_size);
 
-int set_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short value);
-int set_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short value);
-int set_info_page_data_bytes(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned char high_byte, unsigned char low_byte);
-
-int get_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short *p_value);
-int get_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short *p_value);
-int get_info_page_data_bytes(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned char *p_high_byte, unsigned char *p_low_byte);
-
 // Information FWID
 int read_info_fwid(unsigned short *p_info_fwid, bool recovery);
 
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include "LogLevel.h"
 
 /***************************************************
  * Definitions
@@ -62,13 +63,7 @@
 // Debug
 extern bool g_debug;
 
-#ifndef DEBUG_PRINTF
-#define DEBUG_PRINTF(fmt, argv...) if(g_debug) printf(fmt, ##argv)
-#endif //DEBUG_PRINTF
-
-#ifndef ERROR_PRINTF
-#define ERROR_PRINTF(fmt, argv...) fprintf(stderr, fmt, ##argv)
-#endif //ERROR_PRINTF
+// DEBUG_PRINTF / ERROR_PRINTF: See LogLevel.h
 
 /*******************************************
  * Extern Variables Declaration
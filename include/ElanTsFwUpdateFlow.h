@@ -57,6 +57,12 @@ enum message_mode
 };
 typedef enum message_mode message_mode_t;
 
+/*
+ * Page-Write Progress of an Update on the Calling Thread
+ * (block_done of block_count page blocks written)
+ */
+typedef void (*update_progress_callback)(int block_done, int block_count, void *p_user_data);
+
 /***************************************************
  * Extern Variables Declaration
  ***************************************************/
@@ -74,6 +80,13 @@ int get_calibration_counter(message_mode_t msg_mode);
 // Remark ID Check
 int check_remark_id(bool recovery);
 
+// Touch State (Gen8 or Not, Recovery Mode or Not)
+int detect_touch_state(bool *p_gen8_touch, bool *p_recovery);
+
+// Update Progress (Per Thread, NULL: Print Dots to Console)
+void set_update_progress_callback(update_progress_callback p_callback, void *p_user_data);
+bool notify_update_progress(int block_done, int block_count);
+
 // Firmware Update
 int update_firmware(char *filename, size_t filename_len, bool recovery, int skip_action_code);
 
@@ -0,0 +1,379 @@
+/** @file
+
+  Header of Firmware Update Pipeline for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsFwUpdatePipeline.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_FW_UPDATE_PIPELINE_H_
+#define _ELAN_TS_FW_UPDATE_PIPELINE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "InterfaceGet.h"
+#include "ElanTsFuncApi.h"
+#include "ElanTsI2chidUtility.h"
+#include "ElanTsFwFileIoUtility.h"
+#include "ElanTsFwUpdateFlow.h"
+#include "ElanGen8TsFwFileIoUtility.h"
+#include "ElanTsPhaseTiming.h"
+#include "ElanTsTraceEvent.h"
+#include "ElanTsProbe.h"
+#include "ElanTsRunMetrics.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Generation Policy of Firmware Update
+ *
+ * Every generation supplies the same set of constants and static hooks.
+ * The pipeline below is instantiated once per policy, so adding a new chip
+ * generation means adding a new policy, not another copy of the flow.
+ *
+ * Constants:
+ *   FW_PAGE_SIZE        Size of a firmware page in the file (address + data + checksum).
+ *   FW_PAGES_PER_BLOCK  Number of pages sent to touch in one write.
+ *   FW_DATA_OFFSET      File offset of the first firmware page.
+ *   RESET_WAIT_MSEC     Time for touch to self-reset after the last page.
+ */
+
+// Gen5 / Gen6 / Gen7
+struct gen5_update_policy
+{
+    enum
+    {
+        FW_PAGE_SIZE		= ELAN_FIRMWARE_PAGE_SIZE,
+        FW_PAGES_PER_BLOCK	= 30,
+        FW_DATA_OFFSET		= 0,
+        RESET_WAIT_MSEC		= 1000
+    };
+
+    static const char *label(void) { return ""; }
+
+    static int validate_firmware(const char *filename);
+    static int get_and_update_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size);
+    static int check_remark_id(bool recovery, bool skip_remark_id_check);
+    static int switch_to_boot_code(bool recovery);
+    static int erase_flash(bool erase_info_page);
+    static int write_pages(unsigned char *p_page_buf, size_t page_buf_size);
+    static int compute_page_count(int firmware_size);
+};
+
+// Gen8
+struct gen8_update_policy
+{
+    enum
+    {
+        FW_PAGE_SIZE		= ELAN_EKTL_FW_PAGE_SIZE,
+        FW_PAGES_PER_BLOCK	= 1,
+        FW_DATA_OFFSET		= ELAN_EKTL_FW_PAGE_SIZE, // Skip eKTL Header Page
+        RESET_WAIT_MSEC		= 700
+    };
+
+    static const char *label(void) { return "Gen8 "; }
+
+    static int validate_firmware(const char *filename);
+    static int get_and_update_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size);
+    static int check_remark_id(bool recovery, bool skip_remark_id_check);
+    static int switch_to_boot_code(bool recovery);
+    static int erase_flash(bool erase_info_page);
+    static int write_pages(unsigned char *p_page_buf, size_t page_buf_size);
+    static int compute_page_count(int firmware_size);
+};
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+// Information Page & Remark ID (One Test Mode Session for the Whole Batch)
+template <class Policy>
+int read_device_info(bool recovery, bool skip_information_update, bool skip_remark_id_check, \
+                     unsigned char *p_info_page_buf, size_t info_page_buf_size)
+{
+    int err = TP_SUCCESS;
+
+    // Recovery Mode or Info. Page Not Needed => Only ROM Reads of Remark ID Check
+    if((recovery == true) || (skip_information_update == true))
+    {
+        phase_begin(PHASE_REMARK_CHECK);
+        err = Policy::check_remark_id(recovery, skip_remark_id_check);
+        phase_end(PHASE_REMARK_CHECK);
+        goto READ_DEVICE_INFO_EXIT;
+    }
+
+    // Test Mode Scope (Left on Every Path Out of This Block)
+    {
+        // Enter Test Mode
+        CTestModeScope test_mode;
+        err = test_mode.status();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Enter Test Mode! err=0x%x.\r\n", __func__, err);
+            goto READ_DEVICE_INFO_EXIT;
+        }
+
+        // Get & Update Information Page
+        phase_begin(PHASE_INFO_PAGE_UPDATE);
+        err = Policy::get_and_update_info_page(p_info_page_buf, info_page_buf_size);
+        phase_end(PHASE_INFO_PAGE_UPDATE);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to get/update Inforamtion Page! err=0x%x.\r\n", __func__, err);
+            goto READ_DEVICE_INFO_EXIT;
+        }
+
+        // Remark ID Check
+        phase_begin(PHASE_REMARK_CHECK);
+        err = Policy::check_remark_id(recovery, skip_remark_id_check);
+        phase_end(PHASE_REMARK_CHECK);
+        if(err != TP_SUCCESS)
+            goto READ_DEVICE_INFO_EXIT;
+
+        // Leave Test Mode
+        err = test_mode.leave();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Leave Test Mode! err=0x%x.\r\n", __func__, err);
+            goto READ_DEVICE_INFO_EXIT;
+        }
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+READ_DEVICE_INFO_EXIT:
+    return err;
+}
+
+// Firmware Update Pipeline
+template <class Policy>
+int run_update_pipeline(char *filename, size_t filename_len, bool recovery, int skip_action_code)
+{
+    int err = TP_SUCCESS,
+        firmware_size = 0,
+        page_count = 0,
+        block_count = 0,
+        block_index = 0,
+        block_page_num = 0;
+    unsigned char info_page_buf[Policy::FW_PAGE_SIZE] = {0},
+                  page_block_buf[Policy::FW_PAGE_SIZE * Policy::FW_PAGES_PER_BLOCK] = {0};
+    bool skip_remark_id_check = false,
+         skip_information_update = false;
+#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
+    bool bDisableOutputBufferDebug = false;
+#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
+
+    //
+    // Validate Arguments
+    //
+
+    // Make Sure Filename Valid
+    if(filename == NULL)
+    {
+        ERROR_PRINTF("%s: Null String of Filename!\r\n", __func__);
+        err = TP_ERR_INVALID_PARAM;
+        goto RUN_UPDATE_PIPELINE_EXIT;
+    }
+
+    // Make Sure Filename Length Valid
+    if(filename_len == 0)
+    {
+        ERROR_PRINTF("%s: Filename String Length is Zero!\r\n", __func__);
+        err = TP_ERR_INVALID_PARAM;
+        goto RUN_UPDATE_PIPELINE_EXIT;
+    }
+
+    // Make Sure File Exist
+    if(access(filename, F_OK) == -1)
+    {
+        ERROR_PRINTF("%s: File \"%s\" does not exist!\r\n", __func__, filename);
+        err = TP_ERR_FILE_NOT_FOUND;
+        goto RUN_UPDATE_PIPELINE_EXIT;
+    }
+
+    // Make Sure File Format Matches Generation
+    err = Policy::validate_firmware(filename);
+    if(err != TP_SUCCESS)
+        goto RUN_UPDATE_PIPELINE_EXIT;
+
+    printf("--------------------------------\r\n");
+    printf("FW Path: \"%s\".\r\n", filename);
+
+    //
+    // Configure Behavior Settings
+    //
+
+    // Set Global Flag of Skip Action Code
+    if((skip_action_code & ACTION_CODE_REMARK_ID_CHECK) == ACTION_CODE_REMARK_ID_CHECK)
+        skip_remark_id_check = true;
+    if((skip_action_code & ACTION_CODE_INFORMATION_UPDATE) == ACTION_CODE_INFORMATION_UPDATE)
+        skip_information_update = true;
+    DEBUG_PRINTF("skip_remark_id_check: %s, skip_information_update: %s.\r\n", \
+                 (skip_remark_id_check) ? "true" : "false", \
+                 (skip_information_update) ? "true" : "false");
+
+    //
+    // Information Page Update & Remark ID Check
+    //
+    err = read_device_info<Policy>(recovery, skip_information_update, skip_remark_id_check, \
+                                   info_page_buf, sizeof(info_page_buf));
+    if(err != TP_SUCCESS)
+        goto RUN_UPDATE_PIPELINE_EXIT;
+
+    //
+    // Switch to Boot Code
+    //
+    phase_begin(PHASE_BOOT_CODE_SWITCH);
+    err = Policy::switch_to_boot_code(recovery);
+    phase_end(PHASE_BOOT_CODE_SWITCH);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to switch to Boot Code! err=0x%x.\r\n", __func__, err);
+        goto RUN_UPDATE_PIPELINE_EXIT;
+    }
+
+    //
+    // Erase Flash
+    //
+    phase_begin(PHASE_ERASE);
+    ELAN_PROBE1(erase_start, ((recovery == false) && (skip_information_update == false)));
+    err = Policy::erase_flash((recovery == false) && (skip_information_update == false));
+    ELAN_PROBE1(erase_done, err);
+    phase_end(PHASE_ERASE);
+    if(err != TP_SUCCESS)
+        goto RUN_UPDATE_PIPELINE_EXIT;
+
+    printf("Start %sFW Update Process...\r\n", Policy::label());
+
+    //
+    // Update with FW Pages
+    //
+
+#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
+    if((g_bEnableOutputBufferDebug == true) && (g_debug == false))
+    {
+        // Disable Output Buffer Debug
+        DEBUG_PRINTF("Disable Output Buffer Debug.\r\n");
+        g_bEnableOutputBufferDebug = false;
+        bDisableOutputBufferDebug = true;
+    }
+#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
+
+    if((recovery == false) && (skip_information_update == false)) // Normal Mode & Don't Skip Information (Section) Update
+    {
+        // Write Information Page
+        DEBUG_PRINTF("Update Information Page...\r\n");
+        phase_begin(PHASE_INFO_PAGE_UPDATE);
+        err = Policy::write_pages(info_page_buf, sizeof(info_page_buf));
+        phase_end(PHASE_INFO_PAGE_UPDATE);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Write Infomation Page! err=0x%x.\r\n", __func__, err);
+            goto RUN_UPDATE_PIPELINE_EXIT;
+        }
+        run_metrics_add_pages_written(1);
+    }
+
+    // Get FW Size, FW Page Count, and FW Page Block Count
+    err = get_firmware_size(&firmware_size);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to Get Firmware Size! err=0x%x.\r\n", __func__, err);
+        goto RUN_UPDATE_PIPELINE_EXIT;
+    }
+    page_count = Policy::compute_page_count(firmware_size);
+    block_count = (page_count / Policy::FW_PAGES_PER_BLOCK) + ((page_count % Policy::FW_PAGES_PER_BLOCK) != 0);
+
+    /* [Note] 2022/06/09
+     * Reset R/W position of file handler is needed.
+     * Since reading remark ID (or erase script) from FW file moves R/W position of file handler.
+     * Thus it's need to set the R/W position to the first FW page before reading page data.
+     */
+
+    // Set Read/Write Position of File Handler to the First FW Page
+    lseek(g_firmware_fd, Policy::FW_DATA_OFFSET, SEEK_SET);
+
+    // Write Main Pages
+    DEBUG_PRINTF("Update %d Main Pages with %d Page Blocks...\r\n", page_count, block_count);
+    for(block_index = 0; block_index < block_count; block_index++)
+    {
+        // Print test progress to inform operators
+        if(notify_update_progress(block_index, block_count) == false)
+        {
+            printf(".");
+            fflush(stdout);
+        }
+
+        // Clear Page Block Buffer
+        memset(page_block_buf, 0, sizeof(page_block_buf));
+
+        // Get Bulk FW Page Data
+        if((block_index == (block_count - 1)) && ((page_count % Policy::FW_PAGES_PER_BLOCK) != 0)) // Last Block
+            block_page_num = page_count % Policy::FW_PAGES_PER_BLOCK; // Last Block Page Number
+        else
+            block_page_num = Policy::FW_PAGES_PER_BLOCK;
+
+        // Load Page Data into Buffer
+        err = retrieve_data_from_firmware(page_block_buf, Policy::FW_PAGE_SIZE * block_page_num);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Retrieve Page Block Data from Firmware! err=0x%x.\r\n", __func__, err);
+            goto RUN_UPDATE_PIPELINE_EXIT;
+        }
+
+        // Write Bulk FW Page Data (One Timing Span per Page Block)
+        phase_begin(PHASE_PAGE_PROGRAM);
+        err = Policy::write_pages(page_block_buf, Policy::FW_PAGE_SIZE * block_page_num);
+        phase_end(PHASE_PAGE_PROGRAM);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Write FW Page Block %d (%d-Page)! err=0x%x.\r\n", __func__, block_index, block_page_num, err);
+            goto RUN_UPDATE_PIPELINE_EXIT;
+        }
+        run_metrics_add_pages_written(block_page_num);
+    }
+    notify_update_progress(block_count, block_count);
+
+    //
+    // Self-Reset
+    //
+    phase_begin(PHASE_RESET_WAIT);
+    trace_usleep(Policy::RESET_WAIT_MSEC * 1000);
+    phase_end(PHASE_RESET_WAIT);
+    printf("\r\n"); //Print CRLF in console
+
+    // Success
+    printf("%sFW Update Finished.\r\n", Policy::label());
+    err = TP_SUCCESS;
+
+RUN_UPDATE_PIPELINE_EXIT:
+
+#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
+    if(bDisableOutputBufferDebug == true)
+    {
+        // Re-Enable Output Buffer Debug
+        DEBUG_PRINTF("Re-Enable Output Buffer Debug.\r\n");
+        g_bEnableOutputBufferDebug = true;
+    }
+#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
+
+    return err;
+}
+
+#endif //_ELAN_TS_FW_UPDATE_PIPELINE_H_
@@ -20,6 +20,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include "LogLevel.h"
+#include "HidrawResponseMatcher.h"
 #include "ElanTsI2chidHwParameters.h" // HW Parameters for Elan Gen5 / Gen6 / Gen7 Touch Controllers
 
 /***************************************************
@@ -46,11 +48,26 @@
 #define	ELAN_I2CHID_READ_PAGE_FRAME_SIZE	0x3C /* 63 - 1(Packet Header 0x99) - 1(Packet Index) -1(Data Length) = 60 Byte */
 #endif //ELAN_I2CHID_READ_PAGE_FRAME_SIZE
 
-// ELAN I2C-HID Buffer Size for IAP
+// ELAN I2C-HID Buffer Size for IAP (Frame Payload of a 33-Byte Output Report, See get_page_frame_size())
 #ifndef ELAN_I2CHID_PAGE_FRAME_SIZE
 #define ELAN_I2CHID_PAGE_FRAME_SIZE				0x1C /* 33-3(3-Byte Vendor Command)-1(ReportID)=29 Byte=>28 Byte(14Word)*/
 #endif //ELAN_I2CHID_PAGE_FRAME_SIZE
 
+// Header of Page-Write Frame: Report ID, 0x21, 2-Byte Data Offset, Data Length
+#ifndef ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE
+#define ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE		5
+#endif //ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE
+
+// Response Signatures for read_response() (See HidrawResponseMatcher.h)
+const struct hidraw_response_pattern ELAN_RESPONSE_FW_ID			= {2, {0x52, 0xF0}, {0xFF, 0xF0}};
+const struct hidraw_response_pattern ELAN_RESPONSE_FW_VERSION		= {2, {0x52, 0x00}, {0xFF, 0xF0}};
+const struct hidraw_response_pattern ELAN_RESPONSE_TEST_VERSION		= {2, {0x52, 0xE0}, {0xFF, 0xF0}};
+const struct hidraw_response_pattern ELAN_RESPONSE_BC_VERSION		= {2, {0x52, 0x10}, {0xFF, 0xF0}};
+const struct hidraw_response_pattern ELAN_RESPONSE_REK_COUNTER		= {2, {0x52, 0xD0}, {0xFF, 0xFF}};
+const struct hidraw_response_pattern ELAN_RESPONSE_ROM_DATA			= {1, {0x95}, {0xFF}};
+const struct hidraw_response_pattern ELAN_RESPONSE_BULK_ROM_DATA	= {1, {0x99}, {0xFF}};
+const struct hidraw_response_pattern ELAN_RESPONSE_FLASH_WRITE		= {2, {0xAA, 0xAA}, {0xFF, 0xFF}};
+
 /*******************************************
  * Global Data Structure Declaration
  ******************************************/
@@ -65,6 +82,45 @@ enum POWER_MODE
     NORMAL_SCAN = 8
 };
 
+/*
+ * Test Mode Scope
+ *
+ * Enters test mode on construction and leaves it exactly once, either by
+ * an explicit leave() or on destruction (error paths included).
+ * Scopes nest: only the outermost one switches the controller mode, so a
+ * caller may hold a scope across a batch of reads (info page, FWID, ...)
+ * while the per-read helpers open their own inner scopes for free.
+ * The nesting depth is kept per thread, i.e. per bound device (see
+ * CDeviceIoBinding), so concurrent updates never share a session.
+ */
+class CTestModeScope
+{
+public:
+    CTestModeScope(void);
+    ~CTestModeScope(void);
+
+    // Result of Entering Test Mode
+    int status(void) const { return m_enter_err; }
+
+    // Leave Test Mode Explicitly (Return Error of Exit Command)
+    int leave(void);
+
+    // Re-Enter Test Mode Held by an Outer Scope after a Failed Read
+    // (No-Op When No Scope Is Held)
+    static int reenter(void);
+
+private:
+    // Non-Copyable
+    CTestModeScope(const CTestModeScope &);
+    CTestModeScope &operator=(const CTestModeScope &);
+
+    int m_enter_err;
+    bool m_held;
+
+    // Nesting Depth of Active Scopes (Per Thread)
+    static __thread int s_depth;
+};
+
 /*******************************************
  * Global Variables Declaration
  ******************************************/
@@ -72,13 +128,7 @@ enum POWER_MODE
 // Debug
 extern bool g_debug;
 
-#ifndef DEBUG_PRINTF
-#define DEBUG_PRINTF(fmt, argv...) if(g_debug) printf(fmt, ##argv)
-#endif //DEBUG_PRINTF
-
-#ifndef ERROR_PRINTF
-#define ERROR_PRINTF(fmt, argv...) fprintf(stderr, fmt, ##argv)
-#endif //ERROR_PRINTF
+// DEBUG_PRINTF / ERROR_PRINTF: See LogLevel.h
 
 /*******************************************
  * Extern Variables Declaration
@@ -90,6 +140,9 @@ extern int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 // Read Data
 extern int read_data(unsigned char *data_buf, int len, int timeout_ms);
 
+// Read Response Matching Signature (Unrelated Reports Kept for Later Reads)
+extern int read_response(const struct hidraw_response_pattern *p_pattern, unsigned char *data_buf, int len, int timeout_ms);
+
 // Write Vendor Command
 extern int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 
@@ -97,6 +150,10 @@ extern int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
 extern int __hidraw_write(unsigned char* buf, int len, int timeout_ms);
 extern int __hidraw_read(unsigned char* buf, int len, int timeout_ms);
 
+// Output Report Geometry
+extern int get_output_report_id(void);
+extern int get_output_report_length(void);
+
 /*******************************************
  * Function Prototype
  ******************************************/
@@ -157,6 +214,7 @@ int send_enter_iap_command(void);
 int send_slave_address(void);
 
 // Frame Data
+int get_page_frame_size(void);
 int write_frame_data(int data_offset, int data_len, unsigned char *frame_buf, int frame_buf_size);
 
 // Flash Write
@@ -0,0 +1,202 @@
+/** @file
+
+  Header of Information Page Field Model for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsInfoPageField.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_INFO_PAGE_FIELD_H_
+#define _ELAN_TS_INFO_PAGE_FIELD_H_
+
+#include "ElanTsFuncApi.h"
+#include "ElanGen8TsFuncApi.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Field Encoding
+ */
+enum info_field_encoding
+{
+    INFO_FIELD_RAW = 0,	// Plain Integer
+    INFO_FIELD_BCD = 1	// Decimal Digits Stored as Hex. Nibbles (2022 => 0x2022)
+};
+
+/*
+ * Information Page Layout
+ *
+ * BASE_ADDRESS      Address of the first byte/word in the page buffer.
+ * ADDRESS_UNIT      Bytes per address step (Gen5 addresses words, Gen8 bytes).
+ * PAGE_SIZE         Size of the page buffer.
+ * READ_BIG_ENDIAN   Byte order of words in a page read back from touch.
+ * WRITE_BIG_ENDIAN  Byte order of words in a page written to touch.
+ */
+struct gen5_info_page_layout
+{
+    enum
+    {
+        BASE_ADDRESS		= ELAN_INFO_MEMORY_PAGE_1_ADDR,
+        ADDRESS_UNIT		= 2,
+        PAGE_SIZE			= ELAN_MEMORY_PAGE_SIZE,
+        READ_BIG_ENDIAN		= 1,
+        WRITE_BIG_ENDIAN	= 0
+    };
+};
+
+struct gen8_info_page_layout
+{
+    enum
+    {
+        BASE_ADDRESS		= ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR,
+        ADDRESS_UNIT		= 1,
+        PAGE_SIZE			= ELAN_GEN8_MEMORY_PAGE_SIZE,
+        READ_BIG_ENDIAN		= 0,
+        WRITE_BIG_ENDIAN	= 0
+    };
+};
+
+/*
+ * Information Page Field
+ *
+ * A field is a WIDTH-byte word at ADDRESS, optionally narrowed to BITS bits
+ * starting at SHIFT (e.g. the month byte of Gen5 month/day word).
+ * The byte offset is resolved at compile time, and an address outside the
+ * layout's page fails to build. Callers validate the page buffer once;
+ * get()/set() are plain loads and stores after that.
+ */
+template <class Layout, unsigned int Address, unsigned int Width, unsigned int Shift, unsigned int Bits, enum info_field_encoding Encoding>
+struct info_page_field
+{
+    enum
+    {
+        ADDRESS	= Address,
+        OFFSET	= (Address - Layout::BASE_ADDRESS) * Layout::ADDRESS_UNIT,
+        WIDTH	= Width
+    };
+
+    // Compile-Time Checks
+    typedef char address_below_page_check[(Address >= (unsigned int)Layout::BASE_ADDRESS) ? 1 : -1];
+    typedef char address_beyond_page_check[((Address - Layout::BASE_ADDRESS) * Layout::ADDRESS_UNIT + Width <= (unsigned int)Layout::PAGE_SIZE) ? 1 : -1];
+    typedef char width_check[((Width == 1) || (Width == 2) || (Width == 4)) ? 1 : -1];
+    typedef char bits_check[((Bits > 0) && (Shift + Bits <= Width * 8)) ? 1 : -1];
+
+    static unsigned int mask(void)
+    {
+        return (Bits >= 32) ? 0xFFFFFFFF : ((1U << Bits) - 1);
+    }
+
+    static unsigned int load_word(const unsigned char *p_page, bool big_endian)
+    {
+        unsigned int word = 0,
+                     index = 0;
+
+        for(index = 0; index < Width; index++)
+        {
+            if(big_endian)
+                word = (word << 8) | p_page[OFFSET + index];
+            else
+                word |= (unsigned int)p_page[OFFSET + index] << (8 * index);
+        }
+        return word;
+    }
+
+    static void store_word(unsigned char *p_page, bool big_endian, unsigned int word)
+    {
+        unsigned int index = 0;
+
+        for(index = 0; index < Width; index++)
+        {
+            if(big_endian)
+                p_page[OFFSET + index] = (unsigned char)(word >> (8 * (Width - 1 - index)));
+            else
+                p_page[OFFSET + index] = (unsigned char)(word >> (8 * index));
+        }
+    }
+
+    // Hex. Nibbles to Int. (Stops at First Non-Decimal Nibble, as strtoul(..., 10) Would)
+    static unsigned int decode(unsigned int raw)
+    {
+        unsigned int value = 0,
+                     nibble = 0;
+        int nibble_index = 0;
+        bool leading = true;
+
+        if(Encoding == INFO_FIELD_RAW)
+            return raw;
+
+        for(nibble_index = (Bits + 3) / 4 - 1; nibble_index >= 0; nibble_index--)
+        {
+            nibble = (raw >> (4 * nibble_index)) & 0xF;
+            if(leading && (nibble == 0))
+                continue;
+            leading = false;
+            if(nibble > 9)
+                break;
+            value = (value * 10) + nibble;
+        }
+        return value;
+    }
+
+    // Int. to Hex. Nibbles (Truncated to Field Width)
+    static unsigned int encode(unsigned int value)
+    {
+        unsigned int raw = 0,
+                     nibble_index = 0;
+
+        if(Encoding == INFO_FIELD_RAW)
+            return value & mask();
+
+        for(nibble_index = 0; (value != 0) && (nibble_index < 8); nibble_index++, value /= 10)
+            raw |= (value % 10) << (4 * nibble_index);
+        return raw & mask();
+    }
+
+    // Read from Page Data Read Back from Touch
+    static unsigned int get(const unsigned char *p_page)
+    {
+        return decode((load_word(p_page, Layout::READ_BIG_ENDIAN) >> Shift) & mask());
+    }
+
+    // Write to Page Data to be Written to Touch
+    static void set(unsigned char *p_page, unsigned int value)
+    {
+        unsigned int word = load_word(p_page, Layout::WRITE_BIG_ENDIAN);
+
+        word = (word & ~(mask() << Shift)) | (encode(value) << Shift);
+        store_word(p_page, Layout::WRITE_BIG_ENDIAN, word);
+    }
+};
+
+/*
+ * Gen5 / Gen6 / Gen7 Information Page Fields
+ */
+typedef info_page_field<gen5_info_page_layout, ELAN_UPDATE_COUNTER_ADDR,               2, 0, 16, INFO_FIELD_RAW> gen5_update_counter_field;
+typedef info_page_field<gen5_info_page_layout, ELAN_LAST_UPDATE_TIME_YEAR_ADDR,        2, 0, 16, INFO_FIELD_BCD> gen5_last_update_year_field;
+typedef info_page_field<gen5_info_page_layout, ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR,   2, 8,  8, INFO_FIELD_BCD> gen5_last_update_month_field;
+typedef info_page_field<gen5_info_page_layout, ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR,   2, 0,  8, INFO_FIELD_BCD> gen5_last_update_day_field;
+typedef info_page_field<gen5_info_page_layout, ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, 2, 8,  8, INFO_FIELD_BCD> gen5_last_update_hour_field;
+typedef info_page_field<gen5_info_page_layout, ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, 2, 0,  8, INFO_FIELD_BCD> gen5_last_update_minute_field;
+
+/*
+ * Gen8 Information Page Fields
+ */
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_UPDATE_COUNTER_ADDR,          4, 0, 32, INFO_FIELD_RAW> gen8_update_counter_field;
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_LAST_UPDATE_TIME_YEAR_ADDR,   4, 0, 32, INFO_FIELD_BCD> gen8_last_update_year_field;
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_LAST_UPDATE_TIME_MONTH_ADDR,  4, 0, 32, INFO_FIELD_BCD> gen8_last_update_month_field;
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_LAST_UPDATE_TIME_DAY_ADDR,    4, 0, 32, INFO_FIELD_BCD> gen8_last_update_day_field;
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_LAST_UPDATE_TIME_HOUR_ADDR,   4, 0, 32, INFO_FIELD_BCD> gen8_last_update_hour_field;
+typedef info_page_field<gen8_info_page_layout, ELAN_GEN8_LAST_UPDATE_TIME_MINUTE_ADDR, 4, 0, 32, INFO_FIELD_BCD> gen8_last_update_minute_field;
+
+#endif //_ELAN_TS_INFO_PAGE_FIELD_H_
@@ -0,0 +1,70 @@
+/** @file
+
+  Header of Fleet Manifest Update for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsManifest.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_MANIFEST_H_
+#define _ELAN_TS_MANIFEST_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Most Entries of One Manifest
+#ifndef MANIFEST_MAX_ENTRIES
+#define MANIFEST_MAX_ENTRIES			64
+#endif //MANIFEST_MAX_ENTRIES
+
+// Updates Running at Once if Not Given
+#ifndef MANIFEST_DEFAULT_MAX_PARALLEL
+#define MANIFEST_DEFAULT_MAX_PARALLEL	4
+#endif //MANIFEST_DEFAULT_MAX_PARALLEL
+
+// Longest Wait on Handed-Over Re-Ks before Picking Up Newly Handed Ones
+#ifndef MANIFEST_CALIBRATION_POLL_MSEC
+#define MANIFEST_CALIBRATION_POLL_MSEC	100
+#endif //MANIFEST_CALIBRATION_POLL_MSEC
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+/*
+ * Update Every Panel Listed in a Manifest
+ *
+ * One entry per line, '#' starts a comment:
+ *
+ *   <selector> <firmware_file> [skip_action_code]
+ *
+ * selector is a hidraw node ("/dev/hidraw3") or an Elan PID in hex,
+ * optionally pinned to an I2C adapter ("2a03@i2c-1").
+ *
+ * All selectors are resolved and every distinct image is checked once
+ * before any panel is touched; a bad line aborts the whole run. Updates
+ * then run on up to max_parallel threads, each printing its own progress,
+ * and a result table is printed at the end. Returns the error of the first
+ * failed entry, or TP_SUCCESS.
+ *
+ * Workers go to idle I2C adapters (from sysfs) first. Panels sharing an
+ * adapter take turns per transfer burst (see HidrawBusScheduler.h), so one
+ * panel's frames go out while the other waits on erase, page write or reset.
+ *
+ * Gen5/6/7 panels are handed over right after Re-K is sent
+ * (elan_iap_calibrate_async()), and all of them are waited on together
+ * by the calling thread, so no worker sits out a calibration.
+ */
+int manifest_run(const char *manifest_file, int max_parallel);
+
+#endif //_ELAN_TS_MANIFEST_H_
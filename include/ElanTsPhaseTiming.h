@@ -0,0 +1,78 @@
+/** @file
+
+  Header of Phase Timing for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsPhaseTiming.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_PHASE_TIMING_H_
+#define _ELAN_TS_PHASE_TIMING_H_
+
+#include <stdio.h>
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Phase of Tool Flow
+ *
+ * A phase may run more than once (e.g. one span per programmed page
+ * block), so each keeps count / total / min / max of its spans.
+ */
+enum phase_id
+{
+    PHASE_DEVICE_DISCOVERY = 0,
+    PHASE_HELLO_PROBE,
+    PHASE_INFO_QUERY,
+    PHASE_INFO_PAGE_UPDATE,
+    PHASE_REMARK_CHECK,
+    PHASE_BOOT_CODE_SWITCH,
+    PHASE_ERASE,
+    PHASE_PAGE_PROGRAM,
+    PHASE_RESET_WAIT,
+    PHASE_POST_UPDATE_INFO,
+    PHASE_CALIBRATION,
+    PHASE_COUNT
+};
+
+struct phase_stat
+{
+    unsigned int count;
+    unsigned long long total_ns;
+    unsigned long long min_ns;
+    unsigned long long max_ns;
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Clock
+unsigned long long phase_timing_now_ns(void);
+
+// Spans
+void phase_timing_reset(void);
+void phase_begin(enum phase_id phase);
+void phase_end(enum phase_id phase);
+
+// Query
+const char *phase_name(enum phase_id phase);
+const struct phase_stat *phase_timing_get_stat(enum phase_id phase);
+unsigned long long phase_timing_elapsed_ns(void);
+
+// Report
+void phase_timing_print_summary(FILE *p_stream);
+int phase_timing_write_json(const char *filename);
+
+#endif //_ELAN_TS_PHASE_TIMING_H_
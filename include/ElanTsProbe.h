@@ -0,0 +1,61 @@
+/** @file
+
+  Header of USDT Static Probes for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsProbe.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_PROBE_H_
+#define _ELAN_TS_PROBE_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+/*
+ * USDT Probes (Provider "elan_iap")
+ *
+ * Built in whenever <sys/sdt.h> (systemtap-sdt-dev) is available, unless
+ * -D__DISABLE_USDT_PROBES__. A probe site is a single nop plus an ELF note
+ * until bpftrace / perf attaches, so release builds keep them.
+ *
+ *   hidraw_write_entry(len, timeout_ms)      hidraw_write_return(ret)
+ *   hidraw_read_entry(len, timeout_ms)       hidraw_read_return(ret)
+ *   flash_write_ack(ret, resp0, resp1)
+ *   erase_start(erase_info_page)             erase_done(ret)
+ *   retry(func, attempt, err)
+ *
+ * Ex: bpftrace -e 'usdt:./i2chid_iap_v2:elan_iap:hidraw_read_entry { @t[tid] = nsecs; }
+ *                  usdt:./i2chid_iap_v2:elan_iap:hidraw_read_return /@t[tid]/ { @us = hist((nsecs - @t[tid]) / 1000); delete(@t[tid]); }'
+ */
+#if defined(__linux__) && !defined(__DISABLE_USDT_PROBES__) && !defined(__ENABLE_USDT_PROBES__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define __ENABLE_USDT_PROBES__
+#endif //__has_include(<sys/sdt.h>)
+#endif //__linux__ && !__DISABLE_USDT_PROBES__ && !__ENABLE_USDT_PROBES__ && __has_include
+
+#ifdef __ENABLE_USDT_PROBES__
+#include <sys/sdt.h>
+
+#define ELAN_PROBE0(name)				DTRACE_PROBE(elan_iap, name)
+#define ELAN_PROBE1(name, a1)			DTRACE_PROBE1(elan_iap, name, a1)
+#define ELAN_PROBE2(name, a1, a2)		DTRACE_PROBE2(elan_iap, name, a1, a2)
+#define ELAN_PROBE3(name, a1, a2, a3)	DTRACE_PROBE3(elan_iap, name, a1, a2, a3)
+#else // Probes Disabled
+#define ELAN_PROBE0(name)				do{}while(0)
+#define ELAN_PROBE1(name, a1)			do{}while(0)
+#define ELAN_PROBE2(name, a1, a2)		do{}while(0)
+#define ELAN_PROBE3(name, a1, a2, a3)	do{}while(0)
+#endif //__ENABLE_USDT_PROBES__
+
+#endif //_ELAN_TS_PROBE_H_
@@ -0,0 +1,79 @@
+/** @file
+
+  Header of OpenMetrics Run Report for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsRunMetrics.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_RUN_METRICS_H_
+#define _ELAN_TS_RUN_METRICS_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Prefix of Every Exported Metric Name
+#ifndef RUN_METRICS_PREFIX
+#define RUN_METRICS_PREFIX			"elan_iap_"
+#endif //RUN_METRICS_PREFIX
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Result of One Tool Run
+ *
+ * FW versions read before run_metrics_mark_updated() are reported as
+ * "before", later ones as "after". Fields never filled in are left out of
+ * the exported file instead of being written as zero.
+ */
+struct run_metrics
+{
+    bool device_valid;
+    unsigned int vid;
+    unsigned int pid;
+
+    bool fw_version_before_valid;
+    unsigned short fw_version_before;
+    bool updated;
+    bool fw_version_after_valid;
+    unsigned short fw_version_after;
+
+    bool calibration_counter_valid;
+    unsigned short calibration_counter;
+
+    unsigned int pages_written;
+    unsigned int retries;
+    int error_code;
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Collect
+void run_metrics_reset(void);
+void run_metrics_set_device(unsigned int vid, unsigned int pid);
+void run_metrics_record_fw_version(unsigned short fw_version);
+void run_metrics_mark_updated(void);
+void run_metrics_record_calibration_counter(unsigned short calibration_counter);
+void run_metrics_add_pages_written(unsigned int page_count);
+void run_metrics_count_retry(void);
+void run_metrics_set_result(int error_code);
+const struct run_metrics *run_metrics_get(void);
+
+// Export (Prometheus Text Format, Written to a Temporary File then Renamed)
+int run_metrics_write_openmetrics(const char *filename);
+
+#endif //_ELAN_TS_RUN_METRICS_H_
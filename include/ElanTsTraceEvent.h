@@ -0,0 +1,100 @@
+/** @file
+
+  Header of Chrome Trace-Event Export for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsTraceEvent.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _ELAN_TS_TRACE_EVENT_H_
+#define _ELAN_TS_TRACE_EVENT_H_
+
+#include <stdio.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Event Categories
+#define TRACE_CATEGORY_PHASE		"phase"
+#define TRACE_CATEGORY_PROTOCOL		"protocol"
+#define TRACE_CATEGORY_IO			"io"
+#define TRACE_CATEGORY_SLEEP		"sleep"
+
+// File Buffer
+#ifndef TRACE_EVENT_BUF_SIZE
+#define TRACE_EVENT_BUF_SIZE		(64 * 1024)
+#endif //TRACE_EVENT_BUF_SIZE
+
+/***************************************************
+ * Global Variables Declaration
+ ***************************************************/
+
+// True While a Trace-Event File is Open
+extern bool g_trace_event_enabled;
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Trace-Event File (JSON Array Format, Loadable by Perfetto / chrome://tracing)
+int trace_event_open(const char *filename);
+void trace_event_close(void);
+
+// Events (No-Ops Unless a File is Open)
+void trace_event_begin(const char *name, const char *category);
+void trace_event_end(const char *name, const char *category);
+void trace_event_counter(const char *name, const char *series, unsigned long long value);
+
+// Transferred Bytes Counter Track
+void trace_event_count_bytes(bool output, int len);
+
+// usleep() Recorded as a Span
+int trace_usleep(unsigned int usec);
+
+/***************************************************
+ * Class
+ ***************************************************/
+
+/*
+ * Span of the Enclosing Block
+ *
+ * Declare it first in a function body, so goto-to-exit paths never jump
+ * over its construction.
+ */
+class CTraceEventScope
+{
+public:
+    CTraceEventScope(const char *name, const char *category) : m_name(name), m_category(category)
+    {
+        if(g_trace_event_enabled)
+            trace_event_begin(m_name, m_category);
+    }
+
+    ~CTraceEventScope(void)
+    {
+        if(g_trace_event_enabled)
+            trace_event_end(m_name, m_category);
+    }
+
+private:
+    // Non-Copyable
+    CTraceEventScope(const CTraceEventScope &);
+    CTraceEventScope &operator=(const CTraceEventScope &);
+
+    const char *m_name;
+    const char *m_category;
+};
+
+#define TRACE_EVENT_SCOPE(category)	CTraceEventScope trace_event_scope(__func__, category)
+
+#endif //_ELAN_TS_TRACE_EVENT_H_
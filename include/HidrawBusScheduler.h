@@ -0,0 +1,61 @@
+/** @file
+
+  Header of I2C Adapter Arbitration for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawBusScheduler.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_BUS_SCHEDULER_H_
+#define _HIDRAW_BUS_SCHEDULER_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Distinct Adapter Tokens (Adapters Beyond This Share a Token)
+#ifndef HIDRAW_BUS_MAX_ADAPTERS
+#define HIDRAW_BUS_MAX_ADAPTERS		32
+#endif //HIDRAW_BUS_MAX_ADAPTERS
+
+// Thread Not Bound to Any Adapter (No Arbitration)
+#define HIDRAW_BUS_NONE				-1
+
+/*
+ * Adapter Token
+ *
+ * The kernel already serializes single I2C transfers, but two panels on one
+ * adapter still interleave their page bursts frame by frame and both slow
+ * down until commands time out. A thread bound to adapter N therefore takes
+ * the token of N at its first hidraw write and keeps it for the rest of the
+ * burst. It gives the token back as soon as it starts waiting on the panel:
+ * a hidraw read (response, erase / page-write ack) or a protocol sleep
+ * (trace_usleep, ex: reset wait). Another panel on the same adapter sends
+ * its frames during that wait, and panels on different adapters never
+ * block each other.
+ */
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Bind Calling Thread to Adapter "i2c-N" (HIDRAW_BUS_NONE: Unbind, Giving the Token Back)
+void hidraw_bus_bind(int i2c_bus);
+int hidraw_bus_get_bound(void);
+
+// Take Token Before a Write (No-Op if Unbound or Already Held)
+void hidraw_bus_acquire(void);
+
+// Give Token Back Before a Wait (No-Op if Not Held)
+void hidraw_bus_release(void);
+
+#endif //_HIDRAW_BUS_SCHEDULER_H_
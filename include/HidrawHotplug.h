@@ -0,0 +1,82 @@
+/** @file
+
+  Header of hidraw Hotplug Waiting (inotify) for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawHotplug.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_HOTPLUG_H_
+#define _HIDRAW_HOTPLUG_H_
+
+#include <stddef.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Directory Watched for hidraw Nodes
+#ifndef HIDRAW_HOTPLUG_DEV_DIR
+#define HIDRAW_HOTPLUG_DEV_DIR					"/dev"
+#endif //HIDRAW_HOTPLUG_DEV_DIR
+
+// Time Given to a Removed Node to Come Back before I/O Fails (0: No Reopen)
+#ifndef HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC
+#define HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC		3000
+#endif //HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC
+
+// Length of HIDIOCGRAWPHYS String
+#ifndef HIDRAW_HOTPLUG_PHYS_LEN_MAX
+#define HIDRAW_HOTPLUG_PHYS_LEN_MAX				64
+#endif //HIDRAW_HOTPLUG_PHYS_LEN_MAX
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Node Wanted by hidraw_hotplug_wait()
+ *
+ * A panel reset by IAP (or leaving recovery mode) may be removed and
+ * re-created by i2c-hid under another hidraw number, and with another PID.
+ * Its physical path (HIDIOCGRAWPHYS, ex: "i2c-ELAN9008:00") stays the same,
+ * so when phys is given it decides the match and pid is not checked.
+ */
+struct hidraw_hotplug_match
+{
+    const char *name;			// "hidraw3" Only (NULL: Any Node)
+    unsigned int vid;
+    unsigned int pid;			// 0: Any PID on BUS_I2C
+    const char *phys;			// NULL or "": Match by VID & PID
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Watched Directory (Default HIDRAW_HOTPLUG_DEV_DIR, ex: a Temp Dir in Tests)
+int hidraw_hotplug_set_dev_dir(const char *dev_dir);
+const char *hidraw_hotplug_get_dev_dir(void);
+
+/*
+ * Wait up to timeout_ms for a Node Matching p_match => "<dev_dir>/hidrawN"
+ *
+ * Nodes already present are checked first, then the directory is watched
+ * with inotify (created / attribute-changed nodes), so no fixed sleep or
+ * polling is involved. Returns TP_ERR_TIMEOUT if no node matched in time.
+ */
+int hidraw_hotplug_wait(const struct hidraw_hotplug_match *p_match, int timeout_ms, char *device_path, size_t device_path_size);
+
+// Physical Path of a Node (HIDIOCGRAWPHYS), "" if the Driver Gives None
+int hidraw_hotplug_get_phys(const char *device_path, char *phys, size_t phys_size);
+
+#endif //_HIDRAW_HOTPLUG_H_
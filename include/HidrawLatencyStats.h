@@ -0,0 +1,132 @@
+/** @file
+
+  Header of hidraw Transport Latency Statistics for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawLatencyStats.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_LATENCY_STATS_H_
+#define _HIDRAW_LATENCY_STATS_H_
+
+#include <stdio.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+/*
+ * Log-Linear (HDR-Style) Histogram of Microseconds
+ *
+ * Values below 2^SUB_BITS land in exact buckets; every higher power of two
+ * is split into 2^SUB_BITS linear sub-buckets, so any recorded value is off
+ * by at most 1/2^SUB_BITS (6.25%) of itself. Values are clamped to
+ * 2^MAX_EXP us (~71 minutes).
+ */
+#define LATENCY_HISTOGRAM_SUB_BITS		4
+#define LATENCY_HISTOGRAM_SUB_COUNT		(1 << LATENCY_HISTOGRAM_SUB_BITS)
+#define LATENCY_HISTOGRAM_MAX_EXP		32
+#define LATENCY_HISTOGRAM_BUCKET_COUNT	(LATENCY_HISTOGRAM_SUB_COUNT * (LATENCY_HISTOGRAM_MAX_EXP - LATENCY_HISTOGRAM_SUB_BITS + 1))
+
+// Command Opcodes: Vendor Command Byte after Report ID (ex: 0x21 Page Frame,
+// 0x22 Flash Write, 0x18 Hello), or First Command Byte after 3-Byte Bridge
+// Header when the Vendor Byte is 0x00
+#define HIDRAW_LATENCY_OPCODE_COUNT				256
+#define HIDRAW_LATENCY_VENDOR_OPCODE_OFFSET		1
+#define HIDRAW_LATENCY_OPCODE_OFFSET			3
+
+/***************************************************
+ * Class
+ ***************************************************/
+
+/*
+ * Counters are only updated with atomic builtins, so a reader (e.g. the
+ * exit report) never blocks or is blocked by the I/O path.
+ */
+class CLatencyHistogram
+{
+public:
+    CLatencyHistogram(void);
+
+    void Record(unsigned long long ullValueUs);
+    void Reset(void);
+
+    unsigned long long GetCount(void) const;
+    unsigned long long GetMax(void) const;
+    unsigned long long GetSum(void) const;
+
+    // Upper Bound of the Bucket Holding the p-th Percentile (0 if Empty)
+    unsigned long long GetPercentile(double dPercentile) const;
+
+    // Bucket Index <-> Value Range
+    static int BucketIndex(unsigned long long ullValueUs);
+    static unsigned long long BucketUpperBound(int nIndex);
+
+protected:
+    unsigned int m_nCounts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    unsigned long long m_ullCount;
+    unsigned long long m_ullSum;
+    unsigned long long m_ullMax;
+};
+
+/*
+ * Latency of hidraw Transfers, Keyed by Command Opcode
+ *
+ *   write    : time spent in write() of the output report
+ *   response : from the end of a write to the first vendor report read after it
+ *   timeouts : reads that timed out while a response was still pending
+ *
+ * Per-opcode entries are allocated on first use and published with
+ * compare-and-swap.
+ */
+class CHidrawLatencyStats
+{
+public:
+    struct opcode_stats
+    {
+        CLatencyHistogram write;
+        CLatencyHistogram response;
+        unsigned long long timeouts;
+    };
+
+    // Constructor / Deconstructor
+    CHidrawLatencyStats(void);
+    ~CHidrawLatencyStats(void);
+
+    void RecordWrite(unsigned char byOpcode, unsigned long long ullLatencyNs);
+    void RecordResponse(unsigned char byOpcode, unsigned long long ullLatencyNs);
+    void RecordTimeout(unsigned char byOpcode);
+    void Reset(void);
+
+    // NULL if the Opcode Never Occurred
+    const struct opcode_stats *GetOpcodeStats(unsigned char byOpcode) const;
+
+    // p50 / p90 / p99 / max Table, One Row per Opcode & Kind
+    void PrintSummary(FILE *pStream) const;
+
+    static unsigned long long NowNs(void);
+
+    // Opcode of an Output Report (-1: Too Short to Tell)
+    static int GetOpcode(const unsigned char *pbyReport, int nLen);
+
+protected:
+    struct opcode_stats *GetOrCreate(unsigned char byOpcode);
+
+    struct opcode_stats * volatile m_pOpcodeStats[HIDRAW_LATENCY_OPCODE_COUNT];
+
+private:
+    // Non-Copyable
+    CHidrawLatencyStats(const CHidrawLatencyStats &);
+    CHidrawLatencyStats &operator=(const CHidrawLatencyStats &);
+};
+
+#endif //_HIDRAW_LATENCY_STATS_H_
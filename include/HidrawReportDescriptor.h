@@ -0,0 +1,73 @@
+/** @file
+
+  Header of HID Report Descriptor Parser for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawReportDescriptor.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_REPORT_DESCRIPTOR_H_
+#define _HIDRAW_REPORT_DESCRIPTOR_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Most Reports Kept from One Descriptor
+#ifndef HIDRAW_RDESC_MAX_REPORTS
+#define HIDRAW_RDESC_MAX_REPORTS		32
+#endif //HIDRAW_RDESC_MAX_REPORTS
+
+// Report Types (Main Items)
+#define HIDRAW_REPORT_TYPE_INPUT		0
+#define HIDRAW_REPORT_TYPE_OUTPUT		1
+#define HIDRAW_REPORT_TYPE_FEATURE		2
+
+// Any Report ID (hidraw_rdesc_find: Largest Vendor-Defined Report of the Type)
+#define HIDRAW_RDESC_ANY_REPORT_ID		-1
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+// One Report of the Descriptor
+struct hidraw_report_info
+{
+    int type;					// HIDRAW_REPORT_TYPE_XXX
+    int report_id;				// 0 if Descriptor Has No Report ID
+    unsigned int size;			// Bytes, Not Counting the Report ID Byte
+    bool vendor;				// Any Field under Vendor-Defined Usage Page (0xFF00-0xFFFF)
+};
+
+// All Reports of the Descriptor
+struct hidraw_report_layout
+{
+    int report_count;
+    struct hidraw_report_info reports[HIDRAW_RDESC_MAX_REPORTS];
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+/*
+ * Sum Report Size x Report Count of Every Input / Output / Feature Item per
+ * (Type, Report ID). Global items (incl. Push / Pop) are tracked, local
+ * items & collections are skipped. Returns TP_ERR_DATA_PATTERN on a
+ * truncated item.
+ */
+int hidraw_rdesc_parse(const unsigned char *p_desc, int desc_len, struct hidraw_report_layout *p_layout);
+
+// Report of Type & ID, NULL if None
+const struct hidraw_report_info *hidraw_rdesc_find(const struct hidraw_report_layout *p_layout, int type, int report_id);
+
+#endif //_HIDRAW_REPORT_DESCRIPTOR_H_
@@ -0,0 +1,108 @@
+/** @file
+
+  Header of hidraw Response Correlation for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawResponseMatcher.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_RESPONSE_MATCHER_H_
+#define _HIDRAW_RESPONSE_MATCHER_H_
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Most Signature Bytes of One Pattern
+#define HIDRAW_RESPONSE_PATTERN_LEN_MAX		4
+
+// Reports Kept Waiting for a Matcher, per Device (Oldest Dropped when Full)
+#ifndef HIDRAW_RESPONSE_QUEUE_SIZE
+#define HIDRAW_RESPONSE_QUEUE_SIZE			16
+#endif //HIDRAW_RESPONSE_QUEUE_SIZE
+
+// Bytes Kept of a Buffered Report (2-Byte Header Included)
+#ifndef HIDRAW_RESPONSE_REPORT_LEN_MAX
+#define HIDRAW_RESPONSE_REPORT_LEN_MAX		0x41	// ELAN_I2CHID_INPUT_BUFFER_SIZE
+#endif //HIDRAW_RESPONSE_REPORT_LEN_MAX
+
+// Buffered Reports Older than This Are Stale & Dropped
+#ifndef HIDRAW_RESPONSE_STALE_MSEC
+#define HIDRAW_RESPONSE_STALE_MSEC			1000
+#endif //HIDRAW_RESPONSE_STALE_MSEC
+
+// Offset of Response Data in a Report: | Report ID | Length | Data |
+#define HIDRAW_RESPONSE_DATA_OFFSET			2
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+/*
+ * Response Signature
+ *
+ * Matches if (data[i] & mask[i]) == value[i] for every i < length, where
+ * data is the response without its 2-byte report header (as returned by
+ * ReadData()). A zero length matches any response.
+ *
+ *   ex: FW version "52 0x xx xx" => {2, {0x52, 0x00}, {0xFF, 0xF0}}
+ */
+struct hidraw_response_pattern
+{
+    int length;
+    unsigned char value[HIDRAW_RESPONSE_PATTERN_LEN_MAX];
+    unsigned char mask[HIDRAW_RESPONSE_PATTERN_LEN_MAX];
+};
+
+/***************************************************
+ * Class
+ ***************************************************/
+
+/*
+ * Reports Read while Waiting for Another Response
+ *
+ * A response read by a matcher it does not fit (a late answer, or the
+ * answer to another outstanding command) is queued here, and handed to
+ * the first later matcher it fits, in arrival order. Not thread-safe,
+ * the owner serializes access.
+ */
+class CHidrawResponseQueue
+{
+public:
+    CHidrawResponseQueue(void);
+
+    void Push(const unsigned char *pbyReport, int nLen);
+
+    // Take Oldest Report Matching pPattern into pbyReport (nLen Bytes), false if None
+    bool Take(const struct hidraw_response_pattern *pPattern, unsigned char *pbyReport, int nLen);
+
+    void Clear(void);
+    int GetCount(void) const;
+
+    static bool Match(const struct hidraw_response_pattern *pPattern, const unsigned char *pbyReport, int nLen);
+
+protected:
+    void DropStale(void);
+
+    struct queued_report
+    {
+        unsigned long long ullTimeNs;
+        int nLen;
+        unsigned char data[HIDRAW_RESPONSE_REPORT_LEN_MAX];
+    };
+
+    struct queued_report m_reports[HIDRAW_RESPONSE_QUEUE_SIZE];
+    int m_nHead;	// Oldest
+    int m_nCount;
+};
+
+#endif //_HIDRAW_RESPONSE_MATCHER_H_
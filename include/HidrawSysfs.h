@@ -0,0 +1,84 @@
+/** @file
+
+  Header of hidraw sysfs Lookup for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawSysfs.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_SYSFS_H_
+#define _HIDRAW_SYSFS_H_
+
+#include <stddef.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+#ifndef HIDRAW_SYSFS_CLASS_DIR
+#define HIDRAW_SYSFS_CLASS_DIR	"/sys/class/hidraw"
+#endif //HIDRAW_SYSFS_CLASS_DIR
+
+// Any I2C Adapter (Selector without "@i2c-N")
+#define HIDRAW_ANY_I2C_BUS		-1
+
+// Most hidraw Nodes Kept by One Scan
+#ifndef HIDRAW_SYSFS_MAX_NODES
+#define HIDRAW_SYSFS_MAX_NODES	64
+#endif //HIDRAW_SYSFS_MAX_NODES
+
+// Lifetime of a Scan, Lookups within This Window Reuse It (0: No Cache)
+#ifndef HIDRAW_SYSFS_CACHE_MSEC
+#define HIDRAW_SYSFS_CACHE_MSEC	2000
+#endif //HIDRAW_SYSFS_CACHE_MSEC
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+// Identity of One hidraw Node, Read from sysfs without Opening the Node
+struct hidraw_sysfs_info
+{
+    char name[32];				// "hidraw3"
+    unsigned int bus_type;		// BUS_I2C (0x18), BUS_USB (0x03), ...
+    unsigned int vid;
+    unsigned int pid;
+    int i2c_bus;				// N of Parent Adapter "i2c-N", -1 if Not on I2C
+    unsigned int version;		// HID Version (wVersionID) from Bound Input Device, 0 if Unknown
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// "hidraw3" or "/dev/hidraw3" => Identity
+int hidraw_sysfs_get_info(const char *hidraw_name, struct hidraw_sysfs_info *p_info);
+
+/*
+ * Every hidraw Node of HIDRAW_SYSFS_CLASS_DIR, No Device Node Opened
+ *
+ * The scan is cached for HIDRAW_SYSFS_CACHE_MSEC, so a PID lookup followed
+ * by a force-connect retry (or several panels resolved in a row) costs one
+ * directory walk. Returns TP_ERR_NOT_FOUND_DEVICE if sysfs is not mounted.
+ */
+int hidraw_sysfs_scan(struct hidraw_sysfs_info *p_list, int list_size, int *p_count);
+
+// Drop the Cached Scan (ex: a Cached Node Failed to Open, Device Re-Enumerated)
+void hidraw_sysfs_invalidate(void);
+
+// First Node Matching VID & PID (PID 0: Any PID on BUS_I2C) on I2C Adapter (HIDRAW_ANY_I2C_BUS: Any) => "/dev/hidrawN"
+int hidraw_sysfs_find(unsigned int vid, unsigned int pid, int i2c_bus, char *device_path, size_t device_path_size);
+
+// Selector "/dev/hidrawN", "<pid_hex>" or "<pid_hex>@i2c-<N>" => "/dev/hidrawN" (PID Match Uses vid)
+int hidraw_sysfs_resolve_selector(unsigned int vid, const char *selector, char *device_path, size_t device_path_size);
+
+#endif //_HIDRAW_SYSFS_H_
@@ -0,0 +1,178 @@
+/** @file
+
+  Header of Binary hidraw Trace for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawTrace.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _HIDRAW_TRACE_H_
+#define _HIDRAW_TRACE_H_
+
+#include <stdio.h>
+#include "ErrCode.h"
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+/*
+ * Trace File Layout (All Fields Little-Endian)
+ *
+ *   File Header (16 bytes)
+ *     | Magic "ELANHIDT" (8) | Version (2) | File Header Size (2) | Record Header Size (2) | Reserved (2) |
+ *
+ *   Record Header (12 bytes), followed by Stored Length bytes of report data
+ *     | Monotonic Timestamp ns (8) | Direction (bit 15) + Report Length (2) | Stored Length (2) |
+ *
+ * Trailing zero bytes of a report are not stored; the decoder pads them back
+ * up to Report Length. A 4-byte command in a 33-byte output report therefore
+ * costs 12 + 7 bytes instead of a text hex dump line.
+ */
+#define HIDRAW_TRACE_MAGIC					"ELANHIDT"
+#define HIDRAW_TRACE_MAGIC_LEN				8
+#define HIDRAW_TRACE_VERSION				1
+#define HIDRAW_TRACE_FILE_HEADER_SIZE		16
+#define HIDRAW_TRACE_RECORD_HEADER_SIZE		12
+
+// Direction
+#define HIDRAW_TRACE_DIR_OUTPUT				0	// Host -> Touch (write)
+#define HIDRAW_TRACE_DIR_INPUT				1	// Touch -> Host (read)
+#define HIDRAW_TRACE_DIR_INPUT_FLAG			0x8000
+#define HIDRAW_TRACE_LENGTH_MASK			0x7FFF
+
+// Largest Report Recorded (HID_MAX_BUFFER_SIZE)
+#ifndef HIDRAW_TRACE_MAX_REPORT_SIZE
+#define HIDRAW_TRACE_MAX_REPORT_SIZE		4096
+#endif //HIDRAW_TRACE_MAX_REPORT_SIZE
+
+// Writer Buffer (Flushed to File When Full or on Close)
+#ifndef HIDRAW_TRACE_BUF_SIZE
+#define HIDRAW_TRACE_BUF_SIZE				(64 * 1024)
+#endif //HIDRAW_TRACE_BUF_SIZE
+
+// Flight Recorder: Last N Reports per Direction (N Must be Power of 2)
+#ifndef HIDRAW_FLIGHT_RECORDER_DEPTH
+#define HIDRAW_FLIGHT_RECORDER_DEPTH		64
+#endif //HIDRAW_FLIGHT_RECORDER_DEPTH
+
+// Flight Recorder Slot Size (Longer Reports are Truncated)
+#ifndef HIDRAW_FLIGHT_RECORDER_SLOT_SIZE
+#define HIDRAW_FLIGHT_RECORDER_SLOT_SIZE	0x41	// ELAN_I2CHID_INPUT_BUFFER_SIZE
+#endif //HIDRAW_FLIGHT_RECORDER_SLOT_SIZE
+
+#ifndef HIDRAW_FLIGHT_RECORDER_PATH_LEN
+#define HIDRAW_FLIGHT_RECORDER_PATH_LEN		512
+#endif //HIDRAW_FLIGHT_RECORDER_PATH_LEN
+
+// Flight Recorders Dumped by the Fatal Signal Handler (Live at the Same Time)
+#ifndef HIDRAW_FLIGHT_RECORDER_MAX_LIVE
+#define HIDRAW_FLIGHT_RECORDER_MAX_LIVE		64
+#endif //HIDRAW_FLIGHT_RECORDER_MAX_LIVE
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+struct hidraw_trace_record
+{
+    unsigned long long timestamp_ns;	// CLOCK_MONOTONIC
+    int direction;						// HIDRAW_TRACE_DIR_*
+    unsigned int length;				// Report Length (Zero-Padded in data[])
+    unsigned char data[HIDRAW_TRACE_MAX_REPORT_SIZE];
+};
+
+/***************************************************
+ * Class
+ ***************************************************/
+
+class CHidrawTrace
+{
+public:
+    // Constructor / Deconstructor
+    CHidrawTrace(void);
+    ~CHidrawTrace(void);
+
+    // Trace File
+    int Open(const char *pszTracePath);
+    void Close(void);
+    bool IsOpen(void);
+
+    // Append One Report (Caller Serializes Access, e.g. with the I/O Mutex)
+    void Record(int nDirection, const unsigned char *pbyBuf, int nLen);
+
+protected:
+    void Flush(void);
+
+    int m_nTraceFd;
+    unsigned char *m_pTraceBuf;
+    unsigned int m_nTraceBufUsed;
+};
+
+/*
+ * Flight Recorder
+ *
+ * Keeps the last HIDRAW_FLIGHT_RECORDER_DEPTH reports of each direction in
+ * memory and writes them out in trace file format only when asked to, e.g.
+ * after a failed flow or from a fatal signal. Dump() only uses
+ * async-signal-safe calls (open/write/close) and no heap.
+ */
+class CHidrawFlightRecorder
+{
+public:
+    // Constructor / Deconstructor
+    CHidrawFlightRecorder(void);
+    ~CHidrawFlightRecorder(void);
+
+    void SetDumpPath(const char *pszDumpPath);
+    const char *GetDumpPath(void);
+
+    // Append One Report (Caller Serializes Access, e.g. with the I/O Mutex)
+    void Record(int nDirection, const unsigned char *pbyBuf, int nLen);
+    int Dump(void);
+
+    // Dump on SIGSEGV / SIGBUS / SIGABRT, then Re-Raise
+    // (One process-level handler, installed by the first live recorder and
+    //  restored by the last; it dumps every live recorder. Returns the slot
+    //  of this recorder, -1 if all HIDRAW_FLIGHT_RECORDER_MAX_LIVE are taken.)
+    int InstallSignalHandler(void);
+    void RemoveSignalHandler(void);
+
+    // Dump Every Live Recorder (Async-Signal-Safe, for Application Handlers
+    // of Signals the Library Leaves Alone, e.g. SIGINT / SIGTERM)
+    static void DumpAll(void);
+
+protected:
+    static void SignalHandler(int nSignal);
+
+    struct flight_record
+    {
+        unsigned long long timestamp_ns;
+        unsigned short length;
+        unsigned char data[HIDRAW_FLIGHT_RECORDER_SLOT_SIZE];
+    };
+
+    struct flight_record m_records[2][HIDRAW_FLIGHT_RECORDER_DEPTH];	// [Direction][Slot]
+    volatile unsigned int m_nRecordCount[2];							// Total Reports per Direction
+    char m_szDumpPath[HIDRAW_FLIGHT_RECORDER_PATH_LEN];
+    int m_nSignalSlot;	// -1 if Not Dumped by Signal Handler
+};
+
+/***************************************************
+ * Function Prototype
+ ***************************************************/
+
+// Trace Reader (Decoder)
+int hidraw_trace_read_header(FILE *p_file);
+int hidraw_trace_read_record(FILE *p_file, struct hidraw_trace_record *p_record);
+
+#endif //_HIDRAW_TRACE_H_
@@ -12,8 +12,13 @@
 #include <sys/select.h>         /* select */
 #include <sys/time.h>           /* timeval */
 #include <errno.h>              /* errno */
+#include <linux/hidraw.h>       /* hidraw_devinfo */
 #include "InterfaceGet.h"
 #include "BaseLog.h"
+#include "HidrawTrace.h"
+#include "HidrawLatencyStats.h"
+#include "HidrawHotplug.h"
+#include "HidrawResponseMatcher.h"
 
 //////////////////////////////////////////////////////////////////////
 // Version of Interface Implementation
@@ -30,6 +35,31 @@
 const int ELAN_HID_TRANSFER_INPUT_TIMEOUT = 2000; //2s //1000; //1s //400; //400ms //300; //300ms //500; //500ms //1000; //1s //100; //100ms //10; //10ms //10000;
 const int ELAN_HID_CONNECT_RETRY = 20;
 
+// Most hidraw Nodes Opened by One Instance (EnumerateDevices)
+#ifndef I2CHID_MAX_DEVICES
+#define I2CHID_MAX_DEVICES				16
+#endif //I2CHID_MAX_DEVICES
+
+// Length of hidraw Node Path ("/dev/hidrawN")
+#ifndef I2CHID_DEV_PATH_LEN_MAX
+#define I2CHID_DEV_PATH_LEN_MAX			64
+#endif //I2CHID_DEV_PATH_LEN_MAX
+
+// Largest Report Carried (Report ID Byte Included), Bounds Descriptor-Sized Reports
+#ifndef I2CHID_REPORT_LEN_MAX
+#define I2CHID_REPORT_LEN_MAX			256
+#endif //I2CHID_REPORT_LEN_MAX
+
+// Poll Interval of GET_FEATURE while Response Not Ready (Feature Channel)
+#ifndef I2CHID_FEATURE_POLL_INTERVAL_USEC
+#define I2CHID_FEATURE_POLL_INTERVAL_USEC	1000
+#endif //I2CHID_FEATURE_POLL_INTERVAL_USEC
+
+// Flight Recorder Dump File (under Log Directory)
+#ifndef DEFAULT_FLIGHT_RECORDER_FILE
+#define DEFAULT_FLIGHT_RECORDER_FILE	"elan_i2chid_iap_flight.trace"
+#endif //DEFAULT_FLIGHT_RECORDER_FILE
+
 /* 		ELAN Output Buffer Format 			*
  *								*
  *    | Report ID (0x03, 1-byte) | Output Report (32-byte) |	*
@@ -39,7 +69,7 @@ const int ELAN_HID_CONNECT_RETRY = 20;
  *    | Report ID (0x02, 1-byte) | Input Report (64-byte)  |	*
  */
 
-/* ELAN I2C-HID Buffer Size */
+/* ELAN I2C-HID Buffer Size (Used if Report Descriptor Gives No Larger Report) */
 const int ELAN_I2CHID_OUTPUT_BUFFER_SIZE = 0x21; //1+32
 const int ELAN_I2CHID_INPUT_BUFFER_SIZE  = 0x41; //1+64
 
@@ -93,6 +123,29 @@ const int ELAN_HID_INPUT_REPORT_ID_PID_7	= 0x0;
 #define __ELAN_HID_DEFINITION__
 #endif //__ELAN_HID_DEFINITION__
 
+//////////////////////////////////////////////////////////////////////
+// Declaration of Data Structure
+//////////////////////////////////////////////////////////////////////
+
+// One hidraw Node of the Instance, Addressed by nDevIdx
+struct i2chid_device
+{
+    int nFd;							// -1 if Closed
+    char szPath[I2CHID_DEV_PATH_LEN_MAX];
+    unsigned short usVID;				// Kept after Close(), 0 if Never Found
+    unsigned short usPID;
+    unsigned short usVersion;			// HID Version (wVersionID), 0 if Unknown
+    char szPhys[HIDRAW_HOTPLUG_PHYS_LEN_MAX];	// Physical Path (HIDIOCGRAWPHYS), Kept across Re-Enumeration
+    unsigned char byOutReportID;		// Vendor Output Report (from Report Descriptor, or PID Rules)
+    int nOutReportLen;					// Bytes Written per Report, Report ID Byte Included
+    unsigned char byInReportID;			// Vendor Input Report
+    int nInReportLen;
+    unsigned char byFeatureReportID;	// Numbered Vendor Feature Report (Feature Channel)
+    int nFeatureReportLen;				// 0 if None
+    bool bFeaturePending;				// Last Output was a Feature Command, ReadData() Answered by GET_FEATURE
+    struct hidraw_response_pattern featureReply;	// Signature of the Pending Feature Response, Stale Reports Rejected
+};
+
 /////////////////////////////////////////////////////////////////////////////
 // CHIDGet Class
 
@@ -109,13 +162,26 @@ public:
 
     // Basic Functions
     int GetDeviceHandle(int nVID, int nPID);
+    int GetDeviceHandleByPath(const char *pszDevicePath);
+    int EnumerateDevices(int nVID);
     void Close(void);
+
+    // Hotplug: Reopen Device nDevIdx after its Node was Removed & Re-Created (Panel Reset)
+    int ReopenDevice(int nDevIdx, int nTimeoutMS);
+    void SetHotplugReopenTimeout(int nTimeoutMS);
+
+    // Feature Channel: Single-Reply Queries of WriteCommand() as SET_FEATURE, the Reply by GET_FEATURE (Devices with a Vendor Feature Report)
+    void SetFeatureChannel(bool bEnable);
+    bool HasFeatureChannel(int nDevIdx = 0);
     bool IsConnected(void);
 
     // TP Command / Data Access Functions
     int WriteCommand(unsigned char* pszCommandBuf, int nCommandLen, int nTimeout = ELAN_WRITE_DATA_TIMEOUT_MSEC, int nDevIdx = 0);
     int ReadData(unsigned char* pszDataBuf, int nDataLen, int nTimeout = ELAN_READ_DATA_TIMEOUT_MSEC, int nDevIdx = 0, bool bFilter = true);
 
+    // Wait for the Response Matching pPattern, Queueing Other Responses (See HidrawResponseMatcher.h)
+    int ReadResponse(const struct hidraw_response_pattern *pPattern, unsigned char* pszDataBuf, int nDataLen, int nTimeout = ELAN_READ_DATA_TIMEOUT_MSEC, int nDevIdx = 0, bool bFilter = true);
+
     // Modify by Johnny 20171123
     int ReadGhostData(unsigned char* pszDataBuf, int nDataLen, int nTimeout = ELAN_READ_DATA_TIMEOUT_MSEC, int nDevIdx = 0, bool bFilter = true);
 
@@ -126,32 +192,69 @@ public:
     // Modify by Johnny 20171123
     int ReadGhostRawBytes(unsigned char* pszBuf, int nLen, int nTimeout = ELAN_READ_DATA_TIMEOUT_MSEC, int nDevIdx = 0);
 
-    // Buffer Size Info.
+    // Buffer Size Info. (Report Lengths of Device 0)
     int GetInBufferSize(void);
     int GetOutBufferSize(void);
 
+    // Vendor Report Geometry of Device nDevIdx (Report ID Byte Included in Length)
+    int GetOutReportID(int nDevIdx = 0);
+    int GetOutReportLength(int nDevIdx = 0);
+    int GetInReportLength(int nDevIdx = 0);
+
+    // Multiple Devices (Index 0 is the Device of GetDeviceHandle / GetDeviceHandleByPath)
+    int GetDevCount(void);
+    int GetDevPath(int nDevIdx, char *pszDevPath, int nLen);
+    int GetDevVersion(unsigned int* p_nVer, int nDevIdx = 0);
+
     // PID
     int	GetDevVidPid(unsigned int* p_nVid, unsigned int* p_nPid, int nDevIdx = 0);
 
+    // hidraw File Descriptor (for select / poll by Event-Driven Callers, -1 if Closed)
+    int GetDevFd(int nDevIdx = 0);
+
+    // Binary Trace of hidraw Reports
+    int EnableTrace(const char *pszTracePath);
+    void DisableTrace(void);
+
+    // Flight Recorder (Last Reports of Each Direction, Dumped on Failure)
+    int DumpFlightRecorder(void);
+
+    // Write / Response Latency Histograms per Command Opcode
+    void PrintLatencyStats(FILE *pStream);
+
 protected:
     // Basic Functions
 
     const char* bus_str(int bus);
     int FindHidrawDevice(int nVID, int nPID, char *pszDevicePath);
-
-    int m_nHidrawFd;
+    int FindHidrawDeviceInDev(int nVID, int nPID, char *pszDevicePath);
+    int OpenDevice(int nDevIdx, const char *pszDevicePath, struct hidraw_devinfo *pInfo);
+    void ConfigureReports(int nDevIdx);
+    static bool GetFeatureReply(const unsigned char *pszCommandBuf, int nCommandLen, struct hidraw_response_pattern *pReply);
+    int WriteFeature(unsigned char* pszBuf, int nLen, const struct hidraw_response_pattern *pReply, int nDevIdx);
+    int ReadFeature(unsigned char* pszBuf, int nLen, int nTimeout, int nDevIdx);
+    bool IsDevIdxValid(int nDevIdx);
+    void RecordReport(int nDirection, const unsigned char *pbyBuf, int nLen);
+    void RecordReadLatency(int nRet, bool bVendorReport);
+
+    struct i2chid_device m_devices[I2CHID_MAX_DEVICES];
+    int m_nDevCount;
+    int m_nHotplugReopenTimeoutMS;	// 0: I/O on a Removed Node Fails without Reopen
+    bool m_bFeatureChannel;
     fd_set m_fdsHidraw;
     struct timeval m_tvRead;
 
     unsigned char *m_inBuf;
     unsigned char *m_outBuf;
-    unsigned int m_inBufSize;
+    unsigned int m_inBufSize;	// I2CHID_REPORT_LEN_MAX, Fits Any Device
     unsigned int m_outBufSize;
     sem_t m_ioMutex;
-
-    unsigned short m_usVID;	// Vendor ID
-    unsigned short m_usPID;	// Product ID
-    unsigned short m_usVersion;	// HID Version
+    CHidrawTrace m_hidrawTrace;	// Guarded by m_ioMutex
+    CHidrawFlightRecorder m_flightRecorder;	// Guarded by m_ioMutex
+    CHidrawLatencyStats m_latencyStats;
+    CHidrawResponseQueue m_responseQueues[I2CHID_MAX_DEVICES];	// Guarded by m_ioMutex
+    int m_nPendingOpcode;	// Opcode of Last Write Awaiting Response (-1: None), Guarded by m_ioMutex
+    unsigned long long m_ullWriteDoneNs;	// Guarded by m_ioMutex
 
     unsigned char m_szOutputBuf[32 /* ELAN_USB_OUTPUT_LEN */];    // Command Raw Buffer
     unsigned char m_szInputBuf[128 /* ELAN_USB_INPUT_LEN * 2 */]; // Data Raw Buffer
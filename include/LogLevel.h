@@ -0,0 +1,96 @@
+/** @file
+
+  Header of Log Levels for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	LogLevel.h
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+********************************************************************
+ Revision History
+
+**/
+
+#ifndef _LOG_LEVEL_H_
+#define _LOG_LEVEL_H_
+
+#include <stdio.h>
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Log Level
+#define LOG_LEVEL_TRACE		0	// Raw Buffer Dumps
+#define LOG_LEVEL_DEBUG		1	// Flow Details
+#define LOG_LEVEL_INFO		2	// Progress Messages
+#define LOG_LEVEL_WARN		3
+#define LOG_LEVEL_ERROR		4
+#define LOG_LEVEL_NONE		5
+
+/*
+ * Build-Time Minimum Level
+ *
+ * Logs below LOG_LEVEL_MIN are compiled away: the call sits behind a constant
+ * false condition, so neither its arguments nor its format string survive
+ * optimization. Release images may build with -DLOG_LEVEL_MIN=LOG_LEVEL_INFO.
+ */
+#ifndef LOG_LEVEL_MIN
+#ifdef __ENABLE_DEBUG__
+#define LOG_LEVEL_MIN		LOG_LEVEL_TRACE
+#else
+#define LOG_LEVEL_MIN		LOG_LEVEL_INFO
+#endif //__ENABLE_DEBUG__
+#endif //LOG_LEVEL_MIN
+
+// Default Runtime Level (Each "-v" Lowers It by One)
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT	LOG_LEVEL_INFO
+#endif //LOG_LEVEL_DEFAULT
+
+/***************************************************
+ * Global Variables Declaration
+ ***************************************************/
+
+// Runtime Console Log Level
+extern int g_nLogLevel;
+
+/***************************************************
+ * Macro
+ ***************************************************/
+
+// Level Compiled in / Level Printed on Console
+#define LOG_COMPILED(level)	((level) >= LOG_LEVEL_MIN)
+#define LOG_ENABLED(level)	(LOG_COMPILED(level) && ((level) >= g_nLogLevel))
+
+#define LOG_PRINT(level, stream, fmt, argv...) \
+do{\
+    if(LOG_ENABLED(level)) \
+        fprintf(stream, fmt, ##argv); \
+}while(0)
+
+#ifndef TRACE_PRINTF
+#define TRACE_PRINTF(fmt, argv...) LOG_PRINT(LOG_LEVEL_TRACE, stdout, fmt, ##argv)
+#endif //TRACE_PRINTF
+
+#ifndef DEBUG_PRINTF
+#define DEBUG_PRINTF(fmt, argv...) LOG_PRINT(LOG_LEVEL_DEBUG, stdout, fmt, ##argv)
+#endif //DEBUG_PRINTF
+
+#ifndef INFO_PRINTF
+#define INFO_PRINTF(fmt, argv...) LOG_PRINT(LOG_LEVEL_INFO, stdout, fmt, ##argv)
+#endif //INFO_PRINTF
+
+#ifndef WARN_PRINTF
+#define WARN_PRINTF(fmt, argv...) LOG_PRINT(LOG_LEVEL_WARN, stderr, fmt, ##argv)
+#endif //WARN_PRINTF
+
+#ifndef ERROR_PRINTF
+#define ERROR_PRINTF(fmt, argv...) LOG_PRINT(LOG_LEVEL_ERROR, stderr, fmt, ##argv)
+#endif //ERROR_PRINTF
+
+#endif //_LOG_LEVEL_H_
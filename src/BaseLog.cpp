@@ -4,9 +4,11 @@
 
 //#include "stdafx.h" // Comment out this line if not windows
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #ifdef __linux__
 #include <unistd.h>
+#include <fcntl.h>
 #else
 #include <io.h>
 #endif //__linux__
@@ -35,6 +37,57 @@ bool g_bEnableDebug = true;
 bool g_bEnableOutputBufferDebug = true;
 bool g_bEnableErrorMsg = true;
 
+// Runtime Console Log Level (LogLevel.h)
+int g_nLogLevel = LOG_LEVEL_DEFAULT;
+
+// Hex. Pair of Every Byte Value (Table-Driven Hex. Dump)
+static const char s_szHexPairTable[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+#ifdef __ENABLE_LOG_FILE_DEBUG__
+// Log Files Cleared by the First Instance Only, Later Ones Append
+// (The library opens one instance per device; clearing again would orphan open descriptors.)
+static volatile int s_nLogFilesCleared = 0;
+#endif //__ENABLE_LOG_FILE_DEBUG__
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+// Process-Wide Asynchronous Log Sink
+int CBaseLog::s_nLogRefCount = 0;
+int CBaseLog::s_nLogFd = -1;
+char *CBaseLog::s_pLogRing = NULL;
+volatile unsigned int CBaseLog::s_nLogRingHead = 0;
+volatile unsigned int CBaseLog::s_nLogRingTail = 0;
+volatile unsigned int CBaseLog::s_nLogDropCount = 0;
+pthread_mutex_t CBaseLog::s_mtxLogSink = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t CBaseLog::s_mtxLogDrain = PTHREAD_MUTEX_INITIALIZER;
+sem_t CBaseLog::s_semLogFlush;
+pthread_t CBaseLog::s_tidLogFlusher;
+bool CBaseLog::s_bLogFlusherRunning = false;
+volatile bool CBaseLog::s_bLogFlusherStop = false;
+#endif //__ENABLE_ASYNC_LOG_FILE__
+
+#ifdef __ENABLE_LOG_FILE_DEBUG__
+// Claim Clearing of Log Files (True for the First Instance of the Process Only)
+static bool claim_log_files_clear(void)
+{
+#ifdef __linux__
+    return __sync_bool_compare_and_swap(&s_nLogFilesCleared, 0, 1);
+#else // _WIN32
+    if (s_nLogFilesCleared != 0)
+        return false;
+    s_nLogFilesCleared = 1;
+    return true;
+#endif //__linux__
+}
+#endif //__ENABLE_LOG_FILE_DEBUG__
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -43,6 +96,7 @@ CBaseLog::CBaseLog(char *pszLogDirPath, char *pszDebugLogFileName)
 {
 #ifdef __ENABLE_LOG_FILE_DEBUG__
     struct stat file_stat;
+    bool bClearLogFiles = claim_log_files_clear();
     //printf("%s: pszLogDirPath=\"%s\", pszDebugLogFileName=\"%s\".\r\n", __func__, pszLogDirPath, pszDebugLogFileName);
 #endif //__ENABLE_LOG_FILE_DEBUG__
 
@@ -95,7 +149,7 @@ CBaseLog::CBaseLog(char *pszLogDirPath, char *pszDebugLogFileName)
 #endif //__linux__
 
         // Clear Content of Debug Log File
-        if (stat(m_szDebugLogFilePath, &file_stat) == 0)
+        if (bClearLogFiles && (stat(m_szDebugLogFilePath, &file_stat) == 0))
         {
             //CleanFileContentWithPath(DEFAULT_DEBUG_LOG_FILE);
             remove(m_szDebugLogFilePath);
@@ -123,14 +177,24 @@ CBaseLog::CBaseLog(char *pszLogDirPath, char *pszDebugLogFileName)
 #endif //__linux__
     //printf("%s: TestResultLogFileName=\"%s\", TestResultLogFilePath=\"%s\".\r\n", __func__, m_szTestResultLogFileName, m_szTestResultLogFilePath);
 
-    // Clear Content of Debug Log File
-    if (stat(m_szTestResultLogFilePath, &file_stat) == 0)
+    // Clear Content of Test Result Log File
+    if (bClearLogFiles && (stat(m_szTestResultLogFilePath, &file_stat) == 0))
         remove(m_szTestResultLogFilePath);
 #endif //__ENABLE_LOG_FILE_DEBUG__
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+    // Open Debug Log File & Start Flusher Thread (First Instance), or Join the Open Sink
+    OpenLogFile();
+#endif //__ENABLE_ASYNC_LOG_FILE__
 }
 
 CBaseLog::~CBaseLog(void)
 {
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+    // Leave Sink (Last Instance Stops Flusher Thread, Writes Pending Records & Closes Debug Log File)
+    CloseLogFile();
+#endif //__ENABLE_ASYNC_LOG_FILE__
+
 #if defined(__linux__) && defined(__ENABLE_SYSLOG_DEBUG__)
     // syslog
     closelog();
@@ -860,10 +924,6 @@ int CBaseLog::GetTestResultLogFilePath(char *pszFilePathBuffer)
 
 void CBaseLog::DebugLog(char *pszLog)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_LOG_FILE_DEBUG__
-
     // Make Sure Log String Valid
     if (pszLog == NULL)
         goto DEBUG_LOG_EXIT;
@@ -884,29 +944,7 @@ void CBaseLog::DebugLog(char *pszLog)
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
-    fd = fopen(m_szDebugLogFilePath, "a+");
-    if (fd == NULL)
-    {
-        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto DEBUG_LOG_EXIT_1;
-    }
-
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
-
-    // Get Current Time
-    time(&m_tRawTime);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    gettimeofday(&m_tvCurTime, NULL);
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
-
-    //Write data to file
-    fprintf(fd, "%s [DEBUG] %s\n", m_szDateTimeBuffer, pszLog);
-
-    fclose(fd);
-
-DEBUG_LOG_EXIT_1:
+    WriteLogRecord("DEBUG", "%s", pszLog);
 #endif //__ENABLE_LOG_FILE_DEBUG__
 
     // Mutex unlocks the critical section
@@ -923,10 +961,9 @@ DEBUG_LOG_EXIT:
 
 void CBaseLog::DebugLogFormat(const char *pszFormat, ...)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_LOG_FILE_DEBUG__
+#ifdef __ENABLE_SYSLOG_DEBUG__
     char szLogBuffer[LOG_BUF_SIZE] = {0};
+#endif //__ENABLE_SYSLOG_DEBUG__
     va_list pArgs;
 
     // Make Sure Log String Valid
@@ -954,35 +991,10 @@ void CBaseLog::DebugLogFormat(const char *pszFormat, ...)
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
-    // Make Sure Log File Exist
-    fd = fopen(m_szDebugLogFilePath, "a+");
-    if (fd == NULL)
-    {
-        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto DEBUG_LOG_FORMAT_EXIT_1;
-    }
-
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
-
-    // Get Current Time
-    time(&m_tRawTime);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    gettimeofday(&m_tvCurTime, NULL);
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
-
-    // Load String to LogBuffer with Variable Argument List
+    // Load String to Log Record with Variable Argument List
     va_start(pArgs, pszFormat);
-    vsnprintf(szLogBuffer, sizeof(szLogBuffer), pszFormat, pArgs);
+    WriteLogRecordV("DEBUG", pszFormat, pArgs);
     va_end(pArgs);
-
-    //Write data to file
-    fprintf(fd, "%s [DEBUG] %s\n", m_szDateTimeBuffer, szLogBuffer);
-
-    fclose(fd);
-
-DEBUG_LOG_FORMAT_EXIT_1:
 #endif //__ENABLE_LOG_FILE_DEBUG__
 
     // Mutex unlocks the critical section
@@ -999,10 +1011,6 @@ DEBUG_LOG_FORMAT_EXIT:
 
 void CBaseLog::ErrorLog(char *pszLog)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_LOG_FILE_DEBUG__
-
     // Make Sure Log String Valid
     if (pszLog == NULL)
         goto ERROR_LOG_EXIT;
@@ -1023,29 +1031,7 @@ void CBaseLog::ErrorLog(char *pszLog)
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
-    fd = fopen(m_szDebugLogFilePath, "a+");
-    if (fd == NULL)
-    {
-        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto ERROR_LOG_EXIT_1;
-    }
-
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
-
-    // Get Current Time
-    time(&m_tRawTime);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    gettimeofday(&m_tvCurTime, NULL);
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
-
-    //Write data to file
-    fprintf(fd, "%s [ERROR] %s\n", m_szDateTimeBuffer, pszLog);
-
-    fclose(fd);
-
-ERROR_LOG_EXIT_1:
+    WriteLogRecord("ERROR", "%s", pszLog);
 #endif //__ENABLE_LOG_FILE_DEBUG__
 
     // Mutex unlocks the critical section
@@ -1062,10 +1048,9 @@ ERROR_LOG_EXIT:
 
 void CBaseLog::ErrorLogFormat(const char *pszFormat, ...)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_SYSLOG_DEBUG__
+#ifdef __ENABLE_SYSLOG_DEBUG__
     char szLogBuffer[LOG_BUF_SIZE] = {0};
+#endif //__ENABLE_SYSLOG_DEBUG__
     va_list pArgs;
 
     // Make Sure Log String Valid
@@ -1093,35 +1078,11 @@ void CBaseLog::ErrorLogFormat(const char *pszFormat, ...)
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
-    fd = fopen(m_szDebugLogFilePath, "a+");
-    if (fd == NULL)
-    {
-        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto ERROR_LOG_FORMAT_EXIT_1;
-    }
-
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
-
-    // Get Current Time
-    time(&m_tRawTime);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    gettimeofday(&m_tvCurTime, NULL);
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
-
-    // Load String to LogBuffer with Variable Argument List
+    // Load String to Log Record with Variable Argument List
     va_start(pArgs, pszFormat);
-    vsnprintf(szLogBuffer, sizeof(szLogBuffer), pszFormat, pArgs);
+    WriteLogRecordV("ERROR", pszFormat, pArgs);
     va_end(pArgs);
-
-    //Write data to file
-    fprintf(fd, "%s [ERROR] %s\n", m_szDateTimeBuffer, szLogBuffer);
-
-    fclose(fd);
-
-ERROR_LOG_FORMAT_EXIT_1:
-#endif //__ENABLE_SYSLOG_DEBUG__
+#endif //__ENABLE_LOG_FILE_DEBUG__
 
     // Mutex unlocks the critical section
 #ifdef __linux__
@@ -1135,14 +1096,40 @@ ERROR_LOG_FORMAT_EXIT:
     return;
 }
 
+int CBaseLog::EncodeHexString(char *pszDest, size_t nDestSize, const unsigned char *pbyBuf, int nLen)
+{
+    char *pcOut = pszDest;
+    const char *pcPair = NULL;
+    int nIndex = 0,
+        nMaxLen = 0;
+
+    if ((pszDest == NULL) || (nDestSize == 0))
+        return 0;
+
+    // Each Byte Takes 3 Characters (" xx"); Keep Room for Null Terminator
+    nMaxLen = (int)((nDestSize - 1) / 3);
+    if ((pbyBuf == NULL) || (nLen < 0))
+        nLen = 0;
+    else if (nLen > nMaxLen)
+        nLen = nMaxLen;
+
+    // One Table Lookup & Three Stores per Byte, No Re-Scan of Output
+    for (nIndex = 0; nIndex < nLen; nIndex++)
+    {
+        pcPair = &s_szHexPairTable[pbyBuf[nIndex] << 1];
+        pcOut[0] = ' ';
+        pcOut[1] = pcPair[0];
+        pcOut[2] = pcPair[1];
+        pcOut += 3;
+    }
+    *pcOut = '\0';
+
+    return nLen;
+}
+
 void CBaseLog::DebugPrintBuffer(unsigned char *pbyBuf, int nLen)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_LOG_FILE_DEBUG__
     int nIndex = 0;
-    unsigned char *pbyData = NULL;
-    char szBuffer[8] = { 0 };
 
     if (pbyBuf == NULL)
     {
@@ -1161,52 +1148,17 @@ void CBaseLog::DebugPrintBuffer(unsigned char *pbyBuf, int nLen)
 #endif //__linux
     m_nFileIoLockCounter++;
 
-#ifdef __ENABLE_SYSLOG_DEBUG__
-    // Set data to buffer
-    memset(m_szDebugBuf, 0, sizeof(m_szDebugBuf));
-    for (nIndex = 0, pbyData = pbyBuf; nIndex < nLen; nIndex++, pbyData++)
-    {
-        memset(szBuffer, 0, sizeof(szBuffer));
-        sprintf(szBuffer, " %02x", *pbyData);
-        strcat(m_szDebugBuf, szBuffer);
-    }
+    // Set data to buffer (Encoded Once for Both Syslog & Log File)
+    EncodeHexString(m_szDebugBuf, sizeof(m_szDebugBuf), pbyBuf, nLen);
+    nIndex = (nLen > 0) ? nLen : 0;
 
+#ifdef __ENABLE_SYSLOG_DEBUG__
     syslog(LOG_DEBUG, "buffer[%d]=%s.\n", nIndex, m_szDebugBuf);
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
-    fd = fopen(m_szDebugLogFilePath, "a+");
-    if (fd == NULL)
-    {
-        printf("%s: Fail to open file \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto DEBUG_PRINT_BUFFER_EXIT_1;
-    }
-
-    // Set data to buffer
-    memset(m_szDebugBuf, 0, sizeof(m_szDebugBuf));
-    for (nIndex = 0, pbyData = pbyBuf; nIndex < nLen; nIndex++, pbyData++)
-    {
-        memset(szBuffer, 0, sizeof(szBuffer));
-        sprintf(szBuffer, " %02x", *pbyData);
-        strcat(m_szDebugBuf, szBuffer);
-    }
-
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
-
-    // Get Current Time
-    time(&m_tRawTime);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    gettimeofday(&m_tvCurTime, NULL);
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
-
-    // Write buffer to file
-    fprintf(fd, "%s [DEBUG] buffer[%d]=%s.\n", m_szDateTimeBuffer, nIndex, m_szDebugBuf);
-
-    fclose(fd);
-
-DEBUG_PRINT_BUFFER_EXIT_1:
+    // Write buffer to log
+    WriteLogRecord("DEBUG", "buffer[%d]=%s.", nIndex, m_szDebugBuf);
 #endif //__ENABLE_LOG_FILE_DEBUG__
 
     // Mutex unlocks the critical section
@@ -1223,12 +1175,7 @@ DEBUG_PRINT_BUFFER_EXIT:
 
 void CBaseLog::DebugPrintBuffer(const char *pszBufName, unsigned char *pbyBuf, int nLen)
 {
-#ifdef __ENABLE_LOG_FILE_DEBUG__
-    FILE *fd = NULL;
-#endif //__ENABLE_LOG_FILE_DEBUG__
     int nIndex = 0;
-    unsigned char *pbyData = NULL;
-    char szBuffer[8] = { 0 };
 
     if ((!pszBufName) || (!pbyBuf))
     {
@@ -1247,63 +1194,329 @@ void CBaseLog::DebugPrintBuffer(const char *pszBufName, unsigned char *pbyBuf, i
 #endif //__linux
     m_nFileIoLockCounter++;
 
-#ifdef __ENABLE_SYSLOG_DEBUG__
-    // Set data to buffer
-    memset(m_szDebugBuf, 0, sizeof(m_szDebugBuf));
-    for (nIndex = 0, pbyData = pbyBuf; nIndex < nLen; nIndex++, pbyData++)
-    {
-        memset(szBuffer, 0, sizeof(szBuffer));
-        sprintf(szBuffer, " %02x", *pbyData);
-        strcat(m_szDebugBuf, szBuffer);
-    }
+    // Set data to buffer (Encoded Once for Both Syslog & Log File)
+    EncodeHexString(m_szDebugBuf, sizeof(m_szDebugBuf), pbyBuf, nLen);
+    nIndex = (nLen > 0) ? nLen : 0;
 
+#ifdef __ENABLE_SYSLOG_DEBUG__
     syslog(LOG_DEBUG, "%s[%d]=%s.\n", pszBufName, nIndex, m_szDebugBuf);
 #endif //__ENABLE_SYSLOG_DEBUG__
 
 #ifdef __ENABLE_LOG_FILE_DEBUG__
+    // Write buffer to log
+    WriteLogRecord("DEBUG", "%s[%d]=%s.", pszBufName, nIndex, m_szDebugBuf);
+#endif //__ENABLE_LOG_FILE_DEBUG__
+
+    // Mutex unlocks the critical section
+#ifdef __linux__
+    sem_post(&m_semFileIoMutex);
+#else // _WIN32
+    LeaveCriticalSection(&m_csFileIoMutex);
+#endif // __linux__
+    m_nFileIoLockCounter--;
+
+DEBUG_PRINT_BUFFER_2_EXIT:
+    return;
+}
+
+#ifdef __ENABLE_LOG_FILE_DEBUG__
+int CBaseLog::FormatTimeStamp(char *pszBuffer, size_t nBufferSize)
+{
+#ifdef __linux__
+    struct tm tmLocal;
+#endif //__linux__
+
+    gettimeofday(&m_tvCurTime, NULL);
+
+    // Date & Time Only Change Once per Second, Re-Format Them Only Then
+    if ((m_tvCurTime.tv_sec != m_tRawTime) || (m_szDateBuffer[0] == '\0'))
+    {
+        m_tRawTime = m_tvCurTime.tv_sec;
+        memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
+#ifdef __linux__
+        localtime_r(&m_tRawTime, &tmLocal);
+        strftime(m_szDateBuffer, sizeof(m_szDateBuffer), "%Y-%m-%d %H:%M:%S", &tmLocal);
+#else //_WIN32
+        strftime(m_szDateBuffer, sizeof(m_szDateBuffer), "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
+#endif //__linux__
+    }
+
+    return snprintf(pszBuffer, nBufferSize, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
+}
+
+void CBaseLog::WriteLogRecord(const char *pszTag, const char *pszFormat, ...)
+{
+    va_list pArgs;
+
+    va_start(pArgs, pszFormat);
+    WriteLogRecordV(pszTag, pszFormat, pArgs);
+    va_end(pArgs);
+}
+
+void CBaseLog::WriteLogRecordV(const char *pszTag, const char *pszFormat, va_list pArgs)
+{
+#ifndef __ENABLE_ASYNC_LOG_FILE__
+    FILE *fd = NULL;
+#endif //__ENABLE_ASYNC_LOG_FILE__
+    char szRecord[LOG_BUF_SIZE * 2];
+    int nLen = 0;
+
+    // [Note] Caller must hold m_semFileIoMutex (date buffer & ring head are shared).
+
+    // "<Time Stamp> [<Tag>] <Message>\n"
+    nLen = FormatTimeStamp(szRecord, sizeof(szRecord));
+    nLen += snprintf(&szRecord[nLen], sizeof(szRecord) - nLen, " [%s] ", pszTag);
+    nLen += vsnprintf(&szRecord[nLen], sizeof(szRecord) - nLen, pszFormat, pArgs);
+    if (nLen > (int)sizeof(szRecord) - 2) // Truncated
+        nLen = sizeof(szRecord) - 2;
+    szRecord[nLen++] = '\n';
+    szRecord[nLen] = '\0';
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+    PushLogRecord(szRecord, nLen);
+#else
     fd = fopen(m_szDebugLogFilePath, "a+");
     if (fd == NULL)
     {
-        printf("%s: Fail to open file \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
-        goto DEBUG_PRINT_BUFFER_2_EXIT_1;
+        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
+        return;
     }
 
-    // Set data to buffer
-    memset(m_szDebugBuf, 0, sizeof(m_szDebugBuf));
-    for (nIndex = 0, pbyData = pbyBuf; nIndex < nLen; nIndex++, pbyData++)
+    //Write data to file
+    fwrite(szRecord, 1, nLen, fd);
+
+    fclose(fd);
+#endif //__ENABLE_ASYNC_LOG_FILE__
+}
+#endif //__ENABLE_LOG_FILE_DEBUG__
+
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+int CBaseLog::OpenLogFile(void)
+{
+    int nRet = TP_SUCCESS;
+
+    pthread_mutex_lock(&s_mtxLogSink);
+
+    // Sink Already Opened by Another Instance
+    if (s_nLogRefCount++ > 0)
+        goto OPEN_LOG_FILE_EXIT;
+
+    // Initialize Sink State
+    s_nLogRingHead = 0;
+    s_nLogRingTail = 0;
+    s_nLogDropCount = 0;
+    s_bLogFlusherStop = false;
+    sem_init(&s_semLogFlush, 0 /*scope is in this file*/, 0 /*inactive in initial*/);
+
+    // Keep Log File Open Until the Last Instance Leaves
+    // (rename() in SetLogDirPath() / SetDebugLogFileName() keeps the descriptor valid.)
+    s_nLogFd = open(m_szDebugLogFilePath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    if (s_nLogFd < 0)
     {
-        memset(szBuffer, 0, sizeof(szBuffer));
-        sprintf(szBuffer, " %02x", *pbyData);
-        strcat(m_szDebugBuf, szBuffer);
+        printf("%s: Fail to open \"%s\"! (errno=%d)\r\n", __func__, m_szDebugLogFilePath, errno);
+        nRet = TP_ERR_IO_ERROR;
+        goto OPEN_LOG_FILE_EXIT;
     }
 
-    // Clear Buffer
-    memset(m_szDateBuffer, 0, sizeof(m_szDateBuffer));
-    memset(m_szDateTimeBuffer, 0, sizeof(m_szDateTimeBuffer));
+    // Allocate Log Ring (Write Through If Fail)
+    s_pLogRing = (char *)malloc(LOG_RING_SIZE);
+    if (s_pLogRing == NULL)
+    {
+        printf("%s: Fail to allocate log ring! Write log file synchronously.\r\n", __func__);
+        goto OPEN_LOG_FILE_EXIT;
+    }
 
-    // Get Current Time
-    time(&m_tRawTime);
-    gettimeofday(&m_tvCurTime, NULL);
-    strftime(m_szDateBuffer, 80, "%Y-%m-%d %H:%M:%S", localtime(&m_tRawTime));
-    sprintf(m_szDateTimeBuffer, "%s:%03d:%03d", m_szDateBuffer, (int)m_tvCurTime.tv_usec / 1000, (int)m_tvCurTime.tv_usec % 1000);
+    // Start Flusher Thread (Drain Inline If Fail)
+    if (pthread_create(&s_tidLogFlusher, NULL, LogFlushThread, NULL) == 0)
+        s_bLogFlusherRunning = true;
+    else
+        printf("%s: Fail to create log flusher thread! (errno=%d)\r\n", __func__, errno);
 
-    // Write buffer to file
-    fprintf(fd, "%s [DEBUG] %s[%d]=%s.\n", m_szDateTimeBuffer, pszBufName, nIndex, m_szDebugBuf);
+OPEN_LOG_FILE_EXIT:
+    pthread_mutex_unlock(&s_mtxLogSink);
+    return nRet;
+}
 
-    fclose(fd);
+void CBaseLog::CloseLogFile(void)
+{
+    pthread_mutex_lock(&s_mtxLogSink);
 
-DEBUG_PRINT_BUFFER_2_EXIT_1:
-#endif //__ENABLE_LOG_FILE_DEBUG__
+    // Other Instances Still Log
+    if (--s_nLogRefCount > 0)
+        goto CLOSE_LOG_FILE_EXIT;
 
-    // Mutex unlocks the critical section
-#ifdef __linux__
-    sem_post(&m_semFileIoMutex);
-#else // _WIN32
-    LeaveCriticalSection(&m_csFileIoMutex);
-#endif // __linux__
-    m_nFileIoLockCounter--;
+    // Stop Flusher Thread
+    if (s_bLogFlusherRunning == true)
+    {
+        s_bLogFlusherStop = true;
+        sem_post(&s_semLogFlush);
+        pthread_join(s_tidLogFlusher, NULL);
+        s_bLogFlusherRunning = false;
+    }
 
-DEBUG_PRINT_BUFFER_2_EXIT:
-    return;
+    // Write Remaining Records
+    DrainLogRing();
+
+    if (s_nLogFd >= 0)
+    {
+        close(s_nLogFd);
+        s_nLogFd = -1;
+    }
+
+    if (s_pLogRing != NULL)
+    {
+        free(s_pLogRing);
+        s_pLogRing = NULL;
+    }
+
+    sem_destroy(&s_semLogFlush);
+
+CLOSE_LOG_FILE_EXIT:
+    pthread_mutex_unlock(&s_mtxLogSink);
 }
 
+void CBaseLog::PushLogRecord(const char *pszRecord, size_t nLen)
+{
+    unsigned int nHead = 0,
+                 nTail = 0,
+                 nOffset = 0,
+                 nFirstLen = 0;
+
+    // Producers of Every Instance Share the Ring
+    pthread_mutex_lock(&s_mtxLogSink);
+
+    // No Ring: Write Through
+    if (s_pLogRing == NULL)
+    {
+        if ((s_nLogFd >= 0) && (write(s_nLogFd, pszRecord, nLen) < 0))
+            printf("%s: Fail to write log file! (errno=%d)\r\n", __func__, errno);
+        goto PUSH_LOG_RECORD_EXIT;
+    }
+
+    // Read Tail before Reusing Space Released by Consumer
+    nHead = s_nLogRingHead;
+    nTail = s_nLogRingTail;
+    __sync_synchronize();
+
+    // Ring Full: Drop Record (Counted & Reported by Consumer)
+    if (nLen > LOG_RING_SIZE - (nHead - nTail))
+    {
+        __sync_fetch_and_add(&s_nLogDropCount, 1);
+        sem_post(&s_semLogFlush);
+        goto PUSH_LOG_RECORD_EXIT;
+    }
+
+    // Copy Record into Ring (May Wrap Around)
+    nOffset = nHead & (LOG_RING_SIZE - 1);
+    nFirstLen = LOG_RING_SIZE - nOffset;
+    if (nFirstLen > nLen)
+        nFirstLen = nLen;
+    memcpy(&s_pLogRing[nOffset], pszRecord, nFirstLen);
+    memcpy(s_pLogRing, pszRecord + nFirstLen, nLen - nFirstLen);
+
+    // Publish Record before Moving Head
+    __sync_synchronize();
+    s_nLogRingHead = nHead + nLen;
+
+    // Wake Flusher Early Once Ring Crosses Half Full; Otherwise It Wakes on Its Own Interval
+    if (((nHead - nTail) < LOG_RING_SIZE / 2) && ((nHead + nLen - nTail) >= LOG_RING_SIZE / 2))
+        sem_post(&s_semLogFlush);
+
+    // No Flusher Thread: Drain Inline
+    if (s_bLogFlusherRunning == false)
+        DrainLogRing();
+
+PUSH_LOG_RECORD_EXIT:
+    pthread_mutex_unlock(&s_mtxLogSink);
+}
+
+void CBaseLog::DrainLogRing(void)
+{
+    unsigned int nHead = 0,
+                 nTail = 0,
+                 nOffset = 0,
+                 nChunkLen = 0,
+                 nDropCount = 0;
+    ssize_t nWritten = 0;
+    char szNote[64] = {0};
+    int nNoteLen = 0;
+
+    if (s_pLogRing == NULL)
+        return;
+
+    pthread_mutex_lock(&s_mtxLogDrain);
+
+    // Read Head before Record Data
+    nHead = s_nLogRingHead;
+    __sync_synchronize();
+    nTail = s_nLogRingTail;
+
+    while (nTail != nHead)
+    {
+        nOffset = nTail & (LOG_RING_SIZE - 1);
+        nChunkLen = nHead - nTail;
+        if (nChunkLen > LOG_RING_SIZE - nOffset)
+            nChunkLen = LOG_RING_SIZE - nOffset;
+
+        nWritten = (s_nLogFd >= 0) ? write(s_nLogFd, &s_pLogRing[nOffset], nChunkLen) : (ssize_t)nChunkLen;
+        if (nWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // Discard What Cannot Be Written, Rather Than Spinning on It
+            printf("%s: Fail to write log file! (errno=%d)\r\n", __func__, errno);
+            nTail = nHead;
+            break;
+        }
+        nTail += nWritten;
+    }
+
+    // Finish Reading Record Data before Releasing Space to Producers
+    __sync_synchronize();
+    s_nLogRingTail = nTail;
+
+    // Report Dropped Records
+    nDropCount = __sync_fetch_and_and(&s_nLogDropCount, 0);
+    if ((nDropCount != 0) && (s_nLogFd >= 0))
+    {
+        nNoteLen = snprintf(szNote, sizeof(szNote), "[ERROR] %u log record(s) dropped (ring full).\n", nDropCount);
+        if (write(s_nLogFd, szNote, nNoteLen) < 0)
+            printf("%s: Fail to write log file! (errno=%d)\r\n", __func__, errno);
+    }
+
+    pthread_mutex_unlock(&s_mtxLogDrain);
+}
+
+void *CBaseLog::LogFlushThread(void *pArg)
+{
+    struct timespec tsDeadline;
+
+    (void)pArg;
+
+    while (s_bLogFlusherStop == false)
+    {
+        // Sleep Until Interval Elapsed or Ring Half Full
+        clock_gettime(CLOCK_REALTIME, &tsDeadline);
+        tsDeadline.tv_nsec += LOG_FLUSH_INTERVAL_MSEC * 1000000L;
+        if (tsDeadline.tv_nsec >= 1000000000L)
+        {
+            tsDeadline.tv_sec += tsDeadline.tv_nsec / 1000000000L;
+            tsDeadline.tv_nsec %= 1000000000L;
+        }
+        sem_timedwait(&s_semLogFlush, &tsDeadline);
+
+        // Batch-Write Pending Records
+        DrainLogRing();
+    }
+
+    return NULL;
+}
+#endif //__ENABLE_ASYNC_LOG_FILE__
+
+void CBaseLog::FlushLog(void)
+{
+#ifdef __ENABLE_ASYNC_LOG_FILE__
+    DrainLogRing();
+#endif //__ENABLE_ASYNC_LOG_FILE__
+}
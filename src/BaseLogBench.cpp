@@ -0,0 +1,132 @@
+/** @file
+
+  Hex. Dump Encoder Benchmark for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	BaseLogBench.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+  Usage:
+	elan_log_bench [report_length] [iterations]
+
+  Compares the former per-byte sprintf(" %02x") + strcat() loop of
+  DebugPrintBuffer() with CBaseLog::EncodeHexString() on the same buffer.
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ErrCode.h"
+#include "BaseLog.h"
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Default: One 65-Byte Input Report, Dumped 100000 Times
+#define BENCH_DEFAULT_REPORT_LEN	65
+#define BENCH_DEFAULT_ITERATIONS	100000
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+static char s_legacy_buf[LOG_BUF_SIZE];
+static char s_table_buf[LOG_BUF_SIZE];
+
+// Keeps the Encoders from Being Optimized Away
+static volatile unsigned int s_sink = 0;
+
+/***************************************************
+ * Functions
+ ***************************************************/
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// DebugPrintBuffer() Encoding before the Table Encoder
+static void encode_legacy(char *p_dest, const unsigned char *p_buf, int len)
+{
+    int index = 0;
+    const unsigned char *p_data = NULL;
+    char buffer[8] = {0};
+
+    memset(p_dest, 0, LOG_BUF_SIZE);
+    for (index = 0, p_data = p_buf; index < len; index++, p_data++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        sprintf(buffer, " %02x", *p_data);
+        strcat(p_dest, buffer);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int err = TP_SUCCESS,
+        report_len = BENCH_DEFAULT_REPORT_LEN,
+        iterations = BENCH_DEFAULT_ITERATIONS,
+        index = 0;
+    unsigned char report[LOG_BUF_SIZE / 3] = {0};
+    unsigned long long start_ns = 0,
+                       legacy_ns = 0,
+                       table_ns = 0;
+
+    if (argc > 1)
+        report_len = atoi(argv[1]);
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+    if ((report_len <= 0) || (report_len > (int)sizeof(report)) || (iterations <= 0))
+    {
+        fprintf(stderr, "Usage: %s [report_length (1~%d)] [iterations]\r\n", argv[0], (int)sizeof(report));
+        err = TP_ERR_INVALID_PARAM;
+        goto EXIT;
+    }
+
+    for (index = 0; index < report_len; index++)
+        report[index] = (unsigned char)(index * 37 + 11);
+
+    // Both Encoders Must Produce the Same Dump
+    encode_legacy(s_legacy_buf, report, report_len);
+    CBaseLog::EncodeHexString(s_table_buf, sizeof(s_table_buf), report, report_len);
+    if (strcmp(s_legacy_buf, s_table_buf) != 0)
+    {
+        fprintf(stderr, "Output mismatch!\r\nlegacy:%s\r\ntable :%s\r\n", s_legacy_buf, s_table_buf);
+        err = TP_ERR_DATA_PATTERN;
+        goto EXIT;
+    }
+
+    start_ns = now_ns();
+    for (index = 0; index < iterations; index++)
+    {
+        encode_legacy(s_legacy_buf, report, report_len);
+        s_sink += (unsigned char)s_legacy_buf[index % (report_len * 3)];
+    }
+    legacy_ns = now_ns() - start_ns;
+
+    start_ns = now_ns();
+    for (index = 0; index < iterations; index++)
+    {
+        CBaseLog::EncodeHexString(s_table_buf, sizeof(s_table_buf), report, report_len);
+        s_sink += (unsigned char)s_table_buf[index % (report_len * 3)];
+    }
+    table_ns = now_ns() - start_ns;
+
+    printf("report_len=%d, iterations=%d\r\n", report_len, iterations);
+    printf("sprintf/strcat : %10.1f ns/dump\r\n", (double)legacy_ns / iterations);
+    printf("table encoder  : %10.1f ns/dump\r\n", (double)table_ns / iterations);
+    printf("speedup        : %10.1fx\r\n", (table_ns > 0) ? (double)legacy_ns / table_ns : 0.0);
+
+EXIT:
+    return (err == TP_SUCCESS) ? 0 : 1;
+}
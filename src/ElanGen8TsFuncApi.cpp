@@ -18,6 +18,10 @@
 #include "ElanGen8TsI2chidUtility.h"
 #include "ElanGen8TsFwFileIoUtility.h"
 #include "ElanGen8TsFuncApi.h"
+#include "ElanTsInfoPageField.h"
+#include "ElanTsTraceEvent.h"
+#include "ElanTsProbe.h"
+#include "ElanTsRunMetrics.h"
 
 /***************************************************
  * Global Variable Declaration
@@ -73,7 +77,7 @@ int gen8_switch_to_boot_code(bool recovery)
         }
 
         // wait 30ms
-        usleep(30*1000);
+        trace_usleep(30*1000);
 
         // Gen8 Write Flash Key
         err = send_gen8_write_flash_key_command();
@@ -101,7 +105,7 @@ int gen8_switch_to_boot_code(bool recovery)
     }
 
     // wait 15ms
-    usleep(15*1000);
+    trace_usleep(15*1000);
 
     // Check Slave Address
     err = check_slave_address();
@@ -147,7 +151,7 @@ int erase_flash_section(unsigned int address, unsigned short page_count)
      *						  404ms		97~132 Pages.
      * Therefore just wait 500ms to be on the safe side.
      */
-    usleep(500 * 1000); // wait 500ms
+    trace_usleep(500 * 1000); // wait 500ms
 
     // Receive Response of Erase Flash Section
     err = receive_erase_flash_section_response();
@@ -309,6 +313,7 @@ int write_ektl_fw_page(unsigned char *p_ektl_fw_page_buf, size_t ektl_fw_page_bu
 {
     int err = TP_SUCCESS,
         frame_index = 0,
+        frame_size = get_page_frame_size(), // Grows with Output Report Length
         frame_count = 0,
         frame_data_len = 0,
         start_index = 0;
@@ -334,16 +339,16 @@ int write_ektl_fw_page(unsigned char *p_ektl_fw_page_buf, size_t ektl_fw_page_bu
     memcpy(temp_ektl_fw_page_buf, p_ektl_fw_page_buf, ektl_fw_page_buf_size);
 
     // Get Frame Count
-    frame_count = (ektl_fw_page_buf_size / ELAN_I2CHID_PAGE_FRAME_SIZE) +
-                  ((ektl_fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE) != 0);
+    frame_count = (ektl_fw_page_buf_size / frame_size) +
+                  ((ektl_fw_page_buf_size % frame_size) != 0);
 
     // Write eKTL FW Page Data with Frames
     for(frame_index = 0; frame_index < frame_count; frame_index++)
     {
-        if((frame_index == (frame_count - 1)) && ((ektl_fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE) > 0)) // The Last Frame
-            frame_data_len = ektl_fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE;
+        if((frame_index == (frame_count - 1)) && ((ektl_fw_page_buf_size % frame_size) > 0)) // The Last Frame
+            frame_data_len = ektl_fw_page_buf_size % frame_size;
         else
-            frame_data_len = ELAN_I2CHID_PAGE_FRAME_SIZE;
+            frame_data_len = frame_size;
 
         // Write Frame Data
         err = write_frame_data(start_index, frame_data_len, &temp_ektl_fw_page_buf[start_index], frame_data_len);
@@ -371,7 +376,7 @@ int write_ektl_fw_page(unsigned char *p_ektl_fw_page_buf, size_t ektl_fw_page_bu
      * With the information from Boot Code Team, it takes 7ms for touch to process after receiving firmware page data.
      * Thus it should work to remain waiting time of 15ms.
      */
-    usleep(15 * 1000); // wait 15ms
+    trace_usleep(15 * 1000); // wait 15ms
 
     // Receive Response of Flash Write
     err = receive_flash_write_response();
@@ -558,7 +563,7 @@ int gen8_read_memory_page(unsigned short mem_page_address, unsigned short mem_pa
     }
 
     // wait 20ms
-    usleep(20*1000);
+    trace_usleep(20*1000);
 
     // Receive Page Data
     page_frame_count = (mem_page_size / ELAN_I2CHID_READ_PAGE_FRAME_SIZE) + \
@@ -576,7 +581,7 @@ int gen8_read_memory_page(unsigned short mem_page_address, unsigned short mem_pa
         data_len = 3 /* 1(Packet Header 0x99) + 1(Packet Index) + 1(Data Length) */ + page_frame_data_len;
 
         // Read $(page_frame_index)-th Bulk Page Data to Buffer
-        err = read_data(data_buf, data_len, ELAN_READ_DATA_TIMEOUT_MSEC);
+        err = read_response(&ELAN_RESPONSE_BULK_ROM_DATA, data_buf, data_len, ELAN_READ_DATA_TIMEOUT_MSEC);
         if(err != TP_SUCCESS) // Error or Timeout
         {
             ERROR_PRINTF("%s: [%d] Fail to Read %d-Byte Data! err=0x%x.\r\n", __func__, page_frame_index, data_len, err);
@@ -629,29 +634,33 @@ int gen8_get_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size
     // Read Information Memory Page
     //
 
-    // Enter Test Mode
-    err = send_enter_test_mode_command();
-    if(err != TP_SUCCESS)
+    // Test Mode Scope (Left on Every Path Out of This Block)
     {
-        ERROR_PRINTF("%s: Fail to Enter Test Mode! err=0x%x.\r\n", __func__, err);
-        goto GEN8_GET_INFO_PAGE_EXIT;
-    }
+        // Enter Test Mode
+        CTestModeScope test_mode;
+        err = test_mode.status();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Enter Test Mode! err=0x%x.\r\n", __func__, err);
+            goto GEN8_GET_INFO_PAGE_EXIT;
+        }
 
-    // Read Information Page
-    gen8_mem_addr_offset = ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR - ELAN_GEN8_INFO_ROM_MEMORY_ADDR;
-    err = gen8_read_memory_page(gen8_mem_addr_offset, ELAN_GEN8_MEMORY_PAGE_SIZE, gen8_info_mem_page_buf, sizeof(gen8_info_mem_page_buf));
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Information Page! err=0x%x.\r\n", __func__, err);
-        goto GEN8_GET_INFO_PAGE_EXIT_1;
-    }
+        // Read Information Page
+        gen8_mem_addr_offset = ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR - ELAN_GEN8_INFO_ROM_MEMORY_ADDR;
+        err = gen8_read_memory_page(gen8_mem_addr_offset, ELAN_GEN8_MEMORY_PAGE_SIZE, gen8_info_mem_page_buf, sizeof(gen8_info_mem_page_buf));
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Get Information Page! err=0x%x.\r\n", __func__, err);
+            goto GEN8_GET_INFO_PAGE_EXIT;
+        }
 
-    // Leave Test Mode
-    err = send_exit_test_mode_command();
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Leave Test Mode! err=0x%x.\r\n", __func__, err);
-        goto GEN8_GET_INFO_PAGE_EXIT;
+        // Leave Test Mode
+        err = test_mode.leave();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Leave Test Mode! err=0x%x.\r\n", __func__, err);
+            goto GEN8_GET_INFO_PAGE_EXIT;
+        }
     }
 
     // Load Information Page Data to Input Buffer
@@ -662,12 +671,6 @@ int gen8_get_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size
 
 GEN8_GET_INFO_PAGE_EXIT:
     return err;
-
-GEN8_GET_INFO_PAGE_EXIT_1:
-    // Leave Test Mode
-    send_exit_test_mode_command();
-
-    return err;
 }
 
 int gen8_get_info_page_with_error_retry(unsigned char *p_info_page_buf, size_t info_page_buf_size, int retry_count)
@@ -712,6 +715,8 @@ int gen8_get_info_page_with_error_retry(unsigned char *p_info_page_buf, size_t i
         }
 
         // With Error => Retry at most 3 times
+        ELAN_PROBE3(retry, __func__, retry_index + 1, err);
+        run_metrics_count_retry();
         DEBUG_PRINTF("%s: [%d/3] Fail to Get Information Page! err=0x%x.\r\n", __func__, retry_index+1, err);
         if(retry_index == 2)
         {
@@ -722,7 +727,10 @@ int gen8_get_info_page_with_error_retry(unsigned char *p_info_page_buf, size_t i
         else // retry_index = 0, 1
         {
             // wait 50ms
-            usleep(50*1000);
+            trace_usleep(50*1000);
+
+            // Resync Test Mode Held by Caller Before Next Attempt
+            CTestModeScope::reenter();
 
             continue;
         }
@@ -736,12 +744,6 @@ GEN8_GET_INFO_PAGE_WITH_ERROR_RETRY_EXIT:
 int gen8_get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_size, struct update_info *p_update_info, size_t update_info_size)
 {
     int err = TP_SUCCESS;
-    unsigned int gen8_update_counter			= 0,
-                 gen8_last_update_time_year		= 0,
-                 gen8_last_update_time_month	= 0,
-                 gen8_last_update_time_day		= 0,
-                 gen8_last_update_time_hour		= 0,
-                 gen8_last_update_time_minute	= 0;
     struct update_info last_update_info;
 
     //
@@ -771,69 +773,20 @@ int gen8_get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_si
     //
 
     // Update Counter
-    err = gen8_get_info_page_value(p_info_page_buf, info_page_buf_size, ELAN_GEN8_UPDATE_COUNTER_ADDR, &gen8_update_counter);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Update Counter (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_UPDATE_COUNTER_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-    if(gen8_update_counter == 0xFFFFFFFF)
-        gen8_update_counter = 0;
-
-
-    // Last Update Time (Year)
-    err = gen8_get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_YEAR_ADDR, &gen8_last_update_time_year);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Year (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_YEAR_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Month)
-    err = gen8_get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_MONTH_ADDR, &gen8_last_update_time_month);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Month (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_MONTH_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Day)
-    err = gen8_get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_DAY_ADDR, &gen8_last_update_time_day);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Hour (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_DAY_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Hour)
-    err = gen8_get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_HOUR_ADDR, &gen8_last_update_time_hour);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Hour (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_HOUR_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Minute)
-    err = gen8_get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_MINUTE_ADDR, &gen8_last_update_time_minute);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Minute (Address: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_MINUTE_ADDR, err);
-        goto GEN8_GET_UPDATE_INFO_EXIT;
-    }
-
-    // Setup Last Update Info. Container
-    last_update_info.update_counter				= gen8_update_counter;
-    last_update_info.last_update_time.Year		= gen8_last_update_time_year;
-    last_update_info.last_update_time.Month		= gen8_last_update_time_month;
-    last_update_info.last_update_time.Day		= gen8_last_update_time_day;
-    last_update_info.last_update_time.Hour		= gen8_last_update_time_hour;
-    last_update_info.last_update_time.Minute	= gen8_last_update_time_minute;
+    last_update_info.update_counter = gen8_update_counter_field::get(p_info_page_buf);
+    if(last_update_info.update_counter == 0xFFFFFFFF)
+        last_update_info.update_counter = 0;
+
+    // Last Update Time
+    last_update_info.last_update_time.Year		= gen8_last_update_year_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Month		= gen8_last_update_month_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Day		= gen8_last_update_day_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Hour		= gen8_last_update_hour_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Minute	= gen8_last_update_minute_field::get(p_info_page_buf);
+    DEBUG_PRINTF("%s: update_counter=%d, last_update_time=%04d/%02d/%02d %02d:%02d.\r\n", __func__, \
+                 last_update_info.update_counter, \
+                 last_update_info.last_update_time.Year, last_update_info.last_update_time.Month, last_update_info.last_update_time.Day, \
+                 last_update_info.last_update_time.Hour, last_update_info.last_update_time.Minute);
 
     // Load Last Update Info. to Input Buffer
     memcpy(p_update_info, &last_update_info, sizeof(last_update_info));
@@ -845,238 +798,6 @@ GEN8_GET_UPDATE_INFO_EXIT:
     return err;
 }
 
-int gen8_set_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int value)
-{
-    int err 				= TP_SUCCESS;
-    unsigned int data_index	= 0; // Memory Address Offset
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_GEN8_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_SET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%08x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_SET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    //
-    // Set Value
-    //
-
-    // Data Index
-    data_index = address - ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR;
-
-    // Load Data Value to Appropriate Address
-    p_info_page_buf[data_index]		= (unsigned char) (value & 0x000000FF);
-    p_info_page_buf[data_index+1]	= (unsigned char)((value & 0x0000FF00) >> 8);
-    p_info_page_buf[data_index+2]	= (unsigned char)((value & 0x00FF0000) >> 16);
-    p_info_page_buf[data_index+3]	= (unsigned char)((value & 0xFF000000) >> 24);
-    DEBUG_PRINTF("%s: address: 0x%08x, value: %d (0x%08x), info_page_buf[0x%08x] = {%02x %02x %02x %02x}.\r\n", \
-                 __func__, address, value, value, data_index, \
-                 p_info_page_buf[data_index],     p_info_page_buf[data_index + 1], \
-                 p_info_page_buf[data_index + 2], p_info_page_buf[data_index + 3]);
-
-    // Success
-    err = TP_SUCCESS;
-
-GEN8_SET_INFO_PAGE_VALUE_EXIT:
-    return err;
-}
-
-int gen8_get_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int *p_value)
-{
-    int err 				= TP_SUCCESS;
-    unsigned int data_index	= 0, // Memory Address Offset
-                 data_value	= 0;
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_GEN8_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%08x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Value Buffer
-    if(p_value == NULL)
-    {
-        ERROR_PRINTF("%s: NULL Value Buffer!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    //
-    // Get Value
-    //
-
-    // Data Index
-    data_index = address - ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR;
-
-    // Data Value
-    data_value = FOUR_BYTE_ARRAY_TO_UINT(&p_info_page_buf[data_index]);
-    DEBUG_PRINTF("%s: MEM[0x%08x] = {0x%x 0x%x 0x%x 0x%x} => 0x%08x (%d).\r\n", \
-                 __func__, address, \
-                 p_info_page_buf[data_index],     p_info_page_buf[data_index + 1], \
-                 p_info_page_buf[data_index + 2], p_info_page_buf[data_index + 3], \
-                 data_value, data_value);
-
-    // Load Data Value to Input Value Buffer
-    *p_value = data_value;
-
-    // Success
-    err = TP_SUCCESS;
-
-GEN8_GET_INFO_PAGE_VALUE_EXIT:
-    return err;
-}
-
-int gen8_set_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int value)
-{
-    int err 						= TP_SUCCESS;
-    unsigned int data_index			= 0, // Memory Address Offset
-                 hex_value_interger	= 0;
-    char hex_value_string[16]		= {0}; // Format: "0xabcdefgh"
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_GEN8_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_SET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%08x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_SET_INFO_PAGE_DATA_EXIT;
-    }
-
-    //
-    // Set Data
-    //
-
-    // Data Index
-    data_index = address - ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR;
-
-    // Data Value
-    sprintf(hex_value_string, "0x%d", value);
-    hex_value_interger = (unsigned int)strtoul(hex_value_string, NULL, 0 /* determined by the format of hex_value_string */);
-
-    // Load Data Value to Appropriate Address
-    p_info_page_buf[data_index]		= (unsigned char) (hex_value_interger & 0x000000FF);
-    p_info_page_buf[data_index+1]	= (unsigned char)((hex_value_interger & 0x0000FF00) >> 8);
-    p_info_page_buf[data_index+2]	= (unsigned char)((hex_value_interger & 0x00FF0000) >> 16);
-    p_info_page_buf[data_index+3]	= (unsigned char)((hex_value_interger & 0xFF000000) >> 24);
-    DEBUG_PRINTF("%s: address: 0x%08x, value: %d (0x%08x), info_page_buf[0x%08x] = {%02x %02x %02x %02x}.\r\n", __func__, \
-                 address, value, value, data_index, \
-                 p_info_page_buf[data_index],     p_info_page_buf[data_index + 1], \
-                 p_info_page_buf[data_index + 2], p_info_page_buf[data_index + 3]);
-
-    // Success
-    err = TP_SUCCESS;
-
-GEN8_SET_INFO_PAGE_DATA_EXIT:
-    return err;
-}
-
-int gen8_get_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned int address, unsigned int *p_value)
-{
-    int err 					= TP_SUCCESS;
-    unsigned int int_value		= 0,
-                 data_index		= 0, // Memory Address Offset
-                 data_value		= 0;
-    char int_value_string[16]	= {0}; // Format: "0xabcdefgh"
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_GEN8_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%08x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Value Buffer
-    if(p_value == NULL)
-    {
-        ERROR_PRINTF("%s: NULL Value Buffer!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    //
-    // Get Data
-    //
-
-    // Data Index
-    data_index = address - ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR;
-
-    // Data Value
-    data_value = FOUR_BYTE_ARRAY_TO_UINT(&p_info_page_buf[data_index]);
-
-    // Hex. to Int.
-    sprintf(int_value_string, "%x", data_value);
-    int_value = (unsigned int)strtoul(int_value_string, NULL, 10);
-    DEBUG_PRINTF("%s: MEM[0x%08x] = {0x%x 0x%x 0x%x 0x%x} => 0x%08x => %d.\r\n", \
-                 __func__, address, \
-                 p_info_page_buf[data_index],     p_info_page_buf[data_index + 1], \
-                 p_info_page_buf[data_index + 2], p_info_page_buf[data_index + 3], \
-                 data_value, int_value);
-
-    // Load Data Value to Input Value Buffer
-    *p_value = int_value;
-
-    // Success
-    err = TP_SUCCESS;
-
-GEN8_GET_INFO_PAGE_DATA_EXIT:
-    return err;
-}
-
 int gen8_update_info_page(struct update_info *p_update_info, size_t update_info_size, unsigned char *p_info_page_buf, size_t info_page_buf_size)
 {
     int err = TP_SUCCESS;
@@ -1104,62 +825,18 @@ int gen8_update_info_page(struct update_info *p_update_info, size_t update_info_
     }
 
     //
-    // Get Update Inforamtion
+    // Set Update Inforamtion
     //
 
     // Update Counter
-    err = gen8_set_info_page_value(p_info_page_buf, info_page_buf_size, ELAN_GEN8_UPDATE_COUNTER_ADDR, p_update_info->update_counter);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Update Counter (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_UPDATE_COUNTER_ADDR, p_update_info->update_counter, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Year)
-    err = gen8_set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_YEAR_ADDR, p_update_info->last_update_time.Year);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Year (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_YEAR_ADDR, p_update_info->last_update_time.Year, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Month)
-    err = gen8_set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_MONTH_ADDR, p_update_info->last_update_time.Month);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Month (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_MONTH_ADDR, p_update_info->last_update_time.Month, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Day)
-    err = gen8_set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_DAY_ADDR, p_update_info->last_update_time.Day);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Day (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_DAY_ADDR, p_update_info->last_update_time.Day, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Hour)
-    err = gen8_set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_HOUR_ADDR, p_update_info->last_update_time.Hour);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Hour (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_HOUR_ADDR, p_update_info->last_update_time.Hour, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Minute)
-    err = gen8_set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_GEN8_LAST_UPDATE_TIME_MINUTE_ADDR, p_update_info->last_update_time.Minute);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Minute (Address: 0x%08x, Value: 0x%08x)! err=0x%x.\r\n", __func__, \
-                     ELAN_GEN8_LAST_UPDATE_TIME_MINUTE_ADDR, p_update_info->last_update_time.Minute, err);
-        goto GEN8_UPDATE_INFO_PAGE_EXIT;
-    }
+    gen8_update_counter_field::set(p_info_page_buf, p_update_info->update_counter);
+
+    // Last Update Time
+    gen8_last_update_year_field::set(p_info_page_buf, p_update_info->last_update_time.Year);
+    gen8_last_update_month_field::set(p_info_page_buf, p_update_info->last_update_time.Month);
+    gen8_last_update_day_field::set(p_info_page_buf, p_update_info->last_update_time.Day);
+    gen8_last_update_hour_field::set(p_info_page_buf, p_update_info->last_update_time.Hour);
+    gen8_last_update_minute_field::set(p_info_page_buf, p_update_info->last_update_time.Minute);
 
     // Success
     err = TP_SUCCESS;
@@ -22,6 +22,8 @@
 #include "ElanGen8TsFuncApi.h"
 #include "ElanGen8TsFwFileIoUtility.h"
 #include "ElanGen8TsFwUpdateFlow.h"
+#include "ElanTsRunMetrics.h"
+#include "ElanTsFwUpdatePipeline.h"
 
 /***************************************************
  * Global Variable Declaration
@@ -46,6 +48,7 @@ int gen8_get_firmware_information(message_mode_t msg_mode)
         err = get_fw_version(&fw_version);
         if(err != TP_SUCCESS)
             goto GEN8_GET_FW_INFO_EXIT;
+        run_metrics_record_fw_version(fw_version);
         printf("%04x", fw_version);
     }
     else // Normal Mode
@@ -62,6 +65,7 @@ int gen8_get_firmware_information(message_mode_t msg_mode)
         err = get_fw_version(&fw_version);
         if(err != TP_SUCCESS)
             goto GEN8_GET_FW_INFO_EXIT;
+        run_metrics_record_fw_version(fw_version);
         printf("Firmware Version: %02x.%02x\r\n", HIGH_BYTE(fw_version), LOW_BYTE(fw_version));
 
         // Test Version
@@ -152,224 +156,90 @@ GEN8_CHECK_REMARK_ID_EXIT:
     return err;
 }
 
-// Firmware Update
-int gen8_update_firmware(char *filename, size_t filename_len, bool recovery, int skip_action_code)
+// Firmware Update Policy (Gen8)
+int gen8_update_policy::validate_firmware(const char *filename)
 {
-    int err = TP_SUCCESS,
-        firmware_size = 0,
-        ektl_fw_page_count = 0,
-        ektl_fw_page_index = 0;
-    unsigned char ektl_fw_info_page_buf[ELAN_EKTL_FW_PAGE_SIZE] = {0},
-                  ektl_fw_page_buf[ELAN_EKTL_FW_PAGE_SIZE] = {0};
-    bool skip_remark_id_check = false,
-         skip_information_update = false;
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    bool bDisableOutputBufferDebug = false;
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
-
-    //
-    // Validate Arguments
-    //
-
-    // Make Sure Filename Valid
-    if(filename == NULL)
-    {
-        ERROR_PRINTF("%s: Null String of Filename!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
-    }
-
-    // Make Sure Filename Length Valid
-    if(filename_len == 0)
-    {
-        ERROR_PRINTF("%s: Filename String Length is Zero!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
-    }
+    // eKTL Format is Validated While Parsing Erase Script
+    return TP_SUCCESS;
+}
 
-    // Make Sure File Exist
-    if(access(filename, F_OK) == -1)
-    {
-        ERROR_PRINTF("%s: File \"%s\" does not exist!\r\n", __func__, filename);
-        err = TP_ERR_FILE_NOT_FOUND;
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
-    }
+int gen8_update_policy::get_and_update_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size)
+{
+    DEBUG_PRINTF("Get & Update eKTL FW Information Page...\r\n");
+    return gen8_get_and_update_info_page(p_info_page_buf, info_page_buf_size);
+}
 
-    printf("--------------------------------\r\n");
-    printf("FW Path: \"%s\".\r\n", filename);
-
-    //
-    // Configure Behavior Settings
-    //
-
-    // Set Global Flag of Skip Action Code
-    if((skip_action_code & ACTION_CODE_REMARK_ID_CHECK) == ACTION_CODE_REMARK_ID_CHECK)
-        skip_remark_id_check = true;
-    if((skip_action_code & ACTION_CODE_INFORMATION_UPDATE) == ACTION_CODE_INFORMATION_UPDATE)
-        skip_information_update = true;
-    DEBUG_PRINTF("skip_remark_id_check: %s, skip_information_update: %s.\r\n", \
-                 (skip_remark_id_check) ? "true" : "false", \
-                 (skip_information_update) ? "true" : "false");
-
-    //
-    // Information Page Update
-    //
-    if((recovery == false) && (skip_information_update == false)) // Normal Mode & Don't Skip Information (Section) Update
-    {
-        // Get & Update Information Page
-        DEBUG_PRINTF("Get & Update eKTL FW Information Page...\r\n");
-        err = gen8_get_and_update_info_page(ektl_fw_info_page_buf, sizeof(ektl_fw_info_page_buf));
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Get & Update eKTL FW Inforamtion Page! err=0x%x.\r\n", __func__, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
-        }
-    }
+int gen8_update_policy::check_remark_id(bool recovery, bool skip_remark_id_check)
+{
+    int err = TP_SUCCESS;
 
-    //
-    // Remark ID Check
-    //
-    if(skip_remark_id_check == false) // Not Skip Remark ID Check
+    // Not Skip Remark ID Check
+    if(skip_remark_id_check == false)
     {
         DEBUG_PRINTF("Check Gen8 Remark ID...\r\n");
 
         err = gen8_check_remark_id(recovery);
         if(err != TP_SUCCESS)
-        {
             ERROR_PRINTF("%s: Gen8 Remark ID Check Failed! err=0x%x.\r\n", __func__, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
-        }
     }
 
-    //
-    // Switch to Boot Code
-    //
-    err = gen8_switch_to_boot_code(recovery);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Switch to Boot Code! err=0x%x.\r\n", __func__, err);
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
-    }
+    return err;
+}
 
-    //
-    // Erase Flash
-    //
+int gen8_update_policy::switch_to_boot_code(bool recovery)
+{
+    return gen8_switch_to_boot_code(recovery);
+}
+
+int gen8_update_policy::erase_flash(bool erase_info_page)
+{
+    int err = TP_SUCCESS;
 
     // Flash Sections from eKTL Header
     DEBUG_PRINTF("Erase Flash...\r\n");
-    err = erase_flash();
+    err = ::erase_flash();
     if(err != TP_SUCCESS)
     {
         ERROR_PRINTF("%s: Fail to Erase Flash! err=0x%x.\r\n", __func__, err);
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
+        goto GEN8_ERASE_FLASH_EXIT;
     }
 
     // Information Page
-    if((recovery == false) && (skip_information_update == false))
+    if(erase_info_page == true)
     {
         DEBUG_PRINTF("Erase Information Flash...\r\n");
         err = erase_info_page_flash();
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("%s: Fail to Erase Information Page Flash! err=0x%x.\r\n", __func__, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
-        }
-    }
-
-    printf("Start Gen8 FW Update Process...\r\n");
-
-    //
-    // Update with eKTL FW Pages
-    //
-
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    if((g_bEnableOutputBufferDebug == true) && (g_debug == false))
-    {
-        // Disable Output Buffer Debug
-        DEBUG_PRINTF("Disable Output Buffer Debug.\r\n");
-        g_bEnableOutputBufferDebug = false;
-        bDisableOutputBufferDebug = true;
-    }
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
-
-    if((recovery == false) && (skip_information_update == false)) // Normal Mode & Don't Skip Information (Section) Update
-    {
-        // Write Information Page
-        DEBUG_PRINTF("Write eKTL FW Information Page...\r\n");
-        err = write_ektl_fw_page(ektl_fw_info_page_buf, sizeof(ektl_fw_info_page_buf));
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Write eKTL FW Information Page! err=0x%x.\r\n", __func__, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
+            goto GEN8_ERASE_FLASH_EXIT;
         }
     }
 
-    // Get FW Size
-    err = get_firmware_size(&firmware_size);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Firmware Size! err=0x%x.\r\n", __func__, err);
-        goto GEN8_UPDATE_FIRMWARE_EXIT;
-    }
-
-    // Get eKTL FW Page Count (NOT including Header Page)
-    ektl_fw_page_count = compute_ektl_fw_page_number(firmware_size);
-
-    // Write $(ektl_fw_page_count) eKTL FW Pages to Touch Flash
-    DEBUG_PRINTF("%s: Update with %d eKTL FW Pages...\r\n", __func__, ektl_fw_page_count);
-    for(ektl_fw_page_index = 0; ektl_fw_page_index < ektl_fw_page_count; ektl_fw_page_index++)
-    {
-        // Print test progress to inform operators
-        printf(".");
-        fflush(stdout);
-
-        // Clear eKTL FW Page Buffer
-        memset(ektl_fw_page_buf, 0, sizeof(ektl_fw_page_buf));
+    // Success
+    err = TP_SUCCESS;
 
-        // Load eKTL FW Page Data to Buffer
-        err = retrieve_data_from_firmware(ektl_fw_page_buf, ELAN_EKTL_FW_PAGE_SIZE);
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Retrieve eKTL FW Page Data from eKTL Firmware! err=0x%x.\r\n", __func__, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
-        }
+GEN8_ERASE_FLASH_EXIT:
+    return err;
+}
 
-        // Write eKTL FW Page Data to Touch
-        err = write_ektl_fw_page(ektl_fw_page_buf, sizeof(ektl_fw_page_buf));
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Write %d-th eKTL FW Page Data! err=0x%x.\r\n", __func__, ektl_fw_page_index, err);
-            goto GEN8_UPDATE_FIRMWARE_EXIT;
-        }
-    }
+int gen8_update_policy::write_pages(unsigned char *p_page_buf, size_t page_buf_size)
+{
+    return write_ektl_fw_page(p_page_buf, page_buf_size);
+}
 
-    //
-    // Self-Reset
-    //
+int gen8_update_policy::compute_page_count(int firmware_size)
+{
+    // eKTL FW Page Count (NOT including Header Page)
+    return compute_ektl_fw_page_number(firmware_size);
+}
 
+// Firmware Update
+int gen8_update_firmware(char *filename, size_t filename_len, bool recovery, int skip_action_code)
+{
     /* [Note] 2022/06/06
      * With the information from Boot Code Team, it takes 520ms for touch to process after all firmware page data received.
-     * Thus it should work to reserve a waiting time of 700ms for safety reasons.
+     * Thus it should work to reserve a waiting time of 700ms (gen8_update_policy::RESET_WAIT_MSEC) for safety reasons.
      */
-    usleep(700 * 1000); // wait 700ms
-
-    printf("\r\n"); //Print CRLF in console
-
-    // Success
-    printf("Gen8 FW Update Finished.\r\n");
-    err = TP_SUCCESS;
-
-GEN8_UPDATE_FIRMWARE_EXIT:
-
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    if(bDisableOutputBufferDebug == true)
-    {
-        // Re-Enable Output Buffer Debug
-        DEBUG_PRINTF("Re-Enable Output Buffer Debug.\r\n");
-        g_bEnableOutputBufferDebug = true;
-    }
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
-
-    return err;
+    return run_update_pipeline<gen8_update_policy>(filename, filename_len, recovery, skip_action_code);
 }
-
@@ -14,6 +14,7 @@
 
 #include "I2CHIDLinuxGet.h"
 #include "ElanGen8TsI2chidUtility.h"
+#include "ElanTsTraceEvent.h"
 
 /***************************************************
  * TP Functions
@@ -26,7 +27,7 @@ int gen8_read_test_version_data(void)
     unsigned short test_version = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_GEN8_RESPONSE_TEST_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to receive Test Version data, err=0x%x.\r\n", err);
@@ -53,7 +54,7 @@ int gen8_get_test_version_data(unsigned short *p_test_version)
     unsigned short test_version = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_GEN8_RESPONSE_TEST_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to receive Test Version data, err=0x%x.\r\n", err);
@@ -82,6 +83,7 @@ GEN8_GET_TEST_VERSION_DATA_EXIT:
 // ROM Data
 int gen8_send_read_rom_data_command(unsigned int addr, unsigned char data_len)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char new_read_rom_data_cmd[10] =  {0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00} /* Read 32-bit RAM/ROM Data Command */;
 
@@ -125,6 +127,7 @@ GEN8_SEND_READ_ROM_DATA_COMMAND_EXIT:
 
 int gen8_receive_rom_data(unsigned int *p_rom_data)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char cmd_data[10] = {0};
     unsigned short rom_data = 0;
@@ -138,7 +141,7 @@ int gen8_receive_rom_data(unsigned int *p_rom_data)
     }
 
     // Read 10-byte Command Data
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_GEN8_RESPONSE_ROM_DATA, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS) // Error or Timeout
     {
         ERROR_PRINTF("Fail to receive ROM data! err=0x%x.\r\n", err);
@@ -174,6 +177,7 @@ GEN8_RECEIVE_ROM_DATA_EXIT:
 // IAP Mode
 int send_gen8_write_flash_key_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char gen8_write_flash_key_cmd[10] = {0x54, 0xc0, 0xcd, 0xab, 0x34, 0x84, 0x01, 0x67, 0x94, 0x81};
 
@@ -194,6 +198,7 @@ int send_gen8_write_flash_key_command(void)
 // Erase Flash Section
 int send_erase_flash_section_command(unsigned int address, unsigned short page_count)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char hid_frame_data[ELAN_I2CHID_OUTPUT_BUFFER_SIZE] = {0};
 
@@ -209,7 +214,7 @@ int send_erase_flash_section_command(unsigned int address, unsigned short page_c
     memset(hid_frame_data, 0, sizeof(hid_frame_data));
 
     // Add header of vendor command to frame data
-    hid_frame_data[0] = ELAN_HID_OUTPUT_REPORT_ID;						// 0x03
+    hid_frame_data[0] = (unsigned char)get_output_report_id();			// 0x03
     hid_frame_data[1] = 0x20;
     hid_frame_data[2] = (unsigned char) (address & 0x000000FF);			// LSB (Byte 0) of Address		//ex:00
     hid_frame_data[3] = (unsigned char)((address & 0x0000FF00) >>  8);	//      Byte 1  of Address		//ex:F8
@@ -235,11 +240,12 @@ SEND_ERASE_FLASH_SECTION_COMMMAND_EXIT:
 
 int receive_erase_flash_section_response(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char erase_flash_section_response_data[2] = {0};
 
     // Read Erase Flash Section Response
-    err = read_data(erase_flash_section_response_data, sizeof(erase_flash_section_response_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_GEN8_RESPONSE_ERASE_FLASH_SECTION, erase_flash_section_response_data, sizeof(erase_flash_section_response_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS) // Error or Timeout
     {
         ERROR_PRINTF("Fail to receive Erase Flash Section Response data! err=0x%x.\r\n", err);
@@ -0,0 +1,528 @@
+/** @file
+
+  Implementation of Reentrant Library API (libelaniap) for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanIap.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "ErrCode.h"
+#include "I2CHIDLinuxGet.h"
+#include "ElanTsDeviceIo.h"
+#include "ElanTsFuncApi.h"
+#include "ElanGen8TsFuncApi.h"
+#include "ElanTsFwFileIoUtility.h"
+#include "ElanTsFwUpdateFlow.h"
+#include "ElanGen8TsFwUpdateFlow.h"
+#include "ElanTsAsyncCalibration.h"
+#include "ElanIap.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+struct elan_iap_device
+{
+    CI2CHIDLinuxGet *p_intf;
+    pthread_mutex_t mutex;	// Serialize Calls on This Device
+    bool gen8_touch;
+    bool recovery;
+    elan_iap_progress_callback p_progress_callback;
+    void *p_progress_user_data;
+    struct elan_iap_calibration *p_calibration;	// Pending Async Calibration, Device Busy Until Freed
+};
+
+struct elan_iap_calibration
+{
+    struct elan_iap_device *p_device;
+    struct async_calibration *p_async;
+    bool dumped;	// Flight Recorder Written for a Failed Result
+};
+
+struct elan_iap_image
+{
+    int fd;
+    char filename[1024];
+    pthread_mutex_t mutex;	// One Update at a Time Reads This File
+};
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+// Keep Last hidraw Traffic of a Failed Flow, Same as the Single-Device CLI Path
+// (Called with Device Locked; Unsupported Commands & Busy Devices Never Touched the Bus)
+static void dump_failed_flow(struct elan_iap_device *p_device, int err)
+{
+    if((err == TP_SUCCESS) || (err == TP_ERR_COMMAND_NOT_SUPPORT) || (err == TP_ERR_DEVICE_BUSY))
+        return;
+
+    p_device->p_intf->DumpFlightRecorder();
+}
+
+// Common Part of Open: Detect Touch State of a Connected Interface
+static int create_device(CI2CHIDLinuxGet *p_intf, struct elan_iap_device **pp_device)
+{
+    int err = TP_SUCCESS;
+    bool gen8_touch = false,
+         recovery = false;
+    struct elan_iap_device *p_device = NULL;
+
+    // Detect Touch State
+    {
+        CDeviceIoBinding binding(p_intf);
+
+        err = detect_touch_state(&gen8_touch, &recovery);
+    }
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to Detect Touch State! err=0x%x.\r\n", __func__, err);
+        goto CREATE_DEVICE_EXIT;
+    }
+
+    p_device = new elan_iap_device;
+    p_device->p_intf = p_intf;
+    pthread_mutex_init(&p_device->mutex, NULL);
+    p_device->gen8_touch = gen8_touch;
+    p_device->recovery = recovery;
+    p_device->p_progress_callback = NULL;
+    p_device->p_progress_user_data = NULL;
+    p_device->p_calibration = NULL;
+    *pp_device = p_device;
+
+    // Success
+    err = TP_SUCCESS;
+
+CREATE_DEVICE_EXIT:
+    return err;
+}
+
+int elan_iap_device_open(int pid, struct elan_iap_device **pp_device)
+{
+    int err = TP_SUCCESS;
+    CI2CHIDLinuxGet *p_intf = NULL;
+
+    // Validate Input
+    if(pp_device == NULL)
+    {
+        ERROR_PRINTF("%s: NULL Pointer!\r\n", __func__);
+        err = TP_ERR_INVALID_PARAM;
+        goto ELAN_IAP_DEVICE_OPEN_EXIT;
+    }
+
+    // Connect to Device
+    p_intf = new CI2CHIDLinuxGet();
+    DEBUG_PRINTF("%s: Get I2C-HID Device Handle (VID=0x%x, PID=0x%x).\r\n", __func__, ELAN_USB_VID, pid);
+    err = p_intf->GetDeviceHandle(ELAN_USB_VID, pid);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Device can't connected! err=0x%x.\r\n", __func__, err);
+        delete p_intf;
+        goto ELAN_IAP_DEVICE_OPEN_EXIT;
+    }
+
+    err = create_device(p_intf, pp_device);
+    if(err != TP_SUCCESS)
+    {
+        p_intf->Close();
+        delete p_intf;
+    }
+
+ELAN_IAP_DEVICE_OPEN_EXIT:
+    return err;
+}
+
+int elan_iap_device_open_path(const char *device_path, struct elan_iap_device **pp_device)
+{
+    int err = TP_SUCCESS;
+    CI2CHIDLinuxGet *p_intf = NULL;
+
+    // Validate Input
+    if((device_path == NULL) || (pp_device == NULL))
+    {
+        ERROR_PRINTF("%s: NULL Pointer!\r\n", __func__);
+        err = TP_ERR_INVALID_PARAM;
+        goto ELAN_IAP_DEVICE_OPEN_PATH_EXIT;
+    }
+
+    // Connect to Device
+    p_intf = new CI2CHIDLinuxGet();
+    err = p_intf->GetDeviceHandleByPath(device_path);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Device \"%s\" can't connected! err=0x%x.\r\n", __func__, device_path, err);
+        delete p_intf;
+        goto ELAN_IAP_DEVICE_OPEN_PATH_EXIT;
+    }
+
+    err = create_device(p_intf, pp_device);
+    if(err != TP_SUCCESS)
+    {
+        p_intf->Close();
+        delete p_intf;
+    }
+
+ELAN_IAP_DEVICE_OPEN_PATH_EXIT:
+    return err;
+}
+
+void elan_iap_device_close(struct elan_iap_device *p_device)
+{
+    if(p_device == NULL)
+        return;
+
+    p_device->p_intf->Close();
+    pthread_mutex_destroy(&p_device->mutex);
+    delete p_device->p_intf;
+    delete p_device;
+}
+
+int elan_iap_device_get_vid_pid(struct elan_iap_device *p_device, unsigned int *p_vid, unsigned int *p_pid)
+{
+    if((p_device == NULL) || (p_vid == NULL) || (p_pid == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    return p_device->p_intf->GetDevVidPid(p_vid, p_pid);
+}
+
+void elan_iap_device_set_progress_callback(struct elan_iap_device *p_device, elan_iap_progress_callback p_callback, void *p_user_data)
+{
+    if(p_device == NULL)
+        return;
+
+    pthread_mutex_lock(&p_device->mutex);
+    p_device->p_progress_callback = p_callback;
+    p_device->p_progress_user_data = p_user_data;
+    pthread_mutex_unlock(&p_device->mutex);
+}
+
+void elan_iap_device_set_reopen_timeout(struct elan_iap_device *p_device, int timeout_ms)
+{
+    if(p_device == NULL)
+        return;
+
+    pthread_mutex_lock(&p_device->mutex);
+    p_device->p_intf->SetHotplugReopenTimeout(timeout_ms);
+    pthread_mutex_unlock(&p_device->mutex);
+}
+
+int elan_iap_device_get_state(struct elan_iap_device *p_device, int *p_gen8, int *p_recovery)
+{
+    if((p_device == NULL) || (p_gen8 == NULL) || (p_recovery == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    *p_gen8 = (p_device->gen8_touch) ? 1 : 0;
+    *p_recovery = (p_device->recovery) ? 1 : 0;
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return TP_SUCCESS;
+}
+
+// Body of elan_iap_get_fw_info(), Called with Device Locked & Bound
+static int read_fw_info(const struct elan_iap_device *p_device, struct elan_iap_fw_info *p_fw_info)
+{
+    int err = TP_SUCCESS;
+
+    err = get_firmware_id(&p_fw_info->fw_id);
+    if(err != TP_SUCCESS)
+        goto READ_FW_INFO_EXIT;
+
+    err = get_fw_version(&p_fw_info->fw_version);
+    if(err != TP_SUCCESS)
+        goto READ_FW_INFO_EXIT;
+
+    if(p_device->gen8_touch) // Gen8 Touch
+        err = gen8_get_test_version(&p_fw_info->test_version);
+    else // Gen5/6/7 Touch
+        err = get_test_version(&p_fw_info->test_version);
+    if(err != TP_SUCCESS)
+        goto READ_FW_INFO_EXIT;
+
+    err = get_boot_code_version(&p_fw_info->bc_version);
+    if(err != TP_SUCCESS)
+        goto READ_FW_INFO_EXIT;
+
+    // Success
+    err = TP_SUCCESS;
+
+READ_FW_INFO_EXIT:
+    return err;
+}
+
+int elan_iap_get_fw_info(struct elan_iap_device *p_device, struct elan_iap_fw_info *p_fw_info)
+{
+    int err = TP_SUCCESS;
+
+    if((p_device == NULL) || (p_fw_info == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    {
+        CDeviceIoBinding binding(p_device->p_intf);
+
+        memset(p_fw_info, 0, sizeof(*p_fw_info));
+        if(p_device->recovery)
+            err = TP_ERR_COMMAND_NOT_SUPPORT;
+        else if(p_device->p_calibration)
+            err = TP_ERR_DEVICE_BUSY;
+        else
+            err = read_fw_info(p_device, p_fw_info);
+    }
+    dump_failed_flow(p_device, err);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return err;
+}
+
+int elan_iap_get_calibration_counter(struct elan_iap_device *p_device, unsigned short *p_calibration_counter)
+{
+    int err = TP_SUCCESS;
+
+    if((p_device == NULL) || (p_calibration_counter == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    {
+        CDeviceIoBinding binding(p_device->p_intf);
+
+        *p_calibration_counter = 0;
+        if(p_device->recovery)
+            err = TP_ERR_COMMAND_NOT_SUPPORT;
+        else if(p_device->p_calibration)
+            err = TP_ERR_DEVICE_BUSY;
+        else if(p_device->gen8_touch) // Gen8 Touch Has No Counter, Same as gen8_get_calibration_counter()
+            err = TP_SUCCESS;
+        else // Gen5/6/7 Touch
+            err = get_rek_counter(p_calibration_counter);
+    }
+    dump_failed_flow(p_device, err);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return err;
+}
+
+int elan_iap_calibrate(struct elan_iap_device *p_device)
+{
+    int err = TP_SUCCESS;
+
+    if(p_device == NULL)
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    {
+        CDeviceIoBinding binding(p_device->p_intf);
+
+        // Gen8 Touch Re-Calibrates Itself on Power-On
+        if(p_device->recovery || p_device->gen8_touch)
+            err = TP_ERR_COMMAND_NOT_SUPPORT;
+        else if(p_device->p_calibration)
+            err = TP_ERR_DEVICE_BUSY;
+        else
+            err = calibrate_touch_with_error_retry(ERROR_RETRY_COUNT);
+    }
+    dump_failed_flow(p_device, err);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return err;
+}
+
+int elan_iap_calibrate_async(struct elan_iap_device *p_device, struct elan_iap_calibration **pp_calibration)
+{
+    int err = TP_SUCCESS;
+    struct async_calibration *p_async = NULL;
+    struct elan_iap_calibration *p_calibration = NULL;
+
+    if((p_device == NULL) || (pp_calibration == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    if(p_device->recovery || p_device->gen8_touch) // Same Rule as elan_iap_calibrate()
+        err = TP_ERR_COMMAND_NOT_SUPPORT;
+    else if(p_device->p_calibration)
+        err = TP_ERR_DEVICE_BUSY;
+    else // One hidraw Node per Device Context
+        err = async_calibration_start(p_device->p_intf, 0, ERROR_RETRY_COUNT, NULL, NULL, &p_async);
+    if(err == TP_SUCCESS)
+    {
+        p_calibration = new elan_iap_calibration;
+        p_calibration->p_device = p_device;
+        p_calibration->p_async = p_async;
+        p_calibration->dumped = false;
+        p_device->p_calibration = p_calibration;
+        *pp_calibration = p_calibration;
+    }
+    dump_failed_flow(p_device, err);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return err;
+}
+
+int elan_iap_calibrate_poll(struct elan_iap_calibration **pp_calibrations, int count, int timeout_ms)
+{
+    int ret = 0,
+        index = 0;
+    struct async_calibration *p_asyncs[ASYNC_CALIBRATION_MAX_HANDLES];
+    struct elan_iap_calibration *p_calibration = NULL;
+
+    if((pp_calibrations == NULL) || (count < 0) || (count > ASYNC_CALIBRATION_MAX_HANDLES))
+        return -TP_ERR_INVALID_PARAM;
+
+    for(index = 0; index < count; index++)
+    {
+        if(pp_calibrations[index] == NULL)
+            return -TP_ERR_INVALID_PARAM;
+        p_asyncs[index] = pp_calibrations[index]->p_async;
+    }
+
+    // Busy Devices are Only Touched Here, No Device Lock Needed
+    ret = async_calibration_poll(p_asyncs, count, timeout_ms);
+
+    // Keep Last hidraw Traffic of Each Newly Failed Calibration
+    for(index = 0; index < count; index++)
+    {
+        p_calibration = pp_calibrations[index];
+        if(p_calibration->dumped || (async_calibration_get_state(p_calibration->p_async) != ASYNC_CALIBRATION_FAILED))
+            continue;
+        p_calibration->dumped = true;
+        p_calibration->p_device->p_intf->DumpFlightRecorder();
+    }
+
+    return ret;
+}
+
+int elan_iap_calibration_get_result(const struct elan_iap_calibration *p_calibration)
+{
+    if(p_calibration == NULL)
+        return TP_ERR_INVALID_PARAM;
+
+    return async_calibration_get_result(p_calibration->p_async);
+}
+
+void elan_iap_calibration_free(struct elan_iap_calibration *p_calibration)
+{
+    if(p_calibration == NULL)
+        return;
+
+    pthread_mutex_lock(&p_calibration->p_device->mutex);
+    p_calibration->p_device->p_calibration = NULL;
+    pthread_mutex_unlock(&p_calibration->p_device->mutex);
+
+    async_calibration_free(p_calibration->p_async);
+    delete p_calibration;
+}
+
+int elan_iap_image_open(const char *filename, struct elan_iap_image **pp_image)
+{
+    int err = TP_SUCCESS,
+        firmware_size = 0;
+    struct elan_iap_image *p_image = NULL;
+    CDeviceIoBinding binding(NULL); // open_firmware_file() Stores the fd of the Calling Thread
+
+    // Validate Input
+    if((filename == NULL) || (pp_image == NULL) || (strlen(filename) >= sizeof(p_image->filename)))
+    {
+        ERROR_PRINTF("%s: Invalid Parameter!\r\n", __func__);
+        err = TP_ERR_INVALID_PARAM;
+        goto ELAN_IAP_IMAGE_OPEN_EXIT;
+    }
+
+    p_image = new elan_iap_image;
+    memset(p_image->filename, 0, sizeof(p_image->filename));
+    strcpy(p_image->filename, filename);
+
+    // Open Firmware File
+    err = open_firmware_file(p_image->filename, strlen(p_image->filename));
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to open firmware file \"%s\"! err=0x%x.\r\n", __func__, filename, err);
+        delete p_image;
+        goto ELAN_IAP_IMAGE_OPEN_EXIT;
+    }
+
+    // Make Sure Firmware File Valid
+    err = get_firmware_size(&firmware_size);
+    if((err != TP_SUCCESS) || (firmware_size <= 0))
+    {
+        ERROR_PRINTF("%s: Invalid Firmware Size: %d! err=0x%x.\r\n", __func__, firmware_size, err);
+        close_firmware_file();
+        delete p_image;
+        err = TP_ERR_FILE_NOT_FOUND;
+        goto ELAN_IAP_IMAGE_OPEN_EXIT;
+    }
+
+    p_image->fd = g_firmware_fd;
+    pthread_mutex_init(&p_image->mutex, NULL);
+    *pp_image = p_image;
+
+    // Success
+    err = TP_SUCCESS;
+
+ELAN_IAP_IMAGE_OPEN_EXIT:
+    return err;
+}
+
+void elan_iap_image_close(struct elan_iap_image *p_image)
+{
+    if(p_image == NULL)
+        return;
+
+    {
+        CDeviceIoBinding binding(NULL, p_image->fd);
+
+        close_firmware_file();
+    }
+    pthread_mutex_destroy(&p_image->mutex);
+    delete p_image;
+}
+
+int elan_iap_update_firmware(struct elan_iap_device *p_device, struct elan_iap_image *p_image, int skip_action_code)
+{
+    int err = TP_SUCCESS;
+
+    if((p_device == NULL) || (p_image == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&p_device->mutex);
+    if(p_device->p_calibration)
+    {
+        pthread_mutex_unlock(&p_device->mutex);
+        return TP_ERR_DEVICE_BUSY;
+    }
+    pthread_mutex_lock(&p_image->mutex);
+    {
+        CDeviceIoBinding binding(p_device->p_intf, p_image->fd);
+
+        set_update_progress_callback(p_device->p_progress_callback, p_device->p_progress_user_data);
+
+        DEBUG_PRINTF("%s: Update Firmware (%s), Gen8 Touch: %s, Recovery: %s, Skip Action Code: 0x%x.\r\n", __func__, \
+                     p_image->filename, \
+                     (p_device->gen8_touch) ? "true" : "false", \
+                     (p_device->recovery) ? "true" : "false", \
+                     skip_action_code);
+        if(p_device->gen8_touch) // Gen8 Touch
+            err = gen8_update_firmware(p_image->filename, strlen(p_image->filename), p_device->recovery, skip_action_code);
+        else // Gen5/6/7 Touch
+            err = update_firmware(p_image->filename, strlen(p_image->filename), p_device->recovery, skip_action_code);
+
+        set_update_progress_callback(NULL, NULL);
+
+        // New Firmware Boots in Normal Mode
+        if(err == TP_SUCCESS)
+            p_device->recovery = false;
+    }
+    pthread_mutex_unlock(&p_image->mutex);
+    dump_failed_flow(p_device, err);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    return err;
+}
@@ -0,0 +1,323 @@
+/** @file
+
+  Implementation of Event-Driven Calibration for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsAsyncCalibration.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>			/* errno */
+#include <poll.h>			/* poll */
+#include "ErrCode.h"
+#include "ElanTsI2chidUtility.h"
+#include "ElanTsAsyncCalibration.h"
+#include "ElanTsPhaseTiming.h"
+#include "ElanTsProbe.h"
+#include "ElanTsRunMetrics.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+struct async_calibration
+{
+    CI2CHIDLinuxGet *p_intf;
+    int dev_idx;
+    enum async_calibration_state state;
+    int result;
+    int attempt;
+    int retry_count;
+    unsigned long long start_ns;
+    unsigned long long deadline_ns;
+    unsigned long long next_progress_ns;
+    async_calibration_callback p_callback;
+    void *p_user_data;
+};
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Same Commands as send_rek_command()
+static const unsigned char s_write_flash_key_cmd[4]	= {0x54, 0xc0, 0xe1, 0x5a};
+static const unsigned char s_rek_cmd[4]				= {0x54, 0x29, 0x00, 0x01};
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static void notify_progress(struct async_calibration *p_calibration, unsigned long long now_ns)
+{
+    p_calibration->next_progress_ns = now_ns + ASYNC_CALIBRATION_PROGRESS_INTERVAL_MSEC * 1000000ULL;
+
+    if(p_calibration->p_callback)
+        p_calibration->p_callback(p_calibration, p_calibration->state, p_calibration->attempt,
+                                  (unsigned int)((now_ns - p_calibration->start_ns) / 1000000ULL), p_calibration->p_user_data);
+}
+
+static void complete_calibration(struct async_calibration *p_calibration, int result, unsigned long long now_ns)
+{
+    p_calibration->result = result;
+    p_calibration->state = (result == TP_SUCCESS) ? ASYNC_CALIBRATION_DONE : ASYNC_CALIBRATION_FAILED;
+    notify_progress(p_calibration, now_ns);
+}
+
+static bool is_pending(const struct async_calibration *p_calibration)
+{
+    return (p_calibration != NULL) &&
+           ((p_calibration->state == ASYNC_CALIBRATION_WAITING) || (p_calibration->state == ASYNC_CALIBRATION_RETRYING));
+}
+
+// Send Write Flash Key & Re-K Command, Then Arm Response Deadline
+static int send_calibration_command(struct async_calibration *p_calibration)
+{
+    int err = TP_SUCCESS;
+    unsigned char cmd[4] = {0};
+
+    memcpy(cmd, s_write_flash_key_cmd, sizeof(cmd));
+    err = p_calibration->p_intf->WriteCommand(cmd, sizeof(cmd), ELAN_WRITE_DATA_TIMEOUT_MSEC, p_calibration->dev_idx);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to send Write Flash Key command! err=0x%x.\r\n", __func__, err);
+        goto SEND_CALIBRATION_COMMAND_EXIT;
+    }
+
+    memcpy(cmd, s_rek_cmd, sizeof(cmd));
+    err = p_calibration->p_intf->WriteCommand(cmd, sizeof(cmd), ELAN_WRITE_DATA_TIMEOUT_MSEC, p_calibration->dev_idx);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to send Re-Calibration command! err=0x%x.\r\n", __func__, err);
+        goto SEND_CALIBRATION_COMMAND_EXIT;
+    }
+
+    p_calibration->attempt++;
+    p_calibration->deadline_ns = phase_timing_now_ns() + ELAN_READ_CALI_RESP_TIMEOUT_MSEC * 1000000ULL;
+
+    // Success
+    err = TP_SUCCESS;
+
+SEND_CALIBRATION_COMMAND_EXIT:
+    return err;
+}
+
+// Read One Report of a Readable Panel
+static void handle_report(struct async_calibration *p_calibration, unsigned long long now_ns)
+{
+    int err = TP_SUCCESS;
+    unsigned char report[2 + 4] = {0};
+
+    err = p_calibration->p_intf->ReadData(report, sizeof(report), 0 /* Already Readable */, p_calibration->dev_idx, false /* Keep Report Header */);
+    if(err == TP_ERR_TIMEOUT)
+        return;
+    if(err == TP_ERR_DATA_PATTERN) // Unknown Report ID => Not Ours
+        return;
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to read calibration response! err=0x%x.\r\n", __func__, err);
+        complete_calibration(p_calibration, err, now_ns);
+        return;
+    }
+
+    // Touch Keeps Reporting Fingers / Pen while Calibrating
+    if((report[0] == ELAN_HID_FINGER_REPORT_ID) || (report[0] == ELAN_HID_PEN_REPORT_ID) || (report[0] == ELAN_HID_PEN_DEBUG_REPORT_ID))
+        return;
+
+    DEBUG_PRINTF("%s: cmd_data: 0x%x, 0x%x, 0x%x, 0x%x.\r\n", __func__, report[2], report[3], report[4], report[5]);
+
+    /* Like receive_rek_response(), Any Response Completes the Calibration */
+    if((report[2] == 0x66) && (report[3] == 0x66) && (report[4] == 0x66) && (report[5] == 0x66)) // Calibrated
+        DEBUG_PRINTF("%s: Re-Calibration success.\r\n", __func__);
+    complete_calibration(p_calibration, TP_SUCCESS, now_ns);
+}
+
+// Response Deadline Passed => Re-Send or Give Up
+static void handle_timeout(struct async_calibration *p_calibration, unsigned long long now_ns)
+{
+    int err = TP_SUCCESS;
+
+    ELAN_PROBE3(retry, __func__, p_calibration->attempt, TP_ERR_TIMEOUT);
+    run_metrics_count_retry();
+    DEBUG_PRINTF("%s: [%d/%d] Calibration response timeout!\r\n", __func__, p_calibration->attempt, p_calibration->retry_count);
+
+    if(p_calibration->attempt >= p_calibration->retry_count)
+    {
+        complete_calibration(p_calibration, TP_ERR_TIMEOUT, now_ns);
+        return;
+    }
+
+    err = send_calibration_command(p_calibration);
+    if(err != TP_SUCCESS)
+    {
+        complete_calibration(p_calibration, err, now_ns);
+        return;
+    }
+
+    p_calibration->state = ASYNC_CALIBRATION_RETRYING;
+    notify_progress(p_calibration, now_ns);
+}
+
+int async_calibration_start(CI2CHIDLinuxGet *p_intf, int dev_idx, int retry_count, async_calibration_callback p_callback, void *p_user_data,
+                            struct async_calibration **pp_calibration)
+{
+    int err = TP_SUCCESS;
+    struct async_calibration *p_calibration = NULL;
+
+    // Validate Input
+    if((p_intf == NULL) || (pp_calibration == NULL) || (p_intf->GetDevFd(dev_idx) < 0))
+    {
+        ERROR_PRINTF("%s: Invalid Parameter! (p_intf=%p, dev_idx=%d, pp_calibration=%p)\r\n", __func__, (void *)p_intf, dev_idx, (void *)pp_calibration);
+        err = TP_ERR_INVALID_PARAM;
+        goto ASYNC_CALIBRATION_START_EXIT;
+    }
+
+    p_calibration = new async_calibration;
+    memset(p_calibration, 0, sizeof(*p_calibration));
+    p_calibration->p_intf = p_intf;
+    p_calibration->dev_idx = dev_idx;
+    p_calibration->state = ASYNC_CALIBRATION_WAITING;
+    p_calibration->result = TP_ERR_IO_PENDING;
+    p_calibration->retry_count = (retry_count > 0) ? retry_count : 1;
+    p_calibration->p_callback = p_callback;
+    p_calibration->p_user_data = p_user_data;
+    p_calibration->start_ns = phase_timing_now_ns();
+
+    err = send_calibration_command(p_calibration);
+    if(err != TP_SUCCESS)
+    {
+        delete p_calibration;
+        goto ASYNC_CALIBRATION_START_EXIT;
+    }
+
+    notify_progress(p_calibration, phase_timing_now_ns());
+    *pp_calibration = p_calibration;
+
+    // Success
+    err = TP_SUCCESS;
+
+ASYNC_CALIBRATION_START_EXIT:
+    return err;
+}
+
+int async_calibration_poll(struct async_calibration **pp_calibrations, int count, int timeout_ms)
+{
+    int index = 0,
+        fd = 0,
+        wait_count = 0,
+        pending = 0,
+        ret = 0;
+    unsigned long long now_ns = 0,
+                       wake_ns = 0,
+                       end_ns = 0;
+    struct async_calibration *p_calibration = NULL;
+    struct pollfd fds[ASYNC_CALIBRATION_MAX_HANDLES];
+
+    if((pp_calibrations == NULL) || (count < 0) || (count > ASYNC_CALIBRATION_MAX_HANDLES))
+        return -TP_ERR_INVALID_PARAM;
+
+    now_ns = phase_timing_now_ns();
+    end_ns = (timeout_ms >= 0) ? now_ns + timeout_ms * 1000000ULL : 0;
+
+    do
+    {
+        // Wait for Any Panel Readable, or the Nearest Deadline / Progress Tick
+        // (One Entry per Handle, Negative fd => Ignored by poll())
+        wait_count = 0;
+        wake_ns = end_ns;
+        for(index = 0; index < count; index++)
+        {
+            p_calibration = pp_calibrations[index];
+            fds[index].fd = -1;
+            fds[index].events = POLLIN;
+            fds[index].revents = 0;
+            if(!is_pending(p_calibration))
+                continue;
+
+            fd = p_calibration->p_intf->GetDevFd(p_calibration->dev_idx);
+            if(fd < 0)
+            {
+                complete_calibration(p_calibration, TP_ERR_NOT_FOUND_DEVICE, now_ns);
+                continue;
+            }
+            fds[index].fd = fd;
+            wait_count++;
+
+            if((wake_ns == 0) || (p_calibration->deadline_ns < wake_ns))
+                wake_ns = p_calibration->deadline_ns;
+            if(p_calibration->next_progress_ns < wake_ns)
+                wake_ns = p_calibration->next_progress_ns;
+        }
+        if(wait_count == 0) // Nothing Pending
+            return 0;
+
+        // Round Up to Whole Milliseconds, so a Deadline Never Wakes Us Early
+        wake_ns = (wake_ns > now_ns) ? wake_ns - now_ns : 0;
+
+        ret = poll(fds, count, (int)((wake_ns + 999999ULL) / 1000000ULL));
+        if((ret < 0) && (errno != EINTR))
+        {
+            ERROR_PRINTF("%s: poll fail! errno=%d.\r\n", __func__, errno);
+            return -TP_ERR_IO_ERROR;
+        }
+
+        // Dispatch Reports, Deadlines & Progress Ticks
+        now_ns = phase_timing_now_ns();
+        pending = 0;
+        for(index = 0; index < count; index++)
+        {
+            p_calibration = pp_calibrations[index];
+            if(!is_pending(p_calibration))
+                continue;
+
+            if((ret > 0) && (fds[index].revents & (POLLIN | POLLERR | POLLHUP)))
+                handle_report(p_calibration, now_ns);
+            if(is_pending(p_calibration) && (now_ns >= p_calibration->deadline_ns))
+                handle_timeout(p_calibration, now_ns);
+            if(is_pending(p_calibration) && (now_ns >= p_calibration->next_progress_ns))
+            {
+                p_calibration->state = ASYNC_CALIBRATION_WAITING;
+                notify_progress(p_calibration, now_ns);
+            }
+
+            if(is_pending(p_calibration))
+                pending++;
+        }
+    }
+    while((pending > 0) && ((end_ns == 0) || (now_ns < end_ns)));
+
+    return pending;
+}
+
+int async_calibration_wait_all(struct async_calibration **pp_calibrations, int count)
+{
+    int ret = async_calibration_poll(pp_calibrations, count, -1);
+
+    return (ret < 0) ? -ret : TP_SUCCESS;
+}
+
+enum async_calibration_state async_calibration_get_state(const struct async_calibration *p_calibration)
+{
+    return (p_calibration) ? p_calibration->state : ASYNC_CALIBRATION_FAILED;
+}
+
+int async_calibration_get_result(const struct async_calibration *p_calibration)
+{
+    return (p_calibration) ? p_calibration->result : TP_ERR_INVALID_PARAM;
+}
+
+CI2CHIDLinuxGet *async_calibration_get_interface(const struct async_calibration *p_calibration)
+{
+    return (p_calibration) ? p_calibration->p_intf : NULL;
+}
+
+void async_calibration_free(struct async_calibration *p_calibration)
+{
+    delete p_calibration;
+}
@@ -0,0 +1,93 @@
+/** @file
+
+  Implementation of Chip Capability Table for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsChipCapability.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <pthread.h>
+#include "ElanTsI2chidHwParameters.h"
+#include "ElanGen8TsI2chidHwParameters.h"
+#include "ElanTsFuncApi.h"
+#include "ElanGen8TsFuncApi.h"
+#include "ElanTsChipCapability.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+/*
+ * Chip Capability Table
+ *
+ * Entry 0 is the default record for every part not listed below.
+ * To support a new part, add one line.
+ *
+ * [Note] 6308 is only identified by BC version in recovery mode;
+ *   its solution ID keeps the 53XX defaults in normal mode.
+ */
+static const struct chip_capability s_chip_capability_table[] =
+{
+    /* name,              solution_id,                  bc_ver_high_byte,                            generation, rom_read_selector,           info_page_address,                 flash_size_kb */
+    { "53XX (default)",   CHIP_KEY_NONE,                CHIP_KEY_NONE,                               CHIP_GEN5,  ELAN_ROM_READ_SELECTOR_53XX, ELAN_INFO_MEMORY_PAGE_1_ADDR,      32  },
+    { "EKTH6315x1",       SOLUTION_ID_EKTH6315x1,       BC_VER_H_BYTE_FOR_EKTA6315_I2CHID,           CHIP_GEN6,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH6315x2",       SOLUTION_ID_EKTH6315x2,       CHIP_KEY_NONE,                               CHIP_GEN6,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH6315to5015M",  SOLUTION_ID_EKTH6315to5015M,  BC_VER_H_BYTE_FOR_EKTH6315_TO_5015M_I2CHID,  CHIP_GEN6,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH6315to3915P",  SOLUTION_ID_EKTH6315to3915P,  BC_VER_H_BYTE_FOR_EKTH6315_TO_3915P_I2CHID,  CHIP_GEN6,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH6308x1",       CHIP_KEY_NONE,                BC_VER_H_BYTE_FOR_EKTA6308_I2CHID,           CHIP_GEN6,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH7315x1",       SOLUTION_ID_EKTH7315x1,       BC_VER_H_BYTE_FOR_EKTA7315_I2CHID,           CHIP_GEN7,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH7315x2",       SOLUTION_ID_EKTH7315x2,       CHIP_KEY_NONE,                               CHIP_GEN7,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EKTH7318x1",       SOLUTION_ID_EKTH7318x1,       CHIP_KEY_NONE,                               CHIP_GEN7,  ELAN_ROM_READ_SELECTOR_63XX, ELAN_INFO_PAGE_WRITE_MEMORY_ADDR,  64  },
+    { "EM32F901",         CHIP_KEY_NONE,                BC_VER_H_BYTE_FOR_EM32F901_I2CHID,           CHIP_GEN8,  0,                           ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR, 256 },
+    { "EM32F902",         CHIP_KEY_NONE,                BC_VER_H_BYTE_FOR_EM32F902_I2CHID,           CHIP_GEN8,  0,                           ELAN_GEN8_INFO_MEMORY_PAGE_3_ADDR, 256 },
+};
+
+#define CHIP_CAPABILITY_TABLE_SIZE	(sizeof(s_chip_capability_table) / sizeof(s_chip_capability_table[0]))
+
+// Table Index Must Fit in One Byte
+typedef char chip_capability_table_size_check[(CHIP_CAPABILITY_TABLE_SIZE <= 256) ? 1 : -1];
+
+// Lookup Index (Key -> Table Entry, 0 = Default)
+static unsigned char s_solution_id_index[256];
+static unsigned char s_bc_ver_high_byte_index[256];
+static pthread_once_t s_chip_capability_index_once = PTHREAD_ONCE_INIT;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static void build_chip_capability_index(void)
+{
+    unsigned int entry = 0;
+    int key = 0;
+
+    // Keep the First Entry for Duplicated Keys
+    for(entry = CHIP_CAPABILITY_TABLE_SIZE - 1; entry > 0; entry--)
+    {
+        key = s_chip_capability_table[entry].solution_id;
+        if((key >= 0) && (key <= 0xFF))
+            s_solution_id_index[key] = (unsigned char)entry;
+
+        key = s_chip_capability_table[entry].bc_ver_high_byte;
+        if((key >= 0) && (key <= 0xFF))
+            s_bc_ver_high_byte_index[key] = (unsigned char)entry;
+    }
+}
+
+const struct chip_capability *get_chip_capability_by_solution_id(unsigned char solution_id)
+{
+    pthread_once(&s_chip_capability_index_once, build_chip_capability_index);
+    return &s_chip_capability_table[s_solution_id_index[solution_id]];
+}
+
+const struct chip_capability *get_chip_capability_by_bc_ver_high_byte(unsigned char bc_ver_high_byte)
+{
+    pthread_once(&s_chip_capability_index_once, build_chip_capability_index);
+    return &s_chip_capability_table[s_bc_ver_high_byte_index[bc_ver_high_byte]];
+}
@@ -0,0 +1,786 @@
+/** @file
+
+  Implementation of Daemon Mode (Unix-Socket RPC) for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsDaemon.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>			/* errno */
+#include <unistd.h>			/* close, unlink, usleep */
+#include <signal.h>			/* sigset_t, pthread_sigmask */
+#include <pthread.h>
+#include <poll.h>			/* poll */
+#include <sys/socket.h>		/* socket, bind, listen, accept */
+#include <sys/stat.h>		/* chmod, lstat */
+#include <sys/un.h>			/* sockaddr_un */
+#include <sys/signalfd.h>	/* signalfd */
+#include "ErrCode.h"
+#include "LogLevel.h"
+#include "I2CHIDLinuxGet.h"			/* ELAN_USB_VID */
+#include "HidrawSysfs.h"
+#include "HidrawHotplug.h"
+#include "ElanTsFwFileIoUtility.h"	/* FILE_NAME_LENGTH_MAX */
+#include "ElanIap.h"
+#include "ElanTsDaemon.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+enum daemon_command
+{
+    DAEMON_CMD_INFO = 0,
+    DAEMON_CMD_COUNTER,
+    DAEMON_CMD_CALIBRATE,
+    DAEMON_CMD_UPDATE,
+    DAEMON_CMD_REFRESH
+};
+
+// One Request, Owned by the Waiting Connection Thread
+struct daemon_job
+{
+    enum daemon_command cmd;
+    char filename[FILE_NAME_LENGTH_MAX];
+    int skip_action_code;
+    int err;
+    bool done;
+    pthread_cond_t cond;
+    struct daemon_job *p_next;
+};
+
+// One Physical Panel, Served by One Worker Thread
+struct daemon_device
+{
+    char phys[HIDRAW_HOTPLUG_PHYS_LEN_MAX];	// Physical Path (Key), "" if Unknown
+    pthread_t worker;
+    pthread_mutex_t mutex;			// Guards Everything Below
+    char device_path[DAEMON_DEVICE_PATH_LEN];	// hidraw Node (Key if No phys), Follows Re-Enumeration
+    pthread_cond_t cond;			// Job Queued or Stop
+    struct daemon_job *p_head;
+    struct daemon_job *p_tail;
+    bool stop;
+
+    // Written by Worker Only
+    struct elan_iap_device *p_iap;	// NULL Until Opened, or after I/O Error
+    unsigned int vid;
+    unsigned int hw_pid;
+    bool gen8;
+    bool recovery;
+
+    // Cache
+    bool fw_info_valid;
+    struct elan_iap_fw_info fw_info;
+    bool counter_valid;
+    unsigned short counter;
+};
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+static struct daemon_device *s_devices[DAEMON_MAX_DEVICES];
+static int s_device_count = 0;
+static bool s_stopping = false;
+static pthread_mutex_t s_devices_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char * const s_command_names[] = { "info", "counter", "calibrate", "update", "refresh" };
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+// Send Whole Reply Line, Ignoring Vanished Clients
+static void send_reply(int client_fd, const char *reply, size_t reply_len)
+{
+    ssize_t sent = 0;
+
+    while(reply_len > 0)
+    {
+        sent = send(client_fd, reply, reply_len, MSG_NOSIGNAL);
+        if(sent < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return;
+        }
+        reply += sent;
+        reply_len -= sent;
+    }
+}
+
+static void send_error(int client_fd, const char *cmd, int err, const char *message)
+{
+    char reply[256] = {0};
+    int len = 0;
+
+    len = snprintf(reply, sizeof(reply), "{\"cmd\":\"%s\",\"err\":%d,\"message\":\"%s\"}\n", cmd, err, message);
+    send_reply(client_fd, reply, len);
+}
+
+/*******************************************
+ *  Worker
+ ******************************************/
+
+// Drop Handle & Cache, Next Job Re-Opens the Device
+static void release_device(struct daemon_device *p_device)
+{
+    struct elan_iap_device *p_iap = NULL;
+
+    pthread_mutex_lock(&p_device->mutex);
+    p_iap = p_device->p_iap;
+    p_device->p_iap = NULL;
+    p_device->fw_info_valid = false;
+    p_device->counter_valid = false;
+    pthread_mutex_unlock(&p_device->mutex);
+
+    elan_iap_device_close(p_iap);
+}
+
+static int ensure_device_open(struct daemon_device *p_device)
+{
+    int err = TP_SUCCESS,
+        gen8 = 0,
+        recovery = 0;
+    unsigned int vid = 0,
+                 hw_pid = 0;
+    char device_path[DAEMON_DEVICE_PATH_LEN] = {0};
+    struct elan_iap_device *p_iap = NULL;
+
+    if(p_device->p_iap != NULL)
+        return TP_SUCCESS;
+
+    pthread_mutex_lock(&p_device->mutex);
+    strcpy(device_path, p_device->device_path);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    err = elan_iap_device_open_path(device_path, &p_iap);
+    if(err != TP_SUCCESS)
+        return err;
+
+    elan_iap_device_get_state(p_iap, &gen8, &recovery);
+    elan_iap_device_get_vid_pid(p_iap, &vid, &hw_pid);
+
+    pthread_mutex_lock(&p_device->mutex);
+    p_device->p_iap = p_iap;
+    p_device->vid = vid;
+    p_device->hw_pid = hw_pid;
+    p_device->gen8 = (gen8 != 0);
+    p_device->recovery = (recovery != 0);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    INFO_PRINTF("%s: Device %04x:%04x opened at \"%s\" (Gen8: %s, Recovery: %s).\r\n", __func__, vid, hw_pid,
+                device_path, (gen8) ? "true" : "false", (recovery) ? "true" : "false");
+    return TP_SUCCESS;
+}
+
+// Same Steps as "-f": Update, then Calibrate (Gen5/6/7) or Let Touch Self-Calibrate (Gen8)
+static int run_update(struct daemon_device *p_device, struct daemon_job *p_job)
+{
+    int err = TP_SUCCESS,
+        gen8 = 0,
+        recovery = 0;
+    struct elan_iap_image *p_image = NULL;
+
+    err = elan_iap_image_open(p_job->filename, &p_image);
+    if(err != TP_SUCCESS)
+        goto RUN_UPDATE_EXIT;
+
+    err = elan_iap_update_firmware(p_device->p_iap, p_image, p_job->skip_action_code);
+    elan_iap_image_close(p_image);
+    if(err != TP_SUCCESS)
+        goto RUN_UPDATE_EXIT;
+
+    elan_iap_device_get_state(p_device->p_iap, &gen8, &recovery);
+    pthread_mutex_lock(&p_device->mutex);
+    p_device->recovery = (recovery != 0);
+    pthread_mutex_unlock(&p_device->mutex);
+
+    if(gen8) // Gen8 Touch
+        usleep(300 * 1000); // wait 300ms
+    else // Gen5/6/7 Touch
+        err = elan_iap_calibrate(p_device->p_iap);
+
+RUN_UPDATE_EXIT:
+    return err;
+}
+
+static int run_job(struct daemon_device *p_device, struct daemon_job *p_job)
+{
+    int err = TP_SUCCESS;
+    struct elan_iap_fw_info fw_info;
+    unsigned short counter = 0;
+
+    if(p_job->cmd == DAEMON_CMD_REFRESH)
+    {
+        release_device(p_device);
+        return TP_SUCCESS;
+    }
+
+    err = ensure_device_open(p_device);
+    if(err != TP_SUCCESS)
+        return err;
+
+    switch(p_job->cmd)
+    {
+        case DAEMON_CMD_INFO:
+            err = elan_iap_get_fw_info(p_device->p_iap, &fw_info);
+            if(err != TP_SUCCESS)
+                break;
+            pthread_mutex_lock(&p_device->mutex);
+            p_device->fw_info = fw_info;
+            p_device->fw_info_valid = true;
+            pthread_mutex_unlock(&p_device->mutex);
+            break;
+
+        case DAEMON_CMD_COUNTER:
+            err = elan_iap_get_calibration_counter(p_device->p_iap, &counter);
+            if(err != TP_SUCCESS)
+                break;
+            pthread_mutex_lock(&p_device->mutex);
+            p_device->counter = counter;
+            p_device->counter_valid = true;
+            pthread_mutex_unlock(&p_device->mutex);
+            break;
+
+        case DAEMON_CMD_CALIBRATE:
+        case DAEMON_CMD_UPDATE:
+            // Invalidate First: a Failed Write may still have Changed the Touch
+            pthread_mutex_lock(&p_device->mutex);
+            p_device->counter_valid = false;
+            if(p_job->cmd == DAEMON_CMD_UPDATE)
+                p_device->fw_info_valid = false;
+            pthread_mutex_unlock(&p_device->mutex);
+
+            if(p_job->cmd == DAEMON_CMD_CALIBRATE)
+                err = elan_iap_calibrate(p_device->p_iap);
+            else
+                err = run_update(p_device, p_job);
+            break;
+
+        default:
+            err = TP_ERR_INVALID_PARAM;
+            break;
+    }
+
+    // Device Gone or Broken => Re-Open on Next Request
+    if((err == TP_ERR_IO_ERROR) || (err == TP_ERR_NOT_FOUND_DEVICE))
+        release_device(p_device);
+
+    return err;
+}
+
+static void *device_worker(void *p_arg)
+{
+    struct daemon_device *p_device = (struct daemon_device *)p_arg;
+    struct daemon_job *p_job = NULL;
+
+    pthread_mutex_lock(&p_device->mutex);
+    while(true)
+    {
+        while((p_device->p_head == NULL) && (p_device->stop == false))
+            pthread_cond_wait(&p_device->cond, &p_device->mutex);
+        if(p_device->p_head == NULL) // Stopped & Drained
+            break;
+
+        p_job = p_device->p_head;
+        p_device->p_head = p_job->p_next;
+        if(p_device->p_head == NULL)
+            p_device->p_tail = NULL;
+        DEBUG_PRINTF("%s: [%s] %s.\r\n", __func__, p_device->device_path, s_command_names[p_job->cmd]);
+        pthread_mutex_unlock(&p_device->mutex);
+
+        p_job->err = run_job(p_device, p_job);
+
+        pthread_mutex_lock(&p_device->mutex);
+        p_job->done = true;
+        pthread_cond_signal(&p_job->cond);
+    }
+    pthread_mutex_unlock(&p_device->mutex);
+
+    release_device(p_device);
+    return NULL;
+}
+
+// Same Panel: Physical Path when Both Known (hidraw Numbers Change on Re-Enumeration), Else hidraw Node
+// (Called with s_devices_mutex Held)
+static bool is_same_device(struct daemon_device *p_device, const char *device_path, const char *phys)
+{
+    bool same = false;
+
+    if((phys[0] != '\0') && (p_device->phys[0] != '\0'))
+        return (strcmp(p_device->phys, phys) == 0);
+
+    pthread_mutex_lock(&p_device->mutex);
+    same = (strcmp(p_device->device_path, device_path) == 0);
+    pthread_mutex_unlock(&p_device->mutex);
+    return same;
+}
+
+// Find Device of Selector, or Start Serving It
+static int get_device(const char *selector, struct daemon_device **pp_device)
+{
+    int err = TP_SUCCESS,
+        index = 0;
+    char device_path[DAEMON_DEVICE_PATH_LEN] = {0},
+         phys[HIDRAW_HOTPLUG_PHYS_LEN_MAX] = {0};
+    struct daemon_device *p_device = NULL;
+
+    // Clients Only Reach hidraw Nodes
+    if((selector[0] == '/') && (strncmp(selector, "/dev/hidraw", 11) != 0))
+        return TP_ERR_INVALID_PARAM;
+
+    // Resolve outside the Table Lock (sysfs Walk, Node Open)
+    err = hidraw_sysfs_resolve_selector(ELAN_USB_VID, selector, device_path, sizeof(device_path));
+    if(err != TP_SUCCESS)
+        return err;
+    err = hidraw_hotplug_get_phys(device_path, phys, sizeof(phys));
+    if(err != TP_SUCCESS)
+        return err;
+
+    pthread_mutex_lock(&s_devices_mutex);
+    if(s_stopping)
+    {
+        err = TP_ERR_NO_INTERFACE_CREATE;
+        goto GET_DEVICE_EXIT;
+    }
+
+    for(index = 0; index < s_device_count; index++)
+    {
+        p_device = s_devices[index];
+        if(is_same_device(p_device, device_path, phys))
+        {
+            // Re-Enumerated under Another Node, Next Open Uses It
+            pthread_mutex_lock(&p_device->mutex);
+            strcpy(p_device->device_path, device_path);
+            pthread_mutex_unlock(&p_device->mutex);
+            *pp_device = p_device;
+            err = TP_SUCCESS;
+            goto GET_DEVICE_EXIT;
+        }
+    }
+
+    if(s_device_count >= DAEMON_MAX_DEVICES)
+    {
+        ERROR_PRINTF("%s: Already serving %d devices!\r\n", __func__, s_device_count);
+        err = TP_ERR_NO_INTERFACE_CREATE;
+        goto GET_DEVICE_EXIT;
+    }
+
+    p_device = new daemon_device;
+    memset(p_device, 0, sizeof(*p_device));
+    strcpy(p_device->phys, phys);
+    strcpy(p_device->device_path, device_path);
+    pthread_mutex_init(&p_device->mutex, NULL);
+    pthread_cond_init(&p_device->cond, NULL);
+    if(pthread_create(&p_device->worker, NULL, device_worker, p_device) != 0)
+    {
+        ERROR_PRINTF("%s: Fail to create worker thread! errno=%d.\r\n", __func__, errno);
+        pthread_cond_destroy(&p_device->cond);
+        pthread_mutex_destroy(&p_device->mutex);
+        delete p_device;
+        err = TP_ERR_NO_INTERFACE_CREATE;
+        goto GET_DEVICE_EXIT;
+    }
+    s_devices[s_device_count++] = p_device;
+    *pp_device = p_device;
+
+    // Success
+    err = TP_SUCCESS;
+
+GET_DEVICE_EXIT:
+    pthread_mutex_unlock(&s_devices_mutex);
+    return err;
+}
+
+// Queue Job & Wait for Worker, Return with Device Mutex Held
+static int submit_job(struct daemon_device *p_device, struct daemon_job *p_job)
+{
+    pthread_cond_init(&p_job->cond, NULL);
+    p_job->done = false;
+    p_job->p_next = NULL;
+
+    pthread_mutex_lock(&p_device->mutex);
+    if(p_device->stop)
+    {
+        pthread_cond_destroy(&p_job->cond);
+        return TP_ERR_NO_INTERFACE_CREATE;
+    }
+
+    if(p_device->p_tail)
+        p_device->p_tail->p_next = p_job;
+    else
+        p_device->p_head = p_job;
+    p_device->p_tail = p_job;
+    pthread_cond_signal(&p_device->cond);
+
+    while(p_job->done == false)
+        pthread_cond_wait(&p_job->cond, &p_device->mutex);
+
+    pthread_cond_destroy(&p_job->cond);
+    return p_job->err;
+}
+
+/*******************************************
+ *  Request
+ ******************************************/
+
+// Format Reply from Device State, Called with Device Mutex Held (Sent after Unlock)
+static int format_device_reply(char *reply, size_t reply_size, struct daemon_device *p_device, enum daemon_command cmd, int err, bool cached)
+{
+    int len = 0;
+
+    len = snprintf(reply, reply_size, "{\"cmd\":\"%s\",\"device\":\"%s\",\"err\":%d", s_command_names[cmd], p_device->device_path, err);
+    if(err == TP_SUCCESS)
+    {
+        if(cmd == DAEMON_CMD_INFO)
+            len += snprintf(reply + len, reply_size - len,
+                            ",\"cached\":%s,\"fw_id\":\"%04x\",\"fw_version\":\"%04x\",\"test_version\":\"%04x\",\"bc_version\":\"%04x\"",
+                            (cached) ? "true" : "false", p_device->fw_info.fw_id, p_device->fw_info.fw_version,
+                            p_device->fw_info.test_version, p_device->fw_info.bc_version);
+        else if(cmd == DAEMON_CMD_COUNTER)
+            len += snprintf(reply + len, reply_size - len, ",\"cached\":%s,\"calibration_counter\":\"%04x\"",
+                            (cached) ? "true" : "false", p_device->counter);
+    }
+    if(p_device->p_iap != NULL)
+        len += snprintf(reply + len, reply_size - len, ",\"gen8\":%s,\"recovery\":%s",
+                        (p_device->gen8) ? "true" : "false", (p_device->recovery) ? "true" : "false");
+    len += snprintf(reply + len, reply_size - len, "}\n");
+
+    return len;
+}
+
+static void send_device_list(int client_fd)
+{
+    char reply[128 + DAEMON_MAX_DEVICES * (160 + HIDRAW_HOTPLUG_PHYS_LEN_MAX)] = {0};
+    int len = 0,
+        index = 0;
+    struct daemon_device *p_device = NULL;
+
+    len = snprintf(reply, sizeof(reply), "{\"cmd\":\"list\",\"err\":0,\"devices\":[");
+    pthread_mutex_lock(&s_devices_mutex);
+    for(index = 0; index < s_device_count; index++)
+    {
+        p_device = s_devices[index];
+        pthread_mutex_lock(&p_device->mutex);
+        len += snprintf(reply + len, sizeof(reply) - len, "%s{\"device\":\"%s\",\"phys\":\"%s\",\"open\":%s", (index > 0) ? "," : "",
+                        p_device->device_path, p_device->phys, (p_device->p_iap != NULL) ? "true" : "false");
+        if(p_device->p_iap != NULL)
+            len += snprintf(reply + len, sizeof(reply) - len, ",\"vid\":\"%04x\",\"hw_pid\":\"%04x\"", p_device->vid, p_device->hw_pid);
+        len += snprintf(reply + len, sizeof(reply) - len, "}");
+        pthread_mutex_unlock(&p_device->mutex);
+    }
+    pthread_mutex_unlock(&s_devices_mutex);
+    len += snprintf(reply + len, sizeof(reply) - len, "]}\n");
+
+    send_reply(client_fd, reply, len);
+}
+
+static void handle_request(int client_fd, char *line)
+{
+    int err = TP_SUCCESS,
+        cmd = 0;
+    char *p_save = NULL,
+         *p_cmd = NULL,
+         *p_selector = NULL,
+         *p_file = NULL,
+         *p_skip = NULL;
+    struct daemon_device *p_device = NULL;
+    struct daemon_job job;
+    char reply[512] = {0};
+    int reply_len = 0;
+
+    p_cmd = strtok_r(line, " \t\r", &p_save);
+    if(p_cmd == NULL) // Empty Line
+        return;
+
+    if(strcmp(p_cmd, "list") == 0)
+    {
+        send_device_list(client_fd);
+        return;
+    }
+
+    for(cmd = DAEMON_CMD_INFO; cmd <= DAEMON_CMD_REFRESH; cmd++)
+        if(strcmp(p_cmd, s_command_names[cmd]) == 0)
+            break;
+    if(cmd > DAEMON_CMD_REFRESH)
+    {
+        send_error(client_fd, "unknown", TP_ERR_COMMAND_NOT_SUPPORT, "Unknown command");
+        return;
+    }
+
+    // Device Selector, Same Forms as a Manifest Entry
+    p_selector = strtok_r(NULL, " \t\r", &p_save);
+    if(p_selector == NULL)
+    {
+        send_error(client_fd, s_command_names[cmd], TP_ERR_INVALID_PARAM, "Missing device selector");
+        return;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.cmd = (enum daemon_command)cmd;
+    if(job.cmd == DAEMON_CMD_UPDATE)
+    {
+        p_file = strtok_r(NULL, " \t\r", &p_save);
+        p_skip = strtok_r(NULL, " \t\r", &p_save);
+        if((p_file == NULL) || (strlen(p_file) >= sizeof(job.filename)))
+        {
+            send_error(client_fd, s_command_names[cmd], TP_ERR_INVALID_PARAM, "Missing or invalid firmware file");
+            return;
+        }
+        strcpy(job.filename, p_file);
+        job.skip_action_code = (p_skip != NULL) ? atoi(p_skip) : 0;
+    }
+
+    err = get_device(p_selector, &p_device);
+    if(err == TP_ERR_NO_INTERFACE_CREATE)
+    {
+        send_error(client_fd, s_command_names[cmd], err, "No free device slot");
+        return;
+    }
+    else if(err == TP_ERR_INVALID_PARAM)
+    {
+        send_error(client_fd, s_command_names[cmd], err, "Invalid device selector");
+        return;
+    }
+    else if(err != TP_SUCCESS)
+    {
+        send_error(client_fd, s_command_names[cmd], err, "No device matches selector");
+        return;
+    }
+
+    // Answer Inventory Queries from Cache
+    // (Reply copied under device mutex, sent after unlock: a slow client must not stall the worker)
+    pthread_mutex_lock(&p_device->mutex);
+    if(((job.cmd == DAEMON_CMD_INFO) && p_device->fw_info_valid) ||
+       ((job.cmd == DAEMON_CMD_COUNTER) && p_device->counter_valid))
+    {
+        reply_len = format_device_reply(reply, sizeof(reply), p_device, job.cmd, TP_SUCCESS, true);
+        pthread_mutex_unlock(&p_device->mutex);
+        send_reply(client_fd, reply, reply_len);
+        return;
+    }
+    pthread_mutex_unlock(&p_device->mutex);
+
+    err = submit_job(p_device, &job);
+    reply_len = format_device_reply(reply, sizeof(reply), p_device, job.cmd, err, false);
+    pthread_mutex_unlock(&p_device->mutex);
+    send_reply(client_fd, reply, reply_len);
+}
+
+static void *connection_thread(void *p_arg)
+{
+    int client_fd = (int)(long)p_arg;
+    char buf[DAEMON_REQUEST_LENGTH_MAX + 1] = {0};
+    char *p_newline = NULL;
+    size_t used = 0,
+           line_len = 0;
+    ssize_t len = 0;
+
+    while(true)
+    {
+        len = recv(client_fd, buf + used, sizeof(buf) - 1 - used, 0);
+        if((len < 0) && (errno == EINTR))
+            continue;
+        if(len <= 0) // Closed by Client
+            break;
+        used += len;
+
+        // Serve Every Complete Line
+        while((p_newline = (char *)memchr(buf, '\n', used)) != NULL)
+        {
+            *p_newline = '\0';
+            line_len = p_newline - buf + 1;
+            handle_request(client_fd, buf);
+            memmove(buf, buf + line_len, used - line_len);
+            used -= line_len;
+        }
+
+        if(used >= sizeof(buf) - 1)
+        {
+            send_error(client_fd, "unknown", TP_ERR_INVALID_PARAM, "Request too long");
+            break;
+        }
+    }
+
+    close(client_fd);
+    return NULL;
+}
+
+/*******************************************
+ *  Socket
+ ******************************************/
+
+static int open_listen_socket(const char *socket_path, int *p_listen_fd)
+{
+    int err = TP_SUCCESS,
+        listen_fd = -1;
+    struct sockaddr_un addr;
+    struct stat file_stat;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        ERROR_PRINTF("%s: Socket path \"%s\" too long!\r\n", __func__, socket_path);
+        err = TP_ERR_INVALID_PARAM;
+        goto OPEN_LISTEN_SOCKET_EXIT;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    // Replace Stale Socket of a Previous Daemon, Never a Regular File
+    if(lstat(socket_path, &file_stat) == 0)
+    {
+        if(!S_ISSOCK(file_stat.st_mode))
+        {
+            ERROR_PRINTF("%s: \"%s\" exists and is not a socket!\r\n", __func__, socket_path);
+            err = TP_ERR_FILE_IO_ERROR;
+            goto OPEN_LISTEN_SOCKET_EXIT;
+        }
+        unlink(socket_path);
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(listen_fd < 0)
+    {
+        ERROR_PRINTF("%s: Fail to create socket! errno=%d.\r\n", __func__, errno);
+        err = TP_ERR_IO_ERROR;
+        goto OPEN_LISTEN_SOCKET_EXIT;
+    }
+
+    if((bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+       (chmod(socket_path, DAEMON_SOCKET_MODE) < 0) ||
+       (listen(listen_fd, SOMAXCONN) < 0))
+    {
+        ERROR_PRINTF("%s: Fail to listen on \"%s\"! errno=%d.\r\n", __func__, socket_path, errno);
+        close(listen_fd);
+        err = TP_ERR_IO_ERROR;
+        goto OPEN_LISTEN_SOCKET_EXIT;
+    }
+
+    *p_listen_fd = listen_fd;
+
+    // Success
+    err = TP_SUCCESS;
+
+OPEN_LISTEN_SOCKET_EXIT:
+    return err;
+}
+
+// Stop Accepting, Let Workers Drain Their Queues, Close Devices
+static void stop_devices(void)
+{
+    int index = 0;
+    struct daemon_device *p_device = NULL;
+
+    pthread_mutex_lock(&s_devices_mutex);
+    s_stopping = true;
+    pthread_mutex_unlock(&s_devices_mutex);
+
+    for(index = 0; index < s_device_count; index++)
+    {
+        p_device = s_devices[index];
+
+        pthread_mutex_lock(&p_device->mutex);
+        p_device->stop = true;
+        pthread_cond_signal(&p_device->cond);
+        pthread_mutex_unlock(&p_device->mutex);
+
+        pthread_join(p_device->worker, NULL);
+    }
+}
+
+int daemon_run(const char *socket_path)
+{
+    int err = TP_SUCCESS,
+        listen_fd = -1,
+        signal_fd = -1,
+        client_fd = -1;
+    sigset_t signals;
+    struct signalfd_siginfo signal_info;
+    struct pollfd fds[2];
+    pthread_t thread;
+    pthread_attr_t attr;
+
+    if((socket_path == NULL) || (socket_path[0] == '\0'))
+        return TP_ERR_INVALID_PARAM;
+
+    /* Block SIGINT / SIGTERM in All Threads (Inherited), Take Them from signalfd.
+     * This also Keeps the Per-Device Flight Recorder Handlers from Firing on Shutdown. */
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    signal_fd = signalfd(-1, &signals, SFD_CLOEXEC);
+    if(signal_fd < 0)
+    {
+        ERROR_PRINTF("%s: Fail to create signalfd! errno=%d.\r\n", __func__, errno);
+        err = TP_ERR_IO_ERROR;
+        goto DAEMON_RUN_EXIT;
+    }
+
+    err = open_listen_socket(socket_path, &listen_fd);
+    if(err != TP_SUCCESS)
+        goto DAEMON_RUN_EXIT;
+    INFO_PRINTF("%s: Listening on \"%s\".\r\n", __func__, socket_path);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    fds[0].fd = listen_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = signal_fd;
+    fds[1].events = POLLIN;
+    while(true)
+    {
+        if(poll(fds, 2, -1) < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            ERROR_PRINTF("%s: poll fail! errno=%d.\r\n", __func__, errno);
+            err = TP_ERR_IO_ERROR;
+            break;
+        }
+
+        if(fds[1].revents & POLLIN) // SIGINT / SIGTERM
+        {
+            // Consume It, or It Fires when Unblocked
+            if(read(signal_fd, &signal_info, sizeof(signal_info)) < 0)
+                DEBUG_PRINTF("%s: Fail to read signalfd! errno=%d.\r\n", __func__, errno);
+            INFO_PRINTF("%s: Shutting down.\r\n", __func__);
+            break;
+        }
+
+        if(fds[0].revents & POLLIN)
+        {
+            client_fd = accept(listen_fd, NULL, NULL);
+            if(client_fd < 0)
+                continue;
+            if(pthread_create(&thread, &attr, connection_thread, (void *)(long)client_fd) != 0)
+            {
+                ERROR_PRINTF("%s: Fail to create connection thread! errno=%d.\r\n", __func__, errno);
+                close(client_fd);
+            }
+        }
+    }
+
+    pthread_attr_destroy(&attr);
+    close(listen_fd);
+    unlink(socket_path);
+    stop_devices();
+
+DAEMON_RUN_EXIT:
+    if(signal_fd >= 0)
+        close(signal_fd);
+    pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
+    return err;
+}
@@ -0,0 +1,175 @@
+/** @file
+
+  Implementation of Device I/O Binding for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsDeviceIo.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <string.h>
+#include "ErrCode.h"
+#include "ElanTsDeviceIo.h"
+#include "ElanTsTraceEvent.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Debug
+bool g_debug = false;
+
+// InterfaceGet Class & Device Index of the Calling Thread
+__thread CI2CHIDLinuxGet *g_pIntfGet = NULL;
+__thread int g_dev_idx = 0;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+// HID Raw I/O Functions
+int __hidraw_write(unsigned char* buf, int len, int timeout_ms)
+{
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_IO);
+    int nRet = TP_SUCCESS;
+
+    if(g_pIntfGet == NULL)
+    {
+        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
+        goto __HIDRAW_WRITE_EXIT;
+    }
+
+    nRet = g_pIntfGet->WriteRawBytes(buf, len, timeout_ms, g_dev_idx);
+    if(nRet == TP_SUCCESS)
+        trace_event_count_bytes(true /* output */, len);
+
+__HIDRAW_WRITE_EXIT:
+    return nRet;
+}
+
+int __hidraw_read(unsigned char* buf, int len, int timeout_ms)
+{
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_IO);
+    int nRet = TP_SUCCESS;
+
+    if(g_pIntfGet == NULL)
+    {
+        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
+        goto __HIDRAW_READ_EXIT;
+    }
+
+    nRet = g_pIntfGet->ReadRawBytes(buf, len, timeout_ms, g_dev_idx);
+    if(nRet == TP_SUCCESS)
+        trace_event_count_bytes(false /* output */, len);
+
+__HIDRAW_READ_EXIT:
+    return nRet;
+}
+
+static int __hidraw_write_command(unsigned char* buf, int len, int timeout_ms)
+{
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_IO);
+    int nRet = TP_SUCCESS;
+
+    if(g_pIntfGet == NULL)
+    {
+        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
+        goto __HIDRAW_WRITE_EXIT;
+    }
+
+    nRet = g_pIntfGet->WriteCommand(buf, len, timeout_ms, g_dev_idx);
+    if(nRet == TP_SUCCESS)
+        trace_event_count_bytes(true /* output */, len);
+
+__HIDRAW_WRITE_EXIT:
+    return nRet;
+}
+
+static int __hidraw_read_data(unsigned char* buf, int len, int timeout_ms)
+{
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_IO);
+    int nRet = TP_SUCCESS;
+
+    if(g_pIntfGet == NULL)
+    {
+        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
+        goto __HIDRAW_READ_EXIT;
+    }
+
+    nRet = g_pIntfGet->ReadData(buf, len, timeout_ms, g_dev_idx);
+    if(nRet == TP_SUCCESS)
+        trace_event_count_bytes(false /* output */, len);
+
+__HIDRAW_READ_EXIT:
+    return nRet;
+}
+
+static int __hidraw_read_response(const struct hidraw_response_pattern *p_pattern, unsigned char* buf, int len, int timeout_ms)
+{
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_IO);
+    int nRet = TP_SUCCESS;
+
+    if(g_pIntfGet == NULL)
+    {
+        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
+        goto __HIDRAW_READ_RESPONSE_EXIT;
+    }
+
+    nRet = g_pIntfGet->ReadResponse(p_pattern, buf, len, timeout_ms, g_dev_idx);
+    if(nRet == TP_SUCCESS)
+        trace_event_count_bytes(false /* output */, len);
+
+__HIDRAW_READ_RESPONSE_EXIT:
+    return nRet;
+}
+
+// Output Report Geometry
+int get_output_report_id(void)
+{
+    return (g_pIntfGet != NULL) ? g_pIntfGet->GetOutReportID(g_dev_idx) : ELAN_HID_OUTPUT_REPORT_ID;
+}
+
+int get_output_report_length(void)
+{
+    return (g_pIntfGet != NULL) ? g_pIntfGet->GetOutReportLength(g_dev_idx) : ELAN_I2CHID_OUTPUT_BUFFER_SIZE;
+}
+
+// Abstract I/O Functions
+int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms)
+{
+    //write_bytes_from_buffer_to_i2c(cmd_buf); //pseudo function
+
+    /*** example *********************/
+    return __hidraw_write_command(cmd_buf, len, timeout_ms);
+    /*********************************/
+}
+
+int read_data(unsigned char *data_buf, int len, int timeout_ms)
+{
+    //read_bytes_from_i2c_to_buffer(data_buf, len, timeout); //pseudo function
+
+    /*** example *********************/
+    return __hidraw_read_data(data_buf, len, timeout_ms);
+    /*********************************/
+}
+
+int read_response(const struct hidraw_response_pattern *p_pattern, unsigned char *data_buf, int len, int timeout_ms)
+{
+    return __hidraw_read_response(p_pattern, data_buf, len, timeout_ms);
+}
+
+int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms)
+{
+    unsigned char vendor_cmd_buf[ELAN_I2CHID_OUTPUT_BUFFER_SIZE] = {0};
+
+    // Add HID Header
+    vendor_cmd_buf[0] = (unsigned char)get_output_report_id();
+    memcpy(&vendor_cmd_buf[1], cmd_buf, len);
+
+    return __hidraw_write(vendor_cmd_buf, sizeof(vendor_cmd_buf), timeout_ms);
+}
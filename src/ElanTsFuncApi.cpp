@@ -17,6 +17,11 @@
 #include "ElanTsI2chidUtility.h"
 #include "ElanTsFwFileIoUtility.h"
 #include "ElanTsFuncApi.h"
+#include "ElanTsChipCapability.h"
+#include "ElanTsInfoPageField.h"
+#include "ElanTsTraceEvent.h"
+#include "ElanTsProbe.h"
+#include "ElanTsRunMetrics.h"
 
 /***************************************************
  * Global Variable Declaration
@@ -180,6 +185,8 @@ int calibrate_touch_with_error_retry(int retry_count)
         }
 
         // With Error => Retry at most 3 times
+        ELAN_PROBE3(retry, __func__, retry_index + 1, err);
+        run_metrics_count_retry();
         DEBUG_PRINTF("%s: [%d/3] Fail to Calibrate Touch! err=0x%x.\r\n", __func__, retry_index+1, err);
         if(retry_index == 2)
         {
@@ -190,7 +197,7 @@ int calibrate_touch_with_error_retry(int retry_count)
         else // retry_index = 0, 1
         {
             // wait 10ms
-            usleep(10*1000);
+            trace_usleep(10*1000);
             continue;
         }
     }
@@ -318,6 +325,8 @@ int get_hello_packet_bc_version_with_error_retry(unsigned char *p_hello_packet,
         }
 
         // With Error => Retry at most 3 times
+        ELAN_PROBE3(retry, __func__, retry_index + 1, err);
+        run_metrics_count_retry();
         DEBUG_PRINTF("%s: [%d/3] Fail to Get Hello Packet (& BC Version)! err=0x%x.\r\n", __func__, retry_index+1, err);
         if(retry_index == 2)
         {
@@ -328,7 +337,7 @@ int get_hello_packet_bc_version_with_error_retry(unsigned char *p_hello_packet,
         else // retry_index = 0, 1
         {
             // wait 50ms
-            usleep(50*1000);
+            trace_usleep(50*1000);
 
             continue;
         }
@@ -366,6 +375,8 @@ int get_hello_packet_with_error_retry(unsigned char *p_hello_packet, int retry_c
         }
 
         // With Error => Retry at most 3 times
+        ELAN_PROBE3(retry, __func__, retry_index + 1, err);
+        run_metrics_count_retry();
         DEBUG_PRINTF("%s: [%d/3] Fail to Get Hello Packet! err=0x%x.\r\n", __func__, retry_index+1, err);
         if(retry_index == 2)
         {
@@ -376,7 +387,7 @@ int get_hello_packet_with_error_retry(unsigned char *p_hello_packet, int retry_c
         else // retry_index = 0, 1
         {
             // wait 50ms
-            usleep(50*1000);
+            trace_usleep(50*1000);
 
             continue;
         }
@@ -422,7 +433,7 @@ int read_memory_page(unsigned short mem_page_address, unsigned short mem_page_si
     }
 
     // wait 20ms
-    usleep(20*1000);
+    trace_usleep(20*1000);
 
     // Receive Page Data
     page_frame_count = (mem_page_size / ELAN_I2CHID_READ_PAGE_FRAME_SIZE) + \
@@ -440,7 +451,7 @@ int read_memory_page(unsigned short mem_page_address, unsigned short mem_page_si
         data_len = 3 /* 1(Packet Header 0x99) + 1(Packet Index) + 1(Data Length) */ + page_frame_data_len;
 
         // Read $(page_frame_index)-th Bulk Page Data to Buffer
-        err = read_data(data_buf, data_len, ELAN_READ_DATA_TIMEOUT_MSEC);
+        err = read_response(&ELAN_RESPONSE_BULK_ROM_DATA, data_buf, data_len, ELAN_READ_DATA_TIMEOUT_MSEC);
         if(err != TP_SUCCESS) // Error or Timeout
         {
             ERROR_PRINTF("%s: [%d] Fail to Read %d-Byte Data! err=0x%x.\r\n", __func__, page_frame_index, data_len, err);
@@ -483,28 +494,32 @@ int get_info_page(unsigned char *info_page_buf, size_t info_page_buf_size)
         goto GET_INFO_PAGE_EXIT;
     }
 
-    // Enter Test Mode
-    err = send_enter_test_mode_command();
-    if(err != TP_SUCCESS)
+    // Test Mode Scope (Left on Every Path Out of This Block)
     {
-        ERROR_PRINTF("%s: Fail to Enter Test Mode! err=0x%x.\r\n", __func__, err);
-        goto GET_INFO_PAGE_EXIT;
-    }
+        // Enter Test Mode
+        CTestModeScope test_mode;
+        err = test_mode.status();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Enter Test Mode! err=0x%x.\r\n", __func__, err);
+            goto GET_INFO_PAGE_EXIT;
+        }
 
-    // Read Information Page
-    err = read_memory_page(ELAN_INFO_MEMORY_PAGE_1_ADDR, ELAN_MEMORY_PAGE_SIZE, info_page_buf, info_page_buf_size);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Information Page! err=0x%x.\r\n", __func__, err);
-        goto GET_INFO_PAGE_EXIT_1;
-    }
+        // Read Information Page
+        err = read_memory_page(ELAN_INFO_MEMORY_PAGE_1_ADDR, ELAN_MEMORY_PAGE_SIZE, info_page_buf, info_page_buf_size);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Get Information Page! err=0x%x.\r\n", __func__, err);
+            goto GET_INFO_PAGE_EXIT;
+        }
 
-    // Leave Test Mode
-    err = send_exit_test_mode_command();
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Leave Test Mode! err=0x%x.\r\n", __func__, err);
-        goto GET_INFO_PAGE_EXIT;
+        // Leave Test Mode
+        err = test_mode.leave();
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Fail to Leave Test Mode! err=0x%x.\r\n", __func__, err);
+            goto GET_INFO_PAGE_EXIT;
+        }
     }
 
     // Success
@@ -512,12 +527,6 @@ int get_info_page(unsigned char *info_page_buf, size_t info_page_buf_size)
 
 GET_INFO_PAGE_EXIT:
     return err;
-
-GET_INFO_PAGE_EXIT_1:
-    // Leave Test Mode
-    send_exit_test_mode_command();
-
-    return err;
 }
 
 int get_info_page_with_error_retry(unsigned char *info_page_buf, size_t info_page_buf_size, int retry_count)
@@ -539,6 +548,8 @@ int get_info_page_with_error_retry(unsigned char *info_page_buf, size_t info_pag
         }
 
         // With Error => Retry at most 3 times
+        ELAN_PROBE3(retry, __func__, retry_index + 1, err);
+        run_metrics_count_retry();
         DEBUG_PRINTF("%s: [%d/3] Fail to Get Information Page! err=0x%x.\r\n", __func__, retry_index+1, err);
         if(retry_index == 2)
         {
@@ -549,7 +560,10 @@ int get_info_page_with_error_retry(unsigned char *info_page_buf, size_t info_pag
         else // retry_index = 0, 1
         {
             // wait 50ms
-            usleep(50*1000);
+            trace_usleep(50*1000);
+
+            // Resync Test Mode Held by Caller Before Next Attempt
+            CTestModeScope::reenter();
 
             continue;
         }
@@ -559,391 +573,9 @@ GET_INFO_PAGE_WITH_ERROR_RETRY_EXIT:
     return err;
 }
 
-int set_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short value)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index = 0; // Memory Address Offset
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with little-endian, in writing.
-    // data[] = {0x34, 0x12}
-    //
-
-    // Load Data Value to Appropriate Address
-    p_info_page_buf[data_index]		= (unsigned char) (value & 0x00FF);
-    p_info_page_buf[data_index+1]	= (unsigned char)((value & 0xFF00) >> 8);
-    DEBUG_PRINTF("%s: address: 0x%04x, value: %d (0x%04x), info_page_buf[%d] = {%02x %02x}.\r\n", \
-                 __func__, address, value, value, data_index, p_info_page_buf[data_index], p_info_page_buf[data_index + 1]);
-
-    // Success
-    err = TP_SUCCESS;
-
-SET_INFO_PAGE_VALUE_EXIT:
-    return err;
-}
-
-int get_info_page_value(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short *p_value)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index	= 0, // Memory Address Offset
-                   data_value	= 0;
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    // Value Buffer
-    if(p_value == NULL)
-    {
-        ERROR_PRINTF("%s: NULL Value Buffer!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_VALUE_EXIT;
-    }
-
-    //
-    // Get Value
-    //
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with big-endian, in reading.
-    // data[] = {0x12, 0x34}
-    // Swap data in reading!
-    //
-
-    // Data Value
-    data_value = REVERSE_TWO_BYTE_ARRAY_TO_WORD(&p_info_page_buf[data_index]);
-    DEBUG_PRINTF("%s: MEM[0x%04x] = {0x%x 0x%x} => 0x%04x (%d).\r\n", __func__, \
-                 address, p_info_page_buf[data_index], p_info_page_buf[data_index + 1], \
-                 data_value, data_value);
-
-    // Load Data Value to Input Value Buffer
-    *p_value = data_value;
-
-    // Success
-    err = TP_SUCCESS;
-
-GET_INFO_PAGE_VALUE_EXIT:
-    return err;
-}
-
-int set_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short value)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index	= 0; // Memory Address Offset
-    unsigned short hex_value	= 0;
-    char hex_value_string[8]	= {0}; // Format: "0xabcd"
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    // Data Value
-    sprintf(hex_value_string, "0x%d", value);
-    hex_value = (unsigned short)strtoul(hex_value_string, NULL, 0 /* determined by the format of hex_value_string */);
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with little-endian, in writing.
-    // data[] = {0x34, 0x12}
-    //
-
-    // Load Data Value to Appropriate Address
-    p_info_page_buf[data_index]		= (unsigned char) (hex_value & 0x00FF);
-    p_info_page_buf[data_index+1]	= (unsigned char)((hex_value & 0xFF00) >> 8);
-    DEBUG_PRINTF("%s: address: 0x%04x, value: %d (0x%04x), info_page_buf[%d] = {%02x %02x}.\r\n", \
-                 __func__, address, value, value, data_index, p_info_page_buf[data_index], p_info_page_buf[data_index + 1]);
-
-    // Success
-    err = TP_SUCCESS;
-
-SET_INFO_PAGE_DATA_EXIT:
-    return err;
-}
-
-int get_info_page_data(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned short *p_value)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index	= 0, // Memory Address Offset
-                   data_value	= 0,
-                   int_value	= 0;
-    char int_value_string[8]	= {0}; // Format: "abcd"
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    // Value Buffer
-    if(p_value == NULL)
-    {
-        ERROR_PRINTF("%s: NULL Value Buffer!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_EXIT;
-    }
-
-    //
-    // Get Data Value
-    //
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with big-endian, in reading.
-    // data[] = {0x12, 0x34}
-    // Swap data in reading!
-    //
-
-    // Data Value
-    //data_value = TWO_BYTE_ARRAY_TO_WORD(&p_info_page_buf[data_index]);
-    data_value = REVERSE_TWO_BYTE_ARRAY_TO_WORD(&p_info_page_buf[data_index]);
-
-    // Hex. to Int.
-    sprintf(int_value_string, "%x", data_value);
-    int_value = (unsigned short)strtoul(int_value_string, NULL, 10);
-    DEBUG_PRINTF("%s: MEM[0x%04x] = {0x%x 0x%x} => 0x%04x => %d.\r\n", __func__, \
-                 address, p_info_page_buf[data_index], p_info_page_buf[data_index + 1], \
-                 data_value, int_value);
-
-    // Load Integer Value to Input Value Buffer
-    *p_value = int_value;
-
-    // Success
-    err = TP_SUCCESS;
-
-GET_INFO_PAGE_DATA_EXIT:
-    return err;
-}
-
-int set_info_page_data_bytes(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned char high_byte, unsigned char low_byte)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index			= 0; // Memory Address Offset
-    unsigned short high_byte_hex_value	= 0,
-                   low_byte_hex_value	= 0;
-    char hex_value_string[8]			= {0}; // Format: "0xab"
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_DATA_BYTES_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto SET_INFO_PAGE_DATA_BYTES_EXIT;
-    }
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    // Data Value (High Byte)
-    sprintf(hex_value_string, "0x%d", high_byte);
-    high_byte_hex_value = (unsigned short)strtoul(hex_value_string, NULL, 0 /* determined by the format of hex_value_string */);
-
-    // Data Value (Low Byte)
-    sprintf(hex_value_string, "0x%d", low_byte);
-    low_byte_hex_value = (unsigned short)strtoul(hex_value_string, NULL, 0 /* determined by the format of hex_value_string */);
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with little-endian, in writing.
-    // data[] = {0x34, 0x12}
-    //
-
-    // Load Data Value to Appropriate Address
-    p_info_page_buf[data_index]		= low_byte_hex_value;
-    p_info_page_buf[data_index+1]	= high_byte_hex_value;
-    DEBUG_PRINTF("%s: address: 0x%04x, high_byte: %d (0x%02x), low_byte: %d (0x%02x), info_page_buf[%d] = 0x%02x, info_page_buf[%d] = 0x%02x.\r\n", \
-                 __func__, address, high_byte, high_byte, low_byte, low_byte, data_index, p_info_page_buf[data_index], \
-                 (data_index + 1), p_info_page_buf[data_index + 1]);
-
-    // Success
-    err = TP_SUCCESS;
-
-SET_INFO_PAGE_DATA_BYTES_EXIT:
-    return err;
-}
-
-int get_info_page_data_bytes(unsigned char *p_info_page_buf, size_t info_page_buf_size, unsigned short address, unsigned char *p_high_byte, unsigned char *p_low_byte)
-{
-    int err = TP_SUCCESS;
-    unsigned short data_index			= 0; // Memory Address Offset
-    char int_value_string[4]			= {0}; // Format: "ab"
-    unsigned char low_byte_value		= 0,
-                  high_byte_value		= 0,
-                  low_byte_int_value	= 0,
-                  high_byte_int_value	= 0; // Range: 0 ~ 59
-
-    //
-    // Validate Arguments
-    //
-
-    // Info. Page Buffer & Buffer Size
-    if((p_info_page_buf == NULL) || (info_page_buf_size < ELAN_MEMORY_PAGE_SIZE))
-    {
-        ERROR_PRINTF("%s: Invalid Info. Page Buffer! (p_info_page_buf=0x%p, info_page_buf_size=%ld)\r\n", \
-                     __func__, p_info_page_buf, info_page_buf_size);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_BYTES_EXIT;
-    }
-
-    // Address
-    if(address < ELAN_INFO_MEMORY_PAGE_1_ADDR)
-    {
-        ERROR_PRINTF("%s: Invalid Address of Information Data! (address=0x%04x.)\r\n", __func__, address);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_BYTES_EXIT;
-    }
-
-    // Value Buffers
-    if((p_high_byte == NULL) || (p_low_byte == NULL))
-    {
-        ERROR_PRINTF("%s: Invalid Value Buffers! (p_high_byte=0x%p, p_low_byte=0x%p)\r\n", __func__, p_high_byte, p_low_byte);
-        err = TP_ERR_INVALID_PARAM;
-        goto GET_INFO_PAGE_DATA_BYTES_EXIT;
-    }
-
-    //
-    // Get Data Bytes
-    //
-
-    // Data Index
-    data_index = (address - ELAN_INFO_MEMORY_PAGE_1_ADDR) * 2 /* unit: byte */;
-
-    //
-    // [Note] 2022/08/03
-    // Ordering with big-endian, in reading.
-    // data[] = {0x12, 0x34}
-    // Swap data in reading!
-    //
-
-    // High Byte Value
-    high_byte_value	= p_info_page_buf[data_index];
-    sprintf(int_value_string, "%x", high_byte_value);
-    high_byte_int_value = (unsigned char)strtoul(int_value_string, NULL, 10);
-
-    // Low Byte Value
-    low_byte_value	= p_info_page_buf[data_index + 1];
-    sprintf(int_value_string, "%x", low_byte_value);
-    low_byte_int_value = (unsigned char)strtoul(int_value_string, NULL, 10);
-
-    DEBUG_PRINTF("%s: MEM[0x%04x] = {0x%02x 0x%02x} => {%d %d}.\r\n", __func__, \
-                 address, high_byte_value, low_byte_value, high_byte_int_value, low_byte_int_value);
-
-    // Load Integer Values to Input Value Buffers
-    *p_high_byte	= high_byte_int_value;
-    *p_low_byte		= low_byte_int_value;
-
-    // Success
-    err = TP_SUCCESS;
-
-GET_INFO_PAGE_DATA_BYTES_EXIT:
-    return err;
-}
-
 int get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_size, struct update_info *p_update_info, size_t update_info_size)
 {
     int err = TP_SUCCESS;
-    unsigned short update_counter				= 0,
-                   last_update_time_year		= 0;
-    unsigned char  last_update_time_month		= 0,
-                   last_update_time_day			= 0,
-                   last_update_time_hour		= 0,
-                   last_update_time_minute		= 0;
     struct update_info last_update_info;
 
     //
@@ -972,54 +604,28 @@ int get_update_info(unsigned char *p_info_page_buf, size_t info_page_buf_size, s
     // Get Update Inforamtion
     //
 
-    // [Note] 2019/04/12
-    // Ordering with Little-Endian in Reading
+    //
+    // [Note] 2022/08/03
+    // Ordering with big-endian, in reading.
+    // data[] = {0x12, 0x34}
+    // Swap data in reading! (Handled by gen5_info_page_layout)
+    //
 
     // Update Counter
-    err = get_info_page_value(p_info_page_buf, info_page_buf_size, ELAN_UPDATE_COUNTER_ADDR, &update_counter);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Update Counter (Address: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_UPDATE_COUNTER_ADDR, err);
-        goto GET_UPDATE_INFO_EXIT;
-    }
-    if(update_counter == 0xFFFF)
-        update_counter = 0;
-
-    // Last Update Time (Year)
-    err = get_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_YEAR_ADDR, &last_update_time_year);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Year (Address: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_YEAR_ADDR, err);
-        goto GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Month & Day)
-    err = get_info_page_data_bytes(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR, &last_update_time_month, &last_update_time_day);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Month & Day (Address: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR, err);
-        goto GET_UPDATE_INFO_EXIT;
-    }
-
-    // Last Update Time (Hour & Minute)
-    err = get_info_page_data_bytes(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, &last_update_time_hour, &last_update_time_minute);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Last Update Time - Hour & Minute (Address: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, err);
-        goto GET_UPDATE_INFO_EXIT;
-    }
-
-    // Setup Last Update Info. Container
-    last_update_info.update_counter				= update_counter;
-    last_update_info.last_update_time.Year		= last_update_time_year;
-    last_update_info.last_update_time.Month		= last_update_time_month;
-    last_update_info.last_update_time.Day		= last_update_time_day;
-    last_update_info.last_update_time.Hour		= last_update_time_hour;
-    last_update_info.last_update_time.Minute	= last_update_time_minute;
+    last_update_info.update_counter = gen5_update_counter_field::get(p_info_page_buf);
+    if(last_update_info.update_counter == 0xFFFF)
+        last_update_info.update_counter = 0;
+
+    // Last Update Time
+    last_update_info.last_update_time.Year		= gen5_last_update_year_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Month		= gen5_last_update_month_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Day		= gen5_last_update_day_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Hour		= gen5_last_update_hour_field::get(p_info_page_buf);
+    last_update_info.last_update_time.Minute	= gen5_last_update_minute_field::get(p_info_page_buf);
+    DEBUG_PRINTF("%s: update_counter=%d, last_update_time=%04d/%02d/%02d %02d:%02d.\r\n", __func__, \
+                 last_update_info.update_counter, \
+                 last_update_info.last_update_time.Year, last_update_info.last_update_time.Month, last_update_info.last_update_time.Day, \
+                 last_update_info.last_update_time.Hour, last_update_info.last_update_time.Minute);
 
     // Load Last Update Info. to Input Buffer
     memcpy(p_update_info, &last_update_info, sizeof(last_update_info));
@@ -1058,46 +664,24 @@ int update_info_page(struct update_info *p_update_info, size_t update_info_size,
     }
 
     //
-    // Get Update Inforamtion
+    // Set Update Inforamtion
     //
 
-    // Update Counter
-    err = set_info_page_value(p_info_page_buf, info_page_buf_size, ELAN_UPDATE_COUNTER_ADDR, p_update_info->update_counter);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Update Counter (Address: 0x%04x, Value: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_UPDATE_COUNTER_ADDR, p_update_info->update_counter, err);
-        goto UPDATE_INFO_PAGE_EXIT;
-    }
-
-    // Last Update Time (Year)
-    err = set_info_page_data(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_YEAR_ADDR, p_update_info->last_update_time.Year);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Year (Address: 0x%04x, Value: 0x%04x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_YEAR_ADDR, p_update_info->last_update_time.Year, err);
-        goto UPDATE_INFO_PAGE_EXIT;
-    }
+    //
+    // [Note] 2022/08/03
+    // Ordering with little-endian, in writing.
+    // data[] = {0x34, 0x12}
+    //
 
-    // Last Update Time (Month & Day)
-    err = set_info_page_data_bytes(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR, \
-                                   p_update_info->last_update_time.Month, p_update_info->last_update_time.Day);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Month & Day (Address: 0x%04x, high_byte: 0x%02x, low_byte: 0x%02x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_MONTH_DAY_ADDR, p_update_info->last_update_time.Month, p_update_info->last_update_time.Day, err);
-        goto UPDATE_INFO_PAGE_EXIT;
-    }
+    // Update Counter
+    gen5_update_counter_field::set(p_info_page_buf, p_update_info->update_counter);
 
-    // Last Update Time (Hour & Minute)
-    err = set_info_page_data_bytes(p_info_page_buf, info_page_buf_size, ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, \
-                                   p_update_info->last_update_time.Hour, p_update_info->last_update_time.Minute);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Set Last Update Time - Hour & Minute (Address: 0x%04x, high_byte: 0x%02x, low_byte: 0x%02x)! err=0x%x.\r\n", __func__, \
-                     ELAN_LAST_UPDATE_TIME_HOUR_MINUTE_ADDR, p_update_info->last_update_time.Hour, p_update_info->last_update_time.Minute, err);
-        goto UPDATE_INFO_PAGE_EXIT;
-    }
+    // Last Update Time
+    gen5_last_update_year_field::set(p_info_page_buf, p_update_info->last_update_time.Year);
+    gen5_last_update_month_field::set(p_info_page_buf, p_update_info->last_update_time.Month);
+    gen5_last_update_day_field::set(p_info_page_buf, p_update_info->last_update_time.Day);
+    gen5_last_update_hour_field::set(p_info_page_buf, p_update_info->last_update_time.Hour);
+    gen5_last_update_minute_field::set(p_info_page_buf, p_update_info->last_update_time.Minute);
 
     // Success
     err = TP_SUCCESS;
@@ -1206,18 +790,8 @@ int get_and_update_info_page(unsigned char solution_id, unsigned char *p_info_pa
 
     // Configure Memory Page Address
     DEBUG_PRINTF("%s: solution_id=0x%02x.\r\n", __func__, solution_id);
-    if (/* 63XX Solution */
-        (solution_id == SOLUTION_ID_EKTH6315x1) || \
-        (solution_id == SOLUTION_ID_EKTH6315x2) || \
-        (solution_id == SOLUTION_ID_EKTH6315to5015M) || \
-        (solution_id == SOLUTION_ID_EKTH6315to3915P) || \
-        /* 73XX Solution */
-        (solution_id == SOLUTION_ID_EKTH7315x1) || \
-        (solution_id == SOLUTION_ID_EKTH7315x2) || \
-        (solution_id == SOLUTION_ID_EKTH7318x1))
-        memory_page_address = ELAN_INFO_PAGE_WRITE_MEMORY_ADDR;	// 63XX or 73XX: memory_page_addr=0x0040
-    else // 53XX Solution
-        memory_page_address = ELAN_INFO_MEMORY_PAGE_1_ADDR;		// 53XX: memory_page_addr=0x8040
+    // 63XX or 73XX: memory_page_addr=0x0040, 53XX: memory_page_addr=0x8040
+    memory_page_address = get_chip_capability_by_solution_id(solution_id)->info_page_address;
 
     // Setup Information Page
     err = create_firmware_page(memory_page_address, \
@@ -1316,7 +890,7 @@ int switch_to_boot_code(bool recovery)
     }
 
     // wait 15ms
-    usleep(15*1000);
+    trace_usleep(15*1000);
 
     // Check Slave Address
     err = check_slave_address();
@@ -1406,6 +980,7 @@ int write_firmware_page(unsigned char *p_fw_page_buf, int fw_page_buf_size)
 {
     int err = TP_SUCCESS,
         frame_index = 0,
+        frame_size = get_page_frame_size(), // Grows with Output Report Length
         frame_count = 0,
         frame_data_len = 0,
         start_index = 0;
@@ -1431,16 +1006,16 @@ int write_firmware_page(unsigned char *p_fw_page_buf, int fw_page_buf_size)
     memcpy(fw_page_block_buf, p_fw_page_buf, fw_page_buf_size);
 
     // Get Frame Count
-    frame_count = (fw_page_buf_size / ELAN_I2CHID_PAGE_FRAME_SIZE) +
-                  ((fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE) != 0);
+    frame_count = (fw_page_buf_size / frame_size) +
+                  ((fw_page_buf_size % frame_size) != 0);
 
     // Write Page Data with Frames
     for(frame_index = 0; frame_index < frame_count; frame_index++)
     {
-        if((frame_index == (frame_count - 1)) && ((fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE) > 0)) // The Last Frame
-            frame_data_len = fw_page_buf_size % ELAN_I2CHID_PAGE_FRAME_SIZE;
+        if((frame_index == (frame_count - 1)) && ((fw_page_buf_size % frame_size) > 0)) // The Last Frame
+            frame_data_len = fw_page_buf_size % frame_size;
         else
-            frame_data_len = ELAN_I2CHID_PAGE_FRAME_SIZE;
+            frame_data_len = frame_size;
 
         // Write Frame Data
         err = write_frame_data(start_index, frame_data_len, &fw_page_block_buf[start_index], frame_data_len);
@@ -1464,9 +1039,9 @@ int write_firmware_page(unsigned char *p_fw_page_buf, int fw_page_buf_size)
 
     // Wait for FW Writing Flash
     if(fw_page_buf_size == (ELAN_FIRMWARE_PAGE_SIZE * 30)) // 30 Page Block
-        usleep(360 * 1000); // wait 12ms * 30
+        trace_usleep(360 * 1000); // wait 12ms * 30
     else
-        usleep(15 * 1000); // wait 15ms
+        trace_usleep(15 * 1000); // wait 15ms
 
     // Receive Response of Flash Write
     err = receive_flash_write_response();
@@ -1522,6 +1097,9 @@ int get_rom_data(unsigned short addr, bool recovery, unsigned short *p_data)
             goto GET_ROM_DATA_EXIT;
         }
         DEBUG_PRINTF("%s: [Recovery Mode] BC Version: 0x%04x.\r\n", __func__, bc_bc_version);
+
+        // High Byte of BC Version Identifies IC Solution in Recovery Mode
+        bc_version_high_byte = HIGH_BYTE(bc_bc_version);
     }
 
     /* Read Data from ROM */
@@ -25,8 +25,8 @@
  * Global Variable Declaration
  ***************************************************/
 
-// Firmware File Information
-int  g_firmware_fd = -1;
+// Firmware File Information (of the Calling Thread)
+__thread int g_firmware_fd = -1;
 
 /***************************************************
  * Function Implements
@@ -19,12 +19,21 @@
 #include "ElanTsFuncApi.h"
 #include "ElanTsFwFileIoUtility.h"
 #include "ElanTsFwUpdateFlow.h"
+#include "ElanTsFwUpdatePipeline.h"
 #include "ElanGen8TsFwFileIoUtility.h"
+#include "ElanTsI2chidHwParameters.h"
+#include "ElanGen8TsI2chidHwParameters.h"
+#include "ElanTsChipCapability.h"
+#include "ElanTsRunMetrics.h"
 
 /***************************************************
  * Global Variable Declaration
  ***************************************************/
 
+// Update Progress Callback (of the Calling Thread)
+static __thread update_progress_callback s_update_progress_callback = NULL;
+static __thread void *s_update_progress_user_data = NULL;
+
 /***************************************************
  * Function Implements
  ***************************************************/
@@ -44,6 +53,7 @@ int get_firmware_information(message_mode_t msg_mode)
         err = get_fw_version(&fw_version);
         if(err != TP_SUCCESS)
             goto GET_FW_INFO_EXIT;
+        run_metrics_record_fw_version(fw_version);
         printf("%04x", fw_version);
     }
     else // Normal Mode
@@ -60,6 +70,7 @@ int get_firmware_information(message_mode_t msg_mode)
         err = get_fw_version(&fw_version);
         if(err != TP_SUCCESS)
             goto GET_FW_INFO_EXIT;
+        run_metrics_record_fw_version(fw_version);
         printf("Firmware Version: %02x.%02x\r\n", HIGH_BYTE(fw_version), LOW_BYTE(fw_version));
 
         // Test Version
@@ -96,7 +107,7 @@ int get_calibration_counter(message_mode_t msg_mode)
         ERROR_PRINTF("%s: Fail to Get Calibration Counter! err=0x%x.\r\n", __func__, err);
         goto GET_CALIBRATION_COUNTER_EXIT;
     }
-
+    run_metrics_record_calibration_counter(calibration_counter);
 
     switch (msg_mode)
     {
@@ -170,122 +181,164 @@ CHECK_REMARK_ID_EXIT:
     return err;
 }
 
-// Firmware Update
-int update_firmware(char *filename, size_t filename_len, bool recovery, int skip_action_code)
+// Touch State (HW Series & Normal / Recovery Mode) from Hello Packet
+int detect_touch_state(bool *p_gen8_touch, bool *p_recovery)
 {
-    int err = TP_SUCCESS,
-        firmware_size = 0,
-        page_count = 0,
-        block_count = 0,
-        block_index = 0,
-        block_page_num = 0;
-    unsigned short fw_version = 0,
-                   fw_bc_version = 0,
-                   bc_bc_version = 0;
-    unsigned char hello_packet = 0,
-                  info_page_buf[ELAN_FIRMWARE_PAGE_SIZE] = {0},
-                  page_block_buf[ELAN_FIRMWARE_PAGE_SIZE * 30] = {0},
-                  bc_ver_high_byte = 0,
-                  bc_ver_low_byte = 0,
-                  iap_version = 0,
-                  solution_id = 0;
-    bool remark_id_check = false,
-         skip_remark_id_check = false,
-         skip_information_update = false,
-         is_ektl_fw = false;
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    bool bDisableOutputBufferDebug = false;
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
-
-    //
-    // Validate Arguments
-    //
-
-    // Make Sure Filename Valid
-    if(filename == NULL)
+    int err = TP_SUCCESS;
+    unsigned char hello_packet = 0;
+    unsigned short bc_bc_version = 0,
+                   fw_bc_version = 0;
+
+    // Validate Input
+    if((p_gen8_touch == NULL) || (p_recovery == NULL))
     {
-        ERROR_PRINTF("%s: Null String of Filename!\r\n", __func__);
+        ERROR_PRINTF("%s: NULL Pointer!\r\n", __func__);
         err = TP_ERR_INVALID_PARAM;
-        goto UPDATE_FIRMWARE_EXIT;
+        goto DETECT_TOUCH_STATE_EXIT;
     }
 
-    // Make Sure Filename Length Valid
-    if(filename_len == 0)
+    // Get Hello Packet
+    err = get_hello_packet_bc_version_with_error_retry(&hello_packet, &bc_bc_version, ERROR_RETRY_COUNT);
+    if(err != TP_SUCCESS)
     {
-        ERROR_PRINTF("%s: Filename String Length is Zero!\r\n", __func__);
-        err = TP_ERR_INVALID_PARAM;
-        goto UPDATE_FIRMWARE_EXIT;
+        ERROR_PRINTF("Fail to Get Hello Packet (& BC Version)! err=0x%x.\r\n", err);
+        goto DETECT_TOUCH_STATE_EXIT;
     }
+    DEBUG_PRINTF("Hello Packet: 0x%02x, Recovery Mode BC Version: 0x%04x.\r\n", hello_packet, bc_bc_version);
 
-    // Make Sure File Exist
-    if(access(filename, F_OK) == -1)
+    // Identify HW Series & Touch State
+    switch (hello_packet)
     {
-        ERROR_PRINTF("%s: File \"%s\" does not exist!\r\n", __func__, filename);
-        err = TP_ERR_FILE_NOT_FOUND;
-        goto UPDATE_FIRMWARE_EXIT;
+        case ELAN_I2CHID_NORMAL_MODE_HELLO_PACKET:
+            // BC Version (Normal Mode)
+            err = get_boot_code_version(&fw_bc_version);
+            if(err != TP_SUCCESS)
+            {
+                ERROR_PRINTF("%s: Fail to Get BC Version (Normal Mode)! err=0x%x.\r\n", __func__, err);
+                goto DETECT_TOUCH_STATE_EXIT;
+            }
+            DEBUG_PRINTF("Normal Mode BC Version: 0x%04x.\r\n", fw_bc_version);
+
+            // Special Case: First BC of EM32F901 / EM32F902
+            if(get_chip_capability_by_bc_ver_high_byte(HIGH_BYTE(fw_bc_version))->generation == CHIP_GEN8)
+                *p_gen8_touch = true;	// Gen8 Touch
+            else
+                *p_gen8_touch = false;	// Gen5/6/7 Touch
+            *p_recovery = false;		// Normal Mode
+            break;
+
+        case ELAN_GEN8_I2CHID_NORMAL_MODE_HELLO_PACKET:
+            *p_gen8_touch = true;		// Gen8 Touch
+            *p_recovery = false;		// Normal Mode
+            break;
+
+        case ELAN_I2CHID_RECOVERY_MODE_HELLO_PACKET:
+            // Special Case: First BC of EM32F901 / EM32F902
+            if(get_chip_capability_by_bc_ver_high_byte(HIGH_BYTE(bc_bc_version))->generation == CHIP_GEN8)
+                *p_gen8_touch = true;	// Gen8 Touch
+            else
+                *p_gen8_touch = false;	// Gen5/6/7 Touch
+            *p_recovery = true;			// Recovery Mode
+            break;
+
+        case ELAN_GEN8_I2CHID_RECOVERY_MODE_HELLO_PACKET:
+            *p_gen8_touch = true;		// Gen8 Touch
+            *p_recovery = true;			// Recovery Mode
+            break;
+
+        default:
+            ERROR_PRINTF("%s: Unknown Hello Packet! (0x%02x) \r\n", __func__, hello_packet);
+            err = TP_UNKNOWN_DEVICE_TYPE;
+            goto DETECT_TOUCH_STATE_EXIT;
     }
 
+    // Success
+    err = TP_SUCCESS;
+
+DETECT_TOUCH_STATE_EXIT:
+    return err;
+}
+
+// Update Progress
+void set_update_progress_callback(update_progress_callback p_callback, void *p_user_data)
+{
+    s_update_progress_callback = p_callback;
+    s_update_progress_user_data = p_user_data;
+}
+
+bool notify_update_progress(int block_done, int block_count)
+{
+    if(s_update_progress_callback == NULL)
+        return false;
+
+    s_update_progress_callback(block_done, block_count, s_update_progress_user_data);
+    return true;
+}
+
+// Firmware Update Policy (Gen5 / Gen6 / Gen7)
+int gen5_update_policy::validate_firmware(const char *filename)
+{
+    int err = TP_SUCCESS;
+    bool is_ektl_fw = false;
+
     // Check if eKTL FW
     err = validate_ektl_fw(&is_ektl_fw);
     if(err != TP_SUCCESS)
     {
         ERROR_PRINTF("%s: Fail to Check if eKTL FW! err=0x%x.\r\n", __func__, err);
-        goto UPDATE_FIRMWARE_EXIT;
+        goto GEN5_VALIDATE_FIRMWARE_EXIT;
     }
     if(is_ektl_fw == true)
     {
         err = TP_ERR_DATA_PATTERN;
         ERROR_PRINTF("%s: File \"%s\" is eKTL FW! err=0x%x.\r\n", __func__, filename, err);
-        goto UPDATE_FIRMWARE_EXIT;
+        goto GEN5_VALIDATE_FIRMWARE_EXIT;
     }
 
-    printf("--------------------------------\r\n");
-    printf("FW Path: \"%s\".\r\n", filename);
-
-    //
-    // Configure Behavior Settings
-    //
-
-    // Set Global Flag of Skip Action Code
-    if((skip_action_code & ACTION_CODE_REMARK_ID_CHECK) == ACTION_CODE_REMARK_ID_CHECK)
-        skip_remark_id_check = true;
-    if((skip_action_code & ACTION_CODE_INFORMATION_UPDATE) == ACTION_CODE_INFORMATION_UPDATE)
-        skip_information_update = true;
-    DEBUG_PRINTF("skip_remark_id_check: %s, skip_information_update: %s.\r\n", \
-                 (skip_remark_id_check) ? "true" : "false", \
-                 (skip_information_update) ? "true" : "false");
-    //
-    // Information Page Update
-    //
-    if((recovery == false) && (skip_information_update == false)) // Normal Mode & Don't Skip Information (Section) Update
-    {
-        // FW Version
-        err = get_fw_version(&fw_version);
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Get FW Version! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
-        }
-        DEBUG_PRINTF("FW Version: 0x%04x.\r\n", fw_version);
+    // Success
+    err = TP_SUCCESS;
 
-        // Solution ID
-        solution_id = HIGH_BYTE(fw_version); 	// Only Needed in Normal Mode
-        DEBUG_PRINTF("Solution ID: 0x%02x.\r\n", solution_id);
+GEN5_VALIDATE_FIRMWARE_EXIT:
+    return err;
+}
 
-        //
-        // Get & Update Information Page
-        //
-        err = get_and_update_info_page(solution_id, info_page_buf, sizeof(info_page_buf));
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to get/update Inforamtion Page! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
-        }
+int gen5_update_policy::get_and_update_info_page(unsigned char *p_info_page_buf, size_t info_page_buf_size)
+{
+    int err = TP_SUCCESS;
+    unsigned short fw_version = 0;
+    unsigned char solution_id = 0;
+
+    // FW Version
+    err = get_fw_version(&fw_version);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to Get FW Version! err=0x%x.\r\n", __func__, err);
+        goto GEN5_GET_AND_UPDATE_INFO_PAGE_EXIT;
     }
+    DEBUG_PRINTF("FW Version: 0x%04x.\r\n", fw_version);
+
+    // Solution ID
+    solution_id = HIGH_BYTE(fw_version); 	// Only Needed in Normal Mode
+    DEBUG_PRINTF("Solution ID: 0x%02x.\r\n", solution_id);
+
+    // Get & Update Information Page
+    err = ::get_and_update_info_page(solution_id, p_info_page_buf, info_page_buf_size);
+
+GEN5_GET_AND_UPDATE_INFO_PAGE_EXIT:
+    return err;
+}
+
+int gen5_update_policy::check_remark_id(bool recovery, bool skip_remark_id_check)
+{
+    int err = TP_SUCCESS;
+    unsigned short fw_bc_version = 0,
+                   bc_bc_version = 0;
+    unsigned char hello_packet = 0,
+                  bc_ver_high_byte = 0,
+                  bc_ver_low_byte = 0,
+                  iap_version = 0;
+    bool remark_id_check = false;
 
-    //
-    // Remark ID Check
-    //
     if(recovery == false) // Normal Mode
     {
         // BC Version (Normal Mode)
@@ -293,7 +346,7 @@ int update_firmware(char *filename, size_t filename_len, bool recovery, int skip
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("%s: Fail to Get BC Version (Normal Mode)! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
+            goto GEN5_CHECK_REMARK_ID_EXIT;
         }
         DEBUG_PRINTF("[Normal Mode] BC Version: 0x%04x.\r\n", fw_bc_version);
 
@@ -313,7 +366,7 @@ int update_firmware(char *filename, size_t filename_len, bool recovery, int skip
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("%s: Fail to Get BC Version (Recovery Mode)! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
+            goto GEN5_CHECK_REMARK_ID_EXIT;
         }
         DEBUG_PRINTF("[Recovery Mode] BC Version: 0x%04x.\r\n", bc_bc_version);
 
@@ -324,17 +377,18 @@ int update_firmware(char *filename, size_t filename_len, bool recovery, int skip
             remark_id_check = true;
         DEBUG_PRINTF("Remark ID Check: %s.\r\n", (remark_id_check) ? "true" : "false");
     }
+
     if(remark_id_check == true)
     {
         if(skip_remark_id_check == false) // Check Remark ID
         {
             DEBUG_PRINTF("[%s Mode] Check Remark ID...\r\n", (recovery) ? "Recovery" : "Normal");
 
-            err = check_remark_id(recovery);
+            err = ::check_remark_id(recovery);
             if(err != TP_SUCCESS)
             {
                 ERROR_PRINTF("%s: Remark ID Check Failed! err=0x%x.\r\n", __func__, err);
-                goto UPDATE_FIRMWARE_EXIT;
+                goto GEN5_CHECK_REMARK_ID_EXIT;
             }
         }
         else // Skip Reamrk ID Check, but read Remark ID
@@ -345,123 +399,41 @@ int update_firmware(char *filename, size_t filename_len, bool recovery, int skip
             if(err != TP_SUCCESS)
             {
                 ERROR_PRINTF("%s: Read Remark ID Failed! err=0x%x.\r\n", __func__, err);
-                goto UPDATE_FIRMWARE_EXIT;
+                goto GEN5_CHECK_REMARK_ID_EXIT;
             }
         }
     }
 
-    //
-    // Switch to Boot Code
-    //
-    err = switch_to_boot_code(recovery);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to switch to Boot Code! err=0x%x.\r\n", __func__, err);
-        goto UPDATE_FIRMWARE_EXIT;
-    }
-
-    printf("Start FW Update Process...\r\n");
-
-    //
-    // Update with FW Pages
-    //
-
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    if((g_bEnableOutputBufferDebug == true) && (g_debug == false))
-    {
-        // Disable Output Buffer Debug
-        DEBUG_PRINTF("Disable Output Buffer Debug.\r\n");
-        g_bEnableOutputBufferDebug = false;
-        bDisableOutputBufferDebug = true;
-    }
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
-
-    if((recovery == false) && (skip_information_update == false)) // Normal Mode & Don't Skip Information (Section) Update
-    {
-        // Write Information Page
-        DEBUG_PRINTF("Update Information Page...\r\n");
-        err = write_firmware_page(info_page_buf, sizeof(info_page_buf));
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Write Infomation Page! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
-        }
-    }
-
-    // Get FW Size, FW Page Count, and FW Page Block Count
-    err = get_firmware_size(&firmware_size);
-    if(err != TP_SUCCESS)
-    {
-        ERROR_PRINTF("%s: Fail to Get Firmware Size! err=0x%x.\r\n", __func__, err);
-        goto UPDATE_FIRMWARE_EXIT;
-    }
-    page_count = compute_firmware_page_number(firmware_size);
-    block_count = (page_count / 30) + ((page_count % 30) != 0);
-
-    /* [Note] 2022/06/09
-     * Reset R/W position of file handler is needed.
-     * Since reading remark ID from eKT FW file makes R/W position jump to the last 4-th byte from the end of file.
-     * Thus it's need to reset the R/W position to the beginning of the file to read the first page.
-     */
-
-    // Reset Read/Write Position of File Handler
-    lseek(g_firmware_fd, 0, SEEK_SET);
-
-    // Write Main Pages
-    DEBUG_PRINTF("Update %d Main Pages with %d Page Blocks...\r\n", page_count, block_count);
-    for(block_index = 0; block_index < block_count; block_index++)
-    {
-        // Print test progress to inform operators
-        printf(".");
-        fflush(stdout);
-
-        // Clear Page Block Buffer
-        memset(page_block_buf, 0, sizeof(page_block_buf));
-
-        // Get Bulk FW Page Data
-        if((block_index == (block_count - 1)) && ((page_count % 30) != 0)) // Last Block
-            block_page_num = page_count % 30; // Last Block Page Number
-        else
-            block_page_num = 30; // 30 Page
-
-        // Load Page Data into Buffer
-        err = retrieve_data_from_firmware(page_block_buf, ELAN_FIRMWARE_PAGE_SIZE * block_page_num);
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Retrieve Page Block Data from Firmware! err=0x%x.\r\n", __func__, err);
-            goto UPDATE_FIRMWARE_EXIT;
-        }
-
-        // Write Bulk FW Page Data
-        err = write_firmware_page(page_block_buf, ELAN_FIRMWARE_PAGE_SIZE * block_page_num);
-        if(err != TP_SUCCESS)
-        {
-            ERROR_PRINTF("%s: Fail to Write FW Page Block %d (%d-Page)! err=0x%x.\r\n", __func__, block_index, block_page_num, err);
-            goto UPDATE_FIRMWARE_EXIT;
-        }
-    }
-
-    //
-    // Self-Reset
-    //
-    sleep(1); // wait for 1s
-    printf("\r\n"); //Print CRLF in console
-
     // Success
-    printf("FW Update Finished.\r\n");
     err = TP_SUCCESS;
 
-UPDATE_FIRMWARE_EXIT:
+GEN5_CHECK_REMARK_ID_EXIT:
+    return err;
+}
 
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_SYSLOG_DEBUG__)
-    if(bDisableOutputBufferDebug == true)
-    {
-        // Re-Enable Output Buffer Debug
-        DEBUG_PRINTF("Re-Enable Output Buffer Debug.\r\n");
-        g_bEnableOutputBufferDebug = true;
-    }
-#endif //__ENABLE_SYSLOG_DEBUG__ && __ENABLE_SYSLOG_DEBUG__
+int gen5_update_policy::switch_to_boot_code(bool recovery)
+{
+    return ::switch_to_boot_code(recovery);
+}
 
-    return err;
+int gen5_update_policy::erase_flash(bool erase_info_page)
+{
+    // Gen5 Boot Code Erases Each Page on Write
+    return TP_SUCCESS;
+}
+
+int gen5_update_policy::write_pages(unsigned char *p_page_buf, size_t page_buf_size)
+{
+    return write_firmware_page(p_page_buf, (int)page_buf_size);
 }
 
+int gen5_update_policy::compute_page_count(int firmware_size)
+{
+    return compute_firmware_page_number(firmware_size);
+}
+
+// Firmware Update
+int update_firmware(char *filename, size_t filename_len, bool recovery, int skip_action_code)
+{
+    return run_update_pipeline<gen5_update_policy>(filename, filename_len, recovery, skip_action_code);
+}
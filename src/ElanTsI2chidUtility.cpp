@@ -14,6 +14,9 @@
 
 #include "I2CHIDLinuxGet.h"
 #include "ElanTsI2chidUtility.h"
+#include "ElanTsChipCapability.h"
+#include "ElanTsTraceEvent.h"
+#include "ElanTsProbe.h"
 
 /***************************************************
  * TP Functions
@@ -22,6 +25,7 @@
 // Power Status
 int send_set_power_status_command(int mode)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char set_pwr_status_cmd[4] = {0x54, 0x50, 0x00, 0x01};
 
@@ -40,6 +44,7 @@ int send_set_power_status_command(int mode)
 // FW ID
 int send_fw_id_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char fw_id_cmd[4] = {0x53, 0xf0, 0x00, 0x01};
 
@@ -55,12 +60,13 @@ int send_fw_id_command(void)
 
 int read_fw_id_data(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS,
         major_fw_id = 0,
         minor_fw_id = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_FW_ID, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read FW ID data, err=0x%x.\n", err);
@@ -90,7 +96,7 @@ int get_fw_id_data(unsigned short *p_fw_id)
     unsigned short fw_id = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_FW_ID, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read FW ID data, err=0x%x.\n", err);
@@ -121,6 +127,7 @@ GET_FW_ID_DATA_EXIT:
 // FW Version
 int send_fw_version_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char fw_ver_cmd[4] = {0x53, 0x00, 0x00, 0x01};
 
@@ -135,13 +142,14 @@ int send_fw_version_command(void)
 
 int read_fw_version_data(bool quiet /* Silent Mode */)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int fw_ver = 0,
         major_fw_ver = 0,
         minor_fw_ver = 0,
         err = TP_SUCCESS;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_FW_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read FW Version data, err=0x%x.\r\n", err);
@@ -183,7 +191,7 @@ int get_fw_version_data(unsigned short *p_fw_version)
         goto GET_FW_VERSION_DATA_EXIT;
     }
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_FW_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read FW Version data, err=0x%x.\r\n", err);
@@ -213,6 +221,7 @@ GET_FW_VERSION_DATA_EXIT:
 
 int send_test_version_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char test_ver_cmd[4] = {0x53, 0xe0, 0x00, 0x01};
 
@@ -228,12 +237,13 @@ int send_test_version_command(void)
 // Test Version
 int read_test_version_data(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS,
         test_ver = 0,
         solution_ver = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_TEST_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to receive Test Version data, err=0x%x.\r\n", err);
@@ -263,7 +273,7 @@ int get_test_version_data(unsigned short *p_test_version)
     unsigned short test_solution_ver = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_TEST_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to receive Test Version data, err=0x%x.\r\n", err);
@@ -294,6 +304,7 @@ GET_TEST_VERSION_DATA_EXIT:
 // Boot Code Version
 int send_boot_code_version_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char bc_ver_cmd[4] = {0x53, 0x10, 0x00, 0x01};
 
@@ -308,12 +319,13 @@ int send_boot_code_version_command(void)
 
 int read_boot_code_version_data(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS,
         major_bc_ver = 0,
         minor_bc_ver = 0;
     unsigned char cmd_data[4] = {0};
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_BC_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read Boot Code Version data, err=0x%x.\r\n", err);
@@ -351,7 +363,7 @@ int get_boot_code_version_data(unsigned short *p_bc_version)
         goto GET_BOOT_CODE_VERSION_DATA_EXIT;
     }
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_BC_VERSION, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read Boot Code Version data, err=0x%x.\r\n", err);
@@ -382,6 +394,7 @@ GET_BOOT_CODE_VERSION_DATA_EXIT:
 // Calibration
 int send_rek_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char write_flash_key_cmd[4]	= {0x54, 0xc0, 0xe1, 0x5a},
             rek_cmd[4]				= {0x54, 0x29, 0x00, 0x01};
@@ -412,6 +425,7 @@ SEND_REK_COMMAND_EXIT:
 
 int receive_rek_response(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char cmd_data[4] = {0};
 
@@ -438,6 +452,7 @@ RECEIVE_REK_RESPONSE_EXIT:
 // Calibration Counter
 int send_rek_counter_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char rek_counter_cmd[4] = {0x53, 0xd0, 0x00, 0x01};
 
@@ -452,6 +467,7 @@ int send_rek_counter_command(void)
 
 int receive_rek_counter_data(unsigned short *p_rek_counter)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned short rek_counter = 0;
     unsigned char cmd_data[4] = {0},
@@ -466,7 +482,7 @@ int receive_rek_counter_data(unsigned short *p_rek_counter)
         goto RECV_REK_COUNTER_DATA_EXIT;
     }
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_REK_COUNTER, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to read ReK Counter data, err=0x%x.\r\n", err);
@@ -499,6 +515,7 @@ RECV_REK_COUNTER_DATA_EXIT:
 // Test Mode
 int send_enter_test_mode_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char enter_test_mode_cmd[4] = {0x55, 0x55, 0x55, 0x55};
 
@@ -514,6 +531,7 @@ int send_enter_test_mode_command(void)
 
 int send_exit_test_mode_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char exit_test_mode_cmd[4] = {(unsigned char)0xa5, (unsigned char)0xa5, (unsigned char)0xa5, (unsigned char)0xa5};
 
@@ -527,9 +545,85 @@ int send_exit_test_mode_command(void)
     return err;
 }
 
+// Test Mode Scope
+__thread int CTestModeScope::s_depth = 0;
+
+CTestModeScope::CTestModeScope(void)
+    : m_enter_err(TP_SUCCESS), m_held(false)
+{
+    // Nested Scope => Controller Already in Test Mode
+    if(s_depth > 0)
+    {
+        s_depth++;
+        m_held = true;
+        return;
+    }
+
+    // Enter Test Mode
+    m_enter_err = send_enter_test_mode_command();
+    if(m_enter_err != TP_SUCCESS)
+        return;
+
+    s_depth = 1;
+    m_held = true;
+}
+
+CTestModeScope::~CTestModeScope(void)
+{
+    leave();
+}
+
+int CTestModeScope::leave(void)
+{
+    int err = TP_SUCCESS;
+
+    // Make Sure This Scope Still Holds Test Mode
+    if(m_held == false)
+        goto TEST_MODE_SCOPE_LEAVE_EXIT;
+    m_held = false;
+
+    // Only the Outermost Scope Leaves Test Mode
+    s_depth--;
+    if(s_depth > 0)
+        goto TEST_MODE_SCOPE_LEAVE_EXIT;
+
+    // Leave Test Mode
+    err = send_exit_test_mode_command();
+
+TEST_MODE_SCOPE_LEAVE_EXIT:
+    return err;
+}
+
+int CTestModeScope::reenter(void)
+{
+    int err = TP_SUCCESS;
+
+    // No Active Scope => Next Attempt Enters on Its Own
+    if(s_depth == 0)
+        goto TEST_MODE_SCOPE_REENTER_EXIT;
+
+    // Leave Test Mode (Ignore Error, Controller May Have Dropped It Already)
+    send_exit_test_mode_command();
+
+    // Enter Test Mode Again
+    err = send_enter_test_mode_command();
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("%s: Fail to Re-Enter Test Mode! err=0x%x.\r\n", __func__, err);
+        goto TEST_MODE_SCOPE_REENTER_EXIT;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+TEST_MODE_SCOPE_REENTER_EXIT:
+    return err;
+}
+
 // ROM Data
 int send_read_rom_data_command(unsigned short addr, bool recovery, unsigned char info)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char read_rom_data_cmd[6] =  {0x96, 0x00, 0x00, 0x00, 0x00, 0x11} /* Show Bulk ROM Data Command */,
                   solution_id = 0,
@@ -554,33 +648,9 @@ int send_read_rom_data_command(unsigned short addr, bool recovery, unsigned char
     // Since Solution ID (FW Version) is only available in normal mode,
     //   we use high byte of bc_version to decide IC solution of the current touch controller in recovery mode.
     if(recovery == false) // Normal Mode
-    {
-        if (/* 63XX Solution */
-            (solution_id == SOLUTION_ID_EKTH6315x1) || \
-            (solution_id == SOLUTION_ID_EKTH6315x2) || \
-            (solution_id == SOLUTION_ID_EKTH6315to5015M) || \
-            (solution_id == SOLUTION_ID_EKTH6315to3915P) || \
-            /* 73XX Solution */
-            (solution_id == SOLUTION_ID_EKTH7315x1) || \
-            (solution_id == SOLUTION_ID_EKTH7315x2) || \
-            (solution_id == SOLUTION_ID_EKTH7318x1))
-            read_rom_data_cmd[5] = 0x21; // 63XX or 73XX: byte[5]=0x21 => Read Information
-        else
-            read_rom_data_cmd[5] = 0x11; // 53XX: byte[5]=0x11 => Read Information
-    }
+        read_rom_data_cmd[5] = get_chip_capability_by_solution_id(solution_id)->rom_read_selector;
     else // Recovery Mode
-    {
-        if (/* 63XX Solution */ \
-            (bc_version_high_byte == BC_VER_H_BYTE_FOR_EKTA6315_I2CHID) || \
-            (bc_version_high_byte == BC_VER_H_BYTE_FOR_EKTA6308_I2CHID) || \
-            (bc_version_high_byte == BC_VER_H_BYTE_FOR_EKTH6315_TO_5015M_I2CHID) || \
-            (bc_version_high_byte == BC_VER_H_BYTE_FOR_EKTH6315_TO_3915P_I2CHID) || \
-            /* 73XX Solution */ \
-            (bc_version_high_byte == BC_VER_H_BYTE_FOR_EKTA7315_I2CHID))
-            read_rom_data_cmd[5] = 0x21; // 63XX: byte[5]=0x21 => Read Information
-        else
-            read_rom_data_cmd[5] = 0x11; // 53XX: byte[5]=0x11 => Read Information
-    }
+        read_rom_data_cmd[5] = get_chip_capability_by_bc_ver_high_byte(bc_version_high_byte)->rom_read_selector;
 
     /* Send Show Bulk ROM Data Command */
     DEBUG_PRINTF("cmd: 0x%02x, 0x%02x, 0x%02x, 0x%02x, 0x%02x, 0x%02x.\r\n", \
@@ -595,11 +665,12 @@ int send_read_rom_data_command(unsigned short addr, bool recovery, unsigned char
 
 int receive_rom_data(unsigned short *p_rom_data)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char cmd_data[6] = {0};
     unsigned short rom_data = 0;
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_ROM_DATA, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS) // Error or Timeout
     {
         ERROR_PRINTF("Fail to receive ROM data! err=0x%x.\r\n", err);
@@ -629,6 +700,7 @@ RECEIVE_ROM_DATA_EXIT:
 // Bulk ROM Data
 int send_show_bulk_rom_data_command(unsigned short addr, unsigned short len)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char show_bulk_rom_data_cmd[6] =  {0x59, 0x10, 0x00, 0x00, 0x00, 0x00}; /* Show Bulk ROM Data Command */
 
@@ -652,6 +724,7 @@ int send_show_bulk_rom_data_command(unsigned short addr, unsigned short len)
 // Bulk ROM Data (in Boot Code)
 int send_show_bulk_rom_data_command(unsigned short addr)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char show_bulk_rom_data_cmd[6] =  {0x59, 0x00, 0x00, 0x00, 0x00, 0x01}; /* Show Bulk ROM Data Command (cmd[1]=0x00 in Boot Code) */
 
@@ -672,11 +745,12 @@ int send_show_bulk_rom_data_command(unsigned short addr)
 
 int receive_bulk_rom_data(unsigned short *p_rom_data)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char cmd_data[5] = {0};
     unsigned short rom_data = 0;
 
-    err = read_data(cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_BULK_ROM_DATA, cmd_data, sizeof(cmd_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS) // Error or Timeout
     {
         ERROR_PRINTF("Fail to receive Bulk ROM data! err=0x%x.\r\n", err);
@@ -706,6 +780,7 @@ RECEIVE_BULK_ROM_DATA_EXIT:
 // IAP Mode
 int send_write_flash_key_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char write_flash_key_cmd[4] = {0x54, 0xc0, 0xe1, 0x5a};
 
@@ -722,6 +797,7 @@ int send_write_flash_key_command(void)
 
 int send_enter_iap_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char enter_iap_cmd[4] = {0x54, 0x00, 0x12, 0x34};
 
@@ -738,6 +814,7 @@ int send_enter_iap_command(void)
 
 int send_slave_address(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char slave_addr =(unsigned char)(ELAN_I2C_SLAVE_ADDR >> 1); // 7-Bit I2C Slave Address
 
@@ -751,13 +828,34 @@ int send_slave_address(void)
 }
 
 // Frame Data
+
+/*
+ * Payload of One Page-Write Frame on the Bound Device
+ *
+ * Whole words behind the 5-byte frame header, so a 33-byte output report
+ * gives ELAN_I2CHID_PAGE_FRAME_SIZE (28) and larger vendor reports carry
+ * more per frame. Bounded by the 1-byte data length field.
+ */
+int get_page_frame_size(void)
+{
+    int frame_size = get_output_report_length() - ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE;
+
+    frame_size &= ~1;
+    if(frame_size > 0xFE)
+        frame_size = 0xFE;
+
+    return frame_size;
+}
+
 int write_frame_data(int data_offset, int data_len, unsigned char *frame_buf, int frame_buf_size)
 {
-    int err = TP_SUCCESS;
-    unsigned char hid_frame_data[ELAN_I2CHID_OUTPUT_BUFFER_SIZE] = {0};
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
+    int err = TP_SUCCESS,
+        report_len = get_output_report_length();
+    unsigned char hid_frame_data[I2CHID_REPORT_LEN_MAX] = {0};
 
     // Validate Data Length
-    if((data_len == 0) || (data_len > ELAN_I2CHID_PAGE_FRAME_SIZE))
+    if((data_len == 0) || (data_len > report_len - ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE))
     {
         ERROR_PRINTF("%s: Invalid Data Length: %d.\r\n", __func__, data_len);
         err = TP_ERR_INVALID_PARAM;
@@ -773,7 +871,7 @@ int write_frame_data(int data_offset, int data_len, unsigned char *frame_buf, in
     }
 
     // Valid Frame Buffer Size
-    if((frame_buf_size < data_len) || (frame_buf_size > ELAN_I2CHID_OUTPUT_BUFFER_SIZE))
+    if((frame_buf_size < data_len) || (frame_buf_size > report_len - ELAN_I2CHID_PAGE_FRAME_HEADER_SIZE))
     {
         ERROR_PRINTF("%s: Invalid Frame Buffer Size: %d.\r\n", __func__, frame_buf_size);
         err = TP_ERR_INVALID_PARAM;
@@ -781,7 +879,7 @@ int write_frame_data(int data_offset, int data_len, unsigned char *frame_buf, in
     }
 
     // Add header of vendor command to frame data
-    hid_frame_data[0] = ELAN_HID_OUTPUT_REPORT_ID;
+    hid_frame_data[0] = (unsigned char)get_output_report_id();
     hid_frame_data[1] = 0x21;
     hid_frame_data[2] = (unsigned char)((data_offset & 0xFF00) >> 8);	// High Byte of Data Offset //ex:00
     hid_frame_data[3] = (unsigned char) (data_offset & 0x00FF);			// Low  Byte of Data Offset //ex:1B
@@ -789,7 +887,7 @@ int write_frame_data(int data_offset, int data_len, unsigned char *frame_buf, in
     memcpy(&hid_frame_data[5], frame_buf, frame_buf_size);
 
     // Write frame data to touch
-    err = __hidraw_write(hid_frame_data, sizeof(hid_frame_data), ELAN_WRITE_DATA_TIMEOUT_MSEC);
+    err = __hidraw_write(hid_frame_data, report_len, ELAN_WRITE_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS)
         ERROR_PRINTF("Fail to write frame data, err=0x%x.\r\n", err);
 
@@ -800,6 +898,7 @@ WRITE_FRAME_DATA_EXIT:
 // Flash Write
 int send_flash_write_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char write_to_flash_cmd = 0x22; // Vendor Command
 
@@ -814,11 +913,12 @@ int send_flash_write_command(void)
 
 int receive_flash_write_response(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char flash_write_response_data[2] = {0};
 
     // Read Flash Write Response
-    err = read_data(flash_write_response_data, sizeof(flash_write_response_data), ELAN_READ_DATA_TIMEOUT_MSEC);
+    err = read_response(&ELAN_RESPONSE_FLASH_WRITE, flash_write_response_data, sizeof(flash_write_response_data), ELAN_READ_DATA_TIMEOUT_MSEC);
     if(err != TP_SUCCESS) // Error or Timeout
     {
         ERROR_PRINTF("Fail to receive Flash Write Response data! err=0x%x.\r\n", err);
@@ -838,6 +938,7 @@ int receive_flash_write_response(void)
     err = TP_SUCCESS;
 
 READ_FLASH_WRITE_RESPONSE_EXIT:
+    ELAN_PROBE3(flash_write_ack, err, flash_write_response_data[0], flash_write_response_data[1]);
     return err;
 }
 
@@ -845,6 +946,7 @@ READ_FLASH_WRITE_RESPONSE_EXIT:
 // Bridge CMD 0x18: If command <0x18> is issued, feedback Hello packet for Recovery Mode.
 int send_request_hello_packet_command(void)
 {
+    TRACE_EVENT_SCOPE(TRACE_CATEGORY_PROTOCOL);
     int err = TP_SUCCESS;
     unsigned char request_iap_recovery_hello_packet_cmd = 0x18; // Vendor Command
 
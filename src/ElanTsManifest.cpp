@@ -0,0 +1,617 @@
+/** @file
+
+  Implementation of Fleet Manifest Update for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsManifest.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>			/* usleep */
+#include <pthread.h>
+#include "ErrCode.h"
+#include "LogLevel.h"
+#include "I2CHIDLinuxGet.h"			/* ELAN_USB_VID */
+#include "HidrawSysfs.h"
+#include "HidrawBusScheduler.h"
+#include "ElanTsFwFileIoUtility.h"	/* FILE_NAME_LENGTH_MAX */
+#include "ElanTsPhaseTiming.h"		/* phase_timing_now_ns */
+#include "ElanIap.h"
+#include "ElanTsManifest.h"
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+struct manifest_entry
+{
+    // From Manifest
+    int line;
+    char selector[64];
+    char filename[FILE_NAME_LENGTH_MAX];
+    int skip_action_code;
+
+    // Resolved before Update
+    char device_path[64];
+    int i2c_bus;				// Parent Adapter "i2c-N", HIDRAW_BUS_NONE if Unknown
+
+    // Scheduling (Guarded by s_manifest_mutex)
+    bool started;
+    bool finished;
+
+    // Post-Update Re-K, Handed from Worker to manifest_run() (Guarded by s_manifest_mutex until Handed Over)
+    struct elan_iap_device *p_device;
+    struct elan_iap_calibration *p_calibration;
+    unsigned long long start_ns;
+
+    // Result
+    int err;
+    bool fw_version_before_valid;
+    unsigned short fw_version_before;
+    bool fw_version_after_valid;
+    unsigned short fw_version_after;
+    unsigned long long elapsed_ns;
+    int last_percent;
+};
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+static struct manifest_entry s_entries[MANIFEST_MAX_ENTRIES];
+static int s_entry_count = 0;
+static pthread_mutex_t s_manifest_mutex = PTHREAD_MUTEX_INITIALIZER;	// Guards Scheduling State & Console
+static pthread_cond_t s_manifest_cond = PTHREAD_COND_INITIALIZER;		// Calibration Handed Over or Worker Exited
+static int s_workers_running = 0;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+/*******************************************
+ *  Manifest
+ ******************************************/
+
+static int parse_manifest(const char *manifest_file)
+{
+    int err = TP_SUCCESS,
+        line_number = 0;
+    char line[FILE_NAME_LENGTH_MAX + 128] = {0};
+    char *p_save = NULL,
+         *p_selector = NULL,
+         *p_file = NULL,
+         *p_skip = NULL,
+         *p_comment = NULL;
+    FILE *p_file_handle = NULL;
+    struct manifest_entry *p_entry = NULL;
+
+    p_file_handle = fopen(manifest_file, "r");
+    if(p_file_handle == NULL)
+    {
+        ERROR_PRINTF("%s: Fail to open manifest \"%s\"!\r\n", __func__, manifest_file);
+        err = TP_ERR_FILE_NOT_FOUND;
+        goto PARSE_MANIFEST_EXIT;
+    }
+
+    s_entry_count = 0;
+    while(fgets(line, sizeof(line), p_file_handle) != NULL)
+    {
+        line_number++;
+
+        p_comment = strchr(line, '#');
+        if(p_comment)
+            *p_comment = '\0';
+
+        p_selector = strtok_r(line, " \t\r\n", &p_save);
+        if(p_selector == NULL) // Blank Line
+            continue;
+        p_file = strtok_r(NULL, " \t\r\n", &p_save);
+        p_skip = strtok_r(NULL, " \t\r\n", &p_save);
+
+        if((p_file == NULL) || (strlen(p_selector) >= sizeof(p_entry->selector)) || (strlen(p_file) >= sizeof(p_entry->filename)))
+        {
+            ERROR_PRINTF("%s: %s:%d: Expected \"<selector> <firmware_file> [skip_action_code]\"!\r\n", __func__, manifest_file, line_number);
+            err = TP_ERR_INVALID_PARAM;
+            goto PARSE_MANIFEST_CLOSE;
+        }
+
+        if(s_entry_count >= MANIFEST_MAX_ENTRIES)
+        {
+            ERROR_PRINTF("%s: %s: More than %d entries!\r\n", __func__, manifest_file, MANIFEST_MAX_ENTRIES);
+            err = TP_ERR_INVALID_PARAM;
+            goto PARSE_MANIFEST_CLOSE;
+        }
+
+        p_entry = &s_entries[s_entry_count++];
+        memset(p_entry, 0, sizeof(*p_entry));
+        p_entry->line = line_number;
+        strcpy(p_entry->selector, p_selector);
+        strcpy(p_entry->filename, p_file);
+        p_entry->skip_action_code = (p_skip != NULL) ? atoi(p_skip) : 0;
+        p_entry->err = TP_ERR_IO_PENDING;
+        p_entry->last_percent = -1;
+    }
+
+    if(s_entry_count == 0)
+    {
+        ERROR_PRINTF("%s: %s: No entry!\r\n", __func__, manifest_file);
+        err = TP_ERR_INVALID_PARAM;
+        goto PARSE_MANIFEST_CLOSE;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+PARSE_MANIFEST_CLOSE:
+    fclose(p_file_handle);
+
+PARSE_MANIFEST_EXIT:
+    return err;
+}
+
+// Resolve Every Selector & Check Every Distinct Image Once, before Touching Any Panel
+static int preflight_manifest(void)
+{
+    int err = TP_SUCCESS,
+        index = 0,
+        other = 0;
+    struct manifest_entry *p_entry = NULL;
+    struct elan_iap_image *p_image = NULL;
+    struct hidraw_sysfs_info info;
+    bool checked = false;
+
+    for(index = 0; index < s_entry_count; index++)
+    {
+        p_entry = &s_entries[index];
+
+        err = hidraw_sysfs_resolve_selector(ELAN_USB_VID, p_entry->selector, p_entry->device_path, sizeof(p_entry->device_path));
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Line %d: No device matches \"%s\"! err=0x%x.\r\n", __func__, p_entry->line, p_entry->selector, err);
+            return err;
+        }
+
+        // Parent Adapter from sysfs, Panels on One Adapter Share its Bandwidth
+        p_entry->i2c_bus = HIDRAW_BUS_NONE;
+        if((hidraw_sysfs_get_info(p_entry->device_path, &info) == TP_SUCCESS) && (info.i2c_bus >= 0))
+            p_entry->i2c_bus = info.i2c_bus;
+
+        // Two Updates Must Never Share a Panel
+        for(other = 0; other < index; other++)
+        {
+            if(strcmp(s_entries[other].device_path, p_entry->device_path) == 0)
+            {
+                ERROR_PRINTF("%s: Line %d: \"%s\" is %s, already listed on line %d!\r\n", __func__,
+                             p_entry->line, p_entry->selector, p_entry->device_path, s_entries[other].line);
+                return TP_ERR_INVALID_PARAM;
+            }
+        }
+
+        checked = false;
+        for(other = 0; other < index; other++)
+        {
+            if(strcmp(s_entries[other].filename, p_entry->filename) == 0)
+            {
+                checked = true;
+                break;
+            }
+        }
+        if(checked)
+            continue;
+
+        err = elan_iap_image_open(p_entry->filename, &p_image);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("%s: Line %d: Invalid firmware \"%s\"! err=0x%x.\r\n", __func__, p_entry->line, p_entry->filename, err);
+            return err;
+        }
+        elan_iap_image_close(p_image);
+    }
+
+    return TP_SUCCESS;
+}
+
+/*******************************************
+ *  Update
+ ******************************************/
+
+// Print One Line per 10% of Page Blocks
+static void print_progress(int block_done, int block_count, void *p_user_data)
+{
+    struct manifest_entry *p_entry = (struct manifest_entry *)p_user_data;
+    int percent = (block_count > 0) ? (block_done * 100 / block_count) : 100;
+
+    percent -= percent % 10;
+    if(percent == p_entry->last_percent)
+        return;
+    p_entry->last_percent = percent;
+
+    pthread_mutex_lock(&s_manifest_mutex);
+    printf("[%s] %3d%%\r\n", p_entry->selector, percent);
+    fflush(stdout);
+    pthread_mutex_unlock(&s_manifest_mutex);
+}
+
+static void print_status(const struct manifest_entry *p_entry, const char *status)
+{
+    pthread_mutex_lock(&s_manifest_mutex);
+    printf("[%s] %s\r\n", p_entry->selector, status);
+    fflush(stdout);
+    pthread_mutex_unlock(&s_manifest_mutex);
+}
+
+static int read_version_after(struct manifest_entry *p_entry, struct elan_iap_device *p_device)
+{
+    int err = TP_SUCCESS;
+    struct elan_iap_fw_info fw_info;
+
+    err = elan_iap_get_fw_info(p_device, &fw_info);
+    if(err != TP_SUCCESS)
+        return err;
+    p_entry->fw_version_after = fw_info.fw_version;
+    p_entry->fw_version_after_valid = true;
+
+    return TP_SUCCESS;
+}
+
+// Same Steps as "-f" on One Panel, TP_ERR_IO_PENDING if Handed Over for Re-K
+static int update_entry(struct manifest_entry *p_entry)
+{
+    int err = TP_SUCCESS,
+        gen8 = 0,
+        recovery = 0;
+    struct elan_iap_device *p_device = NULL;
+    struct elan_iap_image *p_image = NULL;
+    struct elan_iap_calibration *p_calibration = NULL;
+    struct elan_iap_fw_info fw_info;
+
+    err = elan_iap_device_open_path(p_entry->device_path, &p_device);
+    if(err != TP_SUCCESS)
+        goto UPDATE_ENTRY_EXIT;
+    elan_iap_device_get_state(p_device, &gen8, &recovery);
+
+    if(recovery == 0)
+    {
+        err = elan_iap_get_fw_info(p_device, &fw_info);
+        if(err != TP_SUCCESS)
+            goto UPDATE_ENTRY_CLOSE_DEVICE;
+        p_entry->fw_version_before = fw_info.fw_version;
+        p_entry->fw_version_before_valid = true;
+    }
+
+    err = elan_iap_image_open(p_entry->filename, &p_image);
+    if(err != TP_SUCCESS)
+        goto UPDATE_ENTRY_CLOSE_DEVICE;
+
+    print_status(p_entry, "Updating...");
+    elan_iap_device_set_progress_callback(p_device, print_progress, p_entry);
+    err = elan_iap_update_firmware(p_device, p_image, p_entry->skip_action_code);
+    elan_iap_image_close(p_image);
+    if(err != TP_SUCCESS)
+        goto UPDATE_ENTRY_CLOSE_DEVICE;
+
+    if(gen8) // Gen8 Touch
+    {
+        hidraw_bus_release(); // bus idle while panel self-calibrates
+        usleep(300 * 1000); // wait 300ms for self-calibration
+    }
+    else // Gen5/6/7 Touch
+    {
+        // Re-K Takes Seconds: Leave the Wait to manifest_run(), Free This Worker for the Next Panel
+        err = elan_iap_calibrate_async(p_device, &p_calibration);
+        if(err != TP_SUCCESS)
+            goto UPDATE_ENTRY_CLOSE_DEVICE;
+
+        print_status(p_entry, "Calibrating...");
+        pthread_mutex_lock(&s_manifest_mutex);
+        p_entry->p_device = p_device;
+        p_entry->p_calibration = p_calibration;
+        pthread_cond_signal(&s_manifest_cond);
+        pthread_mutex_unlock(&s_manifest_mutex);
+        err = TP_ERR_IO_PENDING;
+        goto UPDATE_ENTRY_EXIT;
+    }
+
+    err = read_version_after(p_entry, p_device);
+
+UPDATE_ENTRY_CLOSE_DEVICE:
+    elan_iap_device_close(p_device);
+
+UPDATE_ENTRY_EXIT:
+    return err;
+}
+
+// Re-K Completed on a Handed-Over Entry: Read New Version, Close Device
+static int finish_calibration(struct manifest_entry *p_entry)
+{
+    int err = elan_iap_calibration_get_result(p_entry->p_calibration);
+
+    elan_iap_calibration_free(p_entry->p_calibration);
+    p_entry->p_calibration = NULL;
+
+    if(err == TP_SUCCESS)
+    {
+        hidraw_bus_bind(p_entry->i2c_bus);
+        err = read_version_after(p_entry, p_entry->p_device);
+        hidraw_bus_bind(HIDRAW_BUS_NONE);
+    }
+
+    elan_iap_device_close(p_entry->p_device);
+    p_entry->p_device = NULL;
+    return err;
+}
+
+/*
+ * Next Entry to Start, NULL if None Left (Caller Holds s_manifest_mutex)
+ *
+ * Prefers the adapter with the fewest updates running, so a free worker
+ * first goes to an idle adapter (full parallelism) and only then doubles up
+ * on a busy one (interleaving with the bus-idle waits of the other panel).
+ */
+static struct manifest_entry *pick_next_entry(void)
+{
+    int index = 0,
+        other = 0,
+        running = 0,
+        least_running = MANIFEST_MAX_ENTRIES + 1;
+    struct manifest_entry *p_entry = NULL,
+                          *p_next = NULL;
+
+    for(index = 0; index < s_entry_count; index++)
+    {
+        p_entry = &s_entries[index];
+        if(p_entry->started)
+            continue;
+
+        running = 0;
+        if(p_entry->i2c_bus != HIDRAW_BUS_NONE)
+        {
+            for(other = 0; other < s_entry_count; other++)
+            {
+                if(s_entries[other].started && !s_entries[other].finished && (s_entries[other].i2c_bus == p_entry->i2c_bus))
+                    running++;
+            }
+        }
+
+        if(running < least_running)
+        {
+            least_running = running;
+            p_next = p_entry;
+        }
+    }
+
+    if(p_next)
+        p_next->started = true;
+
+    return p_next;
+}
+
+static void finish_entry(struct manifest_entry *p_entry, int err)
+{
+    char status[64] = {0};
+
+    p_entry->err = err;
+    p_entry->elapsed_ns = phase_timing_now_ns() - p_entry->start_ns;
+
+    pthread_mutex_lock(&s_manifest_mutex);
+    p_entry->finished = true;
+    pthread_mutex_unlock(&s_manifest_mutex);
+
+    if(p_entry->err == TP_SUCCESS)
+        snprintf(status, sizeof(status), "Done in %.1fs.", p_entry->elapsed_ns / 1000000000.0);
+    else
+        snprintf(status, sizeof(status), "Failed! err=0x%x.", p_entry->err);
+    print_status(p_entry, status);
+}
+
+static void *update_worker(void *p_arg)
+{
+    int err = TP_SUCCESS;
+    struct manifest_entry *p_entry = NULL;
+
+    while(true)
+    {
+        pthread_mutex_lock(&s_manifest_mutex);
+        p_entry = pick_next_entry();
+        pthread_mutex_unlock(&s_manifest_mutex);
+        if(p_entry == NULL)
+            break;
+
+        // Share the Adapter with Other Workers at Burst Granularity
+        hidraw_bus_bind(p_entry->i2c_bus);
+        p_entry->start_ns = phase_timing_now_ns();
+        err = update_entry(p_entry);
+        hidraw_bus_bind(HIDRAW_BUS_NONE);
+
+        // Handed Over: wait_calibrations() Finishes It
+        if(err != TP_ERR_IO_PENDING)
+            finish_entry(p_entry, err);
+    }
+
+    pthread_mutex_lock(&s_manifest_mutex);
+    s_workers_running--;
+    pthread_cond_signal(&s_manifest_cond);
+    pthread_mutex_unlock(&s_manifest_mutex);
+
+    return NULL;
+}
+
+/*
+ * Wait on Every Handed-Over Re-K at Once until All Workers Exited & No
+ * Calibration is Left. A worker hands a panel over right after sending
+ * Re-K, so the seconds of waiting never hold a worker slot.
+ */
+static void wait_calibrations(void)
+{
+    int index = 0,
+        count = 0;
+    struct elan_iap_calibration *p_calibrations[MANIFEST_MAX_ENTRIES];
+    struct manifest_entry *p_entries[MANIFEST_MAX_ENTRIES];
+
+    while(true)
+    {
+        pthread_mutex_lock(&s_manifest_mutex);
+        while(true)
+        {
+            count = 0;
+            for(index = 0; index < s_entry_count; index++)
+            {
+                if(s_entries[index].finished || (s_entries[index].p_calibration == NULL))
+                    continue;
+                p_entries[count] = &s_entries[index];
+                p_calibrations[count] = s_entries[index].p_calibration;
+                count++;
+            }
+            if((count > 0) || (s_workers_running == 0))
+                break;
+            pthread_cond_wait(&s_manifest_cond, &s_manifest_mutex);
+        }
+        pthread_mutex_unlock(&s_manifest_mutex);
+        if(count == 0)
+            break;
+
+        // Short Slices, so Panels Handed Over Meanwhile Join the Next Poll
+        if(elan_iap_calibrate_poll(p_calibrations, count, MANIFEST_CALIBRATION_POLL_MSEC) < 0)
+            usleep(MANIFEST_CALIBRATION_POLL_MSEC * 1000);
+
+        for(index = 0; index < count; index++)
+        {
+            if(elan_iap_calibration_get_result(p_calibrations[index]) != TP_ERR_IO_PENDING)
+                finish_entry(p_entries[index], finish_calibration(p_entries[index]));
+        }
+    }
+}
+
+// Distinct Known Adapters among Entries
+static int count_i2c_adapters(void)
+{
+    int index = 0,
+        other = 0,
+        adapter_count = 0;
+
+    for(index = 0; index < s_entry_count; index++)
+    {
+        if(s_entries[index].i2c_bus == HIDRAW_BUS_NONE)
+            continue;
+        for(other = 0; other < index; other++)
+        {
+            if(s_entries[other].i2c_bus == s_entries[index].i2c_bus)
+                break;
+        }
+        if(other == index)
+            adapter_count++;
+    }
+
+    return adapter_count;
+}
+
+static void print_result_table(void)
+{
+    int index = 0;
+    const struct manifest_entry *p_entry = NULL;
+    const char *p_basename = NULL;
+    char bus[16] = {0},
+         before[8] = {0},
+         after[8] = {0};
+
+    printf("--------------------------------\r\n");
+    printf("%-20s %-14s %-8s %-28s %-6s %-6s %8s  %s\r\n", "Selector", "Device", "Bus", "Firmware", "Before", "After", "Time(s)", "Result");
+    for(index = 0; index < s_entry_count; index++)
+    {
+        p_entry = &s_entries[index];
+        p_basename = strrchr(p_entry->filename, '/');
+        p_basename = (p_basename) ? p_basename + 1 : p_entry->filename;
+        strcpy(bus, "-");
+        if(p_entry->i2c_bus != HIDRAW_BUS_NONE)
+            snprintf(bus, sizeof(bus), "i2c-%d", p_entry->i2c_bus);
+        strcpy(before, "-");
+        if(p_entry->fw_version_before_valid)
+            snprintf(before, sizeof(before), "%04x", p_entry->fw_version_before);
+        strcpy(after, "-");
+        if(p_entry->fw_version_after_valid)
+            snprintf(after, sizeof(after), "%04x", p_entry->fw_version_after);
+
+        if(p_entry->err == TP_SUCCESS)
+            printf("%-20s %-14s %-8s %-28s %-6s %-6s %8.1f  OK\r\n", p_entry->selector, p_entry->device_path, bus, p_basename,
+                   before, after, p_entry->elapsed_ns / 1000000000.0);
+        else
+            printf("%-20s %-14s %-8s %-28s %-6s %-6s %8.1f  FAIL (0x%x)\r\n", p_entry->selector, p_entry->device_path, bus, p_basename,
+                   before, after, p_entry->elapsed_ns / 1000000000.0, p_entry->err);
+    }
+}
+
+int manifest_run(const char *manifest_file, int max_parallel)
+{
+    int err = TP_SUCCESS,
+        index = 0,
+        thread_count = 0;
+    pthread_t threads[MANIFEST_MAX_ENTRIES];
+
+    if((manifest_file == NULL) || (max_parallel <= 0))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto MANIFEST_RUN_EXIT;
+    }
+
+    err = parse_manifest(manifest_file);
+    if(err != TP_SUCCESS)
+        goto MANIFEST_RUN_EXIT;
+
+    err = preflight_manifest();
+    if(err != TP_SUCCESS)
+        goto MANIFEST_RUN_EXIT;
+
+    // Start Workers
+    thread_count = (max_parallel < s_entry_count) ? max_parallel : s_entry_count;
+    printf("Updating %d panel(s) on %d I2C adapter(s), %d at a time.\r\n", s_entry_count, count_i2c_adapters(), thread_count);
+    s_workers_running = 0;
+    for(index = 0; index < thread_count; index++)
+    {
+        pthread_mutex_lock(&s_manifest_mutex);
+        s_workers_running++;
+        pthread_mutex_unlock(&s_manifest_mutex);
+        if(pthread_create(&threads[index], NULL, update_worker, NULL) != 0)
+        {
+            ERROR_PRINTF("%s: Fail to create worker thread %d!\r\n", __func__, index);
+            pthread_mutex_lock(&s_manifest_mutex);
+            s_workers_running--;
+            pthread_mutex_unlock(&s_manifest_mutex);
+            break;
+        }
+    }
+    thread_count = index;
+
+    // No Worker at All => Run in This Thread
+    if(thread_count == 0)
+    {
+        s_workers_running = 1;
+        update_worker(NULL);
+    }
+    wait_calibrations();
+    for(index = 0; index < thread_count; index++)
+        pthread_join(threads[index], NULL);
+
+    print_result_table();
+
+    // First Failure Decides Exit Code
+    err = TP_SUCCESS;
+    for(index = 0; index < s_entry_count; index++)
+    {
+        if(s_entries[index].err != TP_SUCCESS)
+        {
+            err = s_entries[index].err;
+            break;
+        }
+    }
+
+MANIFEST_RUN_EXIT:
+    return err;
+}
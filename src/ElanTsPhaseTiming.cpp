@@ -0,0 +1,188 @@
+/** @file
+
+  Implementation of Phase Timing for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsPhaseTiming.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <string.h>
+#include <time.h>		/* clock_gettime */
+#include "ErrCode.h"
+#include "ElanTsPhaseTiming.h"
+#include "ElanTsTraceEvent.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Phase Names (Also Used as Keys of Machine-Readable Output)
+static const char * const s_phase_names[PHASE_COUNT] =
+{
+    "device_discovery",
+    "hello_probe",
+    "info_query",
+    "info_page_update",
+    "remark_check",
+    "boot_code_switch",
+    "erase",
+    "page_program",
+    "reset_wait",
+    "post_update_info",
+    "calibration"
+};
+
+// Per-Thread, so Parallel update_worker Threads Never Share a Clock
+static __thread struct phase_stat s_phase_stats[PHASE_COUNT];
+static __thread unsigned long long s_phase_start_ns[PHASE_COUNT];
+static __thread unsigned long long s_timing_start_ns = 0;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+unsigned long long phase_timing_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void phase_timing_reset(void)
+{
+    memset(s_phase_stats, 0, sizeof(s_phase_stats));
+    memset(s_phase_start_ns, 0, sizeof(s_phase_start_ns));
+    s_timing_start_ns = phase_timing_now_ns();
+}
+
+void phase_begin(enum phase_id phase)
+{
+    if((phase < 0) || (phase >= PHASE_COUNT))
+        return;
+
+    if(s_timing_start_ns == 0)
+        s_timing_start_ns = phase_timing_now_ns();
+    s_phase_start_ns[phase] = phase_timing_now_ns();
+    trace_event_begin(s_phase_names[phase], TRACE_CATEGORY_PHASE);
+}
+
+void phase_end(enum phase_id phase)
+{
+    unsigned long long span_ns = 0;
+    struct phase_stat *p_stat = NULL;
+
+    if((phase < 0) || (phase >= PHASE_COUNT) || (s_phase_start_ns[phase] == 0))
+        return;
+
+    span_ns = phase_timing_now_ns() - s_phase_start_ns[phase];
+    s_phase_start_ns[phase] = 0;
+    trace_event_end(s_phase_names[phase], TRACE_CATEGORY_PHASE);
+
+    p_stat = &s_phase_stats[phase];
+    if((p_stat->count == 0) || (span_ns < p_stat->min_ns))
+        p_stat->min_ns = span_ns;
+    if(span_ns > p_stat->max_ns)
+        p_stat->max_ns = span_ns;
+    p_stat->total_ns += span_ns;
+    p_stat->count++;
+}
+
+const char *phase_name(enum phase_id phase)
+{
+    if((phase < 0) || (phase >= PHASE_COUNT))
+        return "unknown";
+    return s_phase_names[phase];
+}
+
+const struct phase_stat *phase_timing_get_stat(enum phase_id phase)
+{
+    if((phase < 0) || (phase >= PHASE_COUNT))
+        return NULL;
+    return &s_phase_stats[phase];
+}
+
+unsigned long long phase_timing_elapsed_ns(void)
+{
+    if(s_timing_start_ns == 0)
+        return 0;
+    return phase_timing_now_ns() - s_timing_start_ns;
+}
+
+void phase_timing_print_summary(FILE *p_stream)
+{
+    int phase = 0;
+    const struct phase_stat *p_stat = NULL;
+
+    if(p_stream == NULL)
+        return;
+
+    fprintf(p_stream, "--------------------------------\r\n");
+    fprintf(p_stream, "[Phase Timing]\r\n");
+    fprintf(p_stream, "%-18s %6s %12s %10s %10s %10s\r\n", "phase", "count", "total(ms)", "min(ms)", "avg(ms)", "max(ms)");
+    for(phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        p_stat = &s_phase_stats[phase];
+        if(p_stat->count == 0)
+            continue;
+        fprintf(p_stream, "%-18s %6u %12.3f %10.3f %10.3f %10.3f\r\n", s_phase_names[phase], p_stat->count,
+                p_stat->total_ns / 1000000.0, p_stat->min_ns / 1000000.0,
+                (p_stat->total_ns / (double)p_stat->count) / 1000000.0, p_stat->max_ns / 1000000.0);
+    }
+    fprintf(p_stream, "%-18s %6s %12.3f\r\n", "total", "", phase_timing_elapsed_ns() / 1000000.0);
+}
+
+int phase_timing_write_json(const char *filename)
+{
+    int err = TP_SUCCESS,
+        phase = 0;
+    bool first = true;
+    FILE *p_file = NULL;
+    const struct phase_stat *p_stat = NULL;
+
+    if((filename == NULL) || (filename[0] == '\0'))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto WRITE_JSON_EXIT;
+    }
+
+    p_file = fopen(filename, "w");
+    if(p_file == NULL)
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_JSON_EXIT;
+    }
+
+    // Durations in Microseconds
+    fprintf(p_file, "{\"total_us\":%llu,\"phases\":[", phase_timing_elapsed_ns() / 1000ULL);
+    for(phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        p_stat = &s_phase_stats[phase];
+        if(p_stat->count == 0)
+            continue;
+        fprintf(p_file, "%s\n{\"name\":\"%s\",\"count\":%u,\"total_us\":%llu,\"min_us\":%llu,\"avg_us\":%llu,\"max_us\":%llu}",
+                (first) ? "" : ",", s_phase_names[phase], p_stat->count,
+                p_stat->total_ns / 1000ULL, p_stat->min_ns / 1000ULL,
+                (p_stat->total_ns / p_stat->count) / 1000ULL, p_stat->max_ns / 1000ULL);
+        first = false;
+    }
+    fprintf(p_file, "\n]}\n");
+
+    if(fclose(p_file) != 0)
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_JSON_EXIT;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+WRITE_JSON_EXIT:
+    return err;
+}
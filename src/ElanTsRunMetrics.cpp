@@ -0,0 +1,212 @@
+/** @file
+
+  Implementation of OpenMetrics Run Report for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsRunMetrics.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>		/* time */
+#include <unistd.h>		/* fsync, getpid, unlink */
+#include "ErrCode.h"
+#include "ElanTsPhaseTiming.h"
+#include "ElanTsRunMetrics.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Per-Thread, so Parallel update_worker Threads Never Share a Report
+static __thread struct run_metrics s_run_metrics;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+void run_metrics_reset(void)
+{
+    memset(&s_run_metrics, 0, sizeof(s_run_metrics));
+}
+
+void run_metrics_set_device(unsigned int vid, unsigned int pid)
+{
+    s_run_metrics.vid = vid;
+    s_run_metrics.pid = pid;
+    s_run_metrics.device_valid = true;
+}
+
+void run_metrics_record_fw_version(unsigned short fw_version)
+{
+    if(s_run_metrics.updated)
+    {
+        s_run_metrics.fw_version_after = fw_version;
+        s_run_metrics.fw_version_after_valid = true;
+    }
+    else
+    {
+        s_run_metrics.fw_version_before = fw_version;
+        s_run_metrics.fw_version_before_valid = true;
+    }
+}
+
+void run_metrics_mark_updated(void)
+{
+    s_run_metrics.updated = true;
+}
+
+void run_metrics_record_calibration_counter(unsigned short calibration_counter)
+{
+    s_run_metrics.calibration_counter = calibration_counter;
+    s_run_metrics.calibration_counter_valid = true;
+}
+
+void run_metrics_add_pages_written(unsigned int page_count)
+{
+    s_run_metrics.pages_written += page_count;
+}
+
+void run_metrics_count_retry(void)
+{
+    s_run_metrics.retries++;
+}
+
+void run_metrics_set_result(int error_code)
+{
+    s_run_metrics.error_code = error_code;
+}
+
+const struct run_metrics *run_metrics_get(void)
+{
+    return &s_run_metrics;
+}
+
+// "# HELP" & "# TYPE" Lines (All Metrics are Gauges of the Last Run)
+static void write_metric_header(FILE *p_file, const char *name, const char *help)
+{
+    fprintf(p_file, "# HELP " RUN_METRICS_PREFIX "%s %s\n", name, help);
+    fprintf(p_file, "# TYPE " RUN_METRICS_PREFIX "%s gauge\n", name);
+}
+
+static void write_metrics(FILE *p_file)
+{
+    int phase = 0;
+    const struct phase_stat *p_stat = NULL;
+
+    write_metric_header(p_file, "success", "1 if the run finished without error.");
+    fprintf(p_file, RUN_METRICS_PREFIX "success %d\n", (s_run_metrics.error_code == TP_SUCCESS) ? 1 : 0);
+
+    write_metric_header(p_file, "error_code", "Error code of the run (0: success).");
+    fprintf(p_file, RUN_METRICS_PREFIX "error_code %d\n", s_run_metrics.error_code);
+
+    write_metric_header(p_file, "last_run_timestamp_seconds", "Unix time the run finished.");
+    fprintf(p_file, RUN_METRICS_PREFIX "last_run_timestamp_seconds %ld\n", (long)time(NULL));
+
+    write_metric_header(p_file, "duration_seconds", "Wall time of the run.");
+    fprintf(p_file, RUN_METRICS_PREFIX "duration_seconds %.6f\n", phase_timing_elapsed_ns() / 1000000000.0);
+
+    write_metric_header(p_file, "phase_duration_seconds", "Total time spent in each phase of the run.");
+    for(phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        p_stat = phase_timing_get_stat((enum phase_id)phase);
+        if((p_stat == NULL) || (p_stat->count == 0))
+            continue;
+        fprintf(p_file, RUN_METRICS_PREFIX "phase_duration_seconds{phase=\"%s\"} %.6f\n",
+                phase_name((enum phase_id)phase), p_stat->total_ns / 1000000000.0);
+    }
+
+    write_metric_header(p_file, "pages_written", "Flash pages written (information page included).");
+    fprintf(p_file, RUN_METRICS_PREFIX "pages_written %u\n", s_run_metrics.pages_written);
+
+    write_metric_header(p_file, "retries", "Failed attempts inside error-retry loops.");
+    fprintf(p_file, RUN_METRICS_PREFIX "retries %u\n", s_run_metrics.retries);
+
+    if(s_run_metrics.fw_version_before_valid || s_run_metrics.fw_version_after_valid)
+    {
+        write_metric_header(p_file, "fw_version", "FW version before and after update.");
+        if(s_run_metrics.fw_version_before_valid)
+            fprintf(p_file, RUN_METRICS_PREFIX "fw_version{stage=\"before\",hex=\"%04x\"} %u\n",
+                    s_run_metrics.fw_version_before, s_run_metrics.fw_version_before);
+        if(s_run_metrics.fw_version_after_valid)
+            fprintf(p_file, RUN_METRICS_PREFIX "fw_version{stage=\"after\",hex=\"%04x\"} %u\n",
+                    s_run_metrics.fw_version_after, s_run_metrics.fw_version_after);
+    }
+
+    if(s_run_metrics.calibration_counter_valid)
+    {
+        write_metric_header(p_file, "calibration_counter", "Calibration (Re-K) counter.");
+        fprintf(p_file, RUN_METRICS_PREFIX "calibration_counter %u\n", s_run_metrics.calibration_counter);
+    }
+
+    if(s_run_metrics.device_valid)
+    {
+        write_metric_header(p_file, "device_info", "VID / PID of the touch device.");
+        fprintf(p_file, RUN_METRICS_PREFIX "device_info{vid=\"%04x\",pid=\"%04x\"} 1\n", s_run_metrics.vid, s_run_metrics.pid);
+    }
+}
+
+int run_metrics_write_openmetrics(const char *filename)
+{
+    int err = TP_SUCCESS;
+    char tmp_filename[1024] = {0};
+    FILE *p_file = NULL;
+
+    if((filename == NULL) || (filename[0] == '\0'))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto WRITE_OPENMETRICS_EXIT;
+    }
+
+    /* Scrapers Must Never See a Half-Written File:
+     * Write to a Sibling File (Name Not Ending in .prom) then Rename over the Target. */
+    if(snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp.%d", filename, (int)getpid()) >= (int)sizeof(tmp_filename))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto WRITE_OPENMETRICS_EXIT;
+    }
+
+    p_file = fopen(tmp_filename, "w");
+    if(p_file == NULL)
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_OPENMETRICS_EXIT;
+    }
+
+    write_metrics(p_file);
+
+    if((fflush(p_file) != 0) || (fsync(fileno(p_file)) != 0) || ferror(p_file))
+    {
+        fclose(p_file);
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_OPENMETRICS_REMOVE_TMP;
+    }
+
+    if(fclose(p_file) != 0)
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_OPENMETRICS_REMOVE_TMP;
+    }
+
+    if(rename(tmp_filename, filename) != 0)
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto WRITE_OPENMETRICS_REMOVE_TMP;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+    goto WRITE_OPENMETRICS_EXIT;
+
+WRITE_OPENMETRICS_REMOVE_TMP:
+    unlink(tmp_filename);
+
+WRITE_OPENMETRICS_EXIT:
+    return err;
+}
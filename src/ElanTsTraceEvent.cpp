@@ -0,0 +1,212 @@
+/** @file
+
+  Implementation of Chrome Trace-Event Export for Elan I2C-HID Touchscreen.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	ElanTsTraceEvent.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>		/* usleep, getpid, syscall */
+#include <pthread.h>
+#include <sys/syscall.h>	/* SYS_gettid */
+#include "ErrCode.h"
+#include "ElanTsPhaseTiming.h"
+#include "HidrawBusScheduler.h"
+#include "ElanTsTraceEvent.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+bool g_trace_event_enabled = false;
+
+static FILE *s_trace_event_file = NULL;
+static char *s_trace_event_buf = NULL;
+static unsigned long long s_trace_event_start_ns = 0;
+static int s_trace_event_pid = 0;
+static bool s_trace_event_first = true;
+
+// Serializes Events from Parallel update_worker Threads on the Shared File
+static pthread_mutex_t s_trace_event_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Cumulative Transferred Bytes
+static unsigned long long s_bytes_out = 0;
+static unsigned long long s_bytes_in = 0;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+// Microseconds since Trace Start, with ns Precision (Caller Holds s_trace_event_mutex)
+static void write_event_head(const char *name, const char *category, char phase)
+{
+    unsigned long long ts_ns = phase_timing_now_ns() - s_trace_event_start_ns;
+
+    fprintf(s_trace_event_file, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":%d,\"tid\":%d",
+            (s_trace_event_first) ? "" : ",", name, category, phase, ts_ns / 1000ULL, ts_ns % 1000ULL,
+            s_trace_event_pid, (int)syscall(SYS_gettid));
+    s_trace_event_first = false;
+}
+
+static void write_event(const char *name, const char *category, char phase)
+{
+    pthread_mutex_lock(&s_trace_event_mutex);
+    if(s_trace_event_file)
+    {
+        write_event_head(name, category, phase);
+        fprintf(s_trace_event_file, "}");
+    }
+    pthread_mutex_unlock(&s_trace_event_mutex);
+}
+
+// Caller Holds s_trace_event_mutex
+static void write_counter(const char *name, const char *series, unsigned long long value)
+{
+    if(s_trace_event_file == NULL)
+        return;
+
+    write_event_head(name, "counter", 'C');
+    fprintf(s_trace_event_file, ",\"args\":{\"%s\":%llu}}", series, value);
+}
+
+int trace_event_open(const char *filename)
+{
+    int err = TP_SUCCESS;
+
+    if((filename == NULL) || (filename[0] == '\0'))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto TRACE_EVENT_OPEN_EXIT;
+    }
+
+    // Re-Open
+    trace_event_close();
+
+    pthread_mutex_lock(&s_trace_event_mutex);
+    s_trace_event_file = fopen(filename, "w");
+    if(s_trace_event_file == NULL)
+    {
+        pthread_mutex_unlock(&s_trace_event_mutex);
+        err = TP_ERR_FILE_IO_ERROR;
+        goto TRACE_EVENT_OPEN_EXIT;
+    }
+
+    // Events are Only Written Out when the Buffer Fills Up or on Close
+    s_trace_event_buf = (char *)malloc(TRACE_EVENT_BUF_SIZE);
+    if(s_trace_event_buf)
+        setvbuf(s_trace_event_file, s_trace_event_buf, _IOFBF, TRACE_EVENT_BUF_SIZE);
+
+    s_trace_event_start_ns = phase_timing_now_ns();
+    s_trace_event_pid = (int)getpid();
+    s_trace_event_first = true;
+    s_bytes_out = 0;
+    s_bytes_in = 0;
+
+    // JSON Array Format: Closing Bracket is Optional, so a Crashed Run Still Loads
+    fprintf(s_trace_event_file, "[");
+    g_trace_event_enabled = true;
+    pthread_mutex_unlock(&s_trace_event_mutex);
+
+    // Success
+    err = TP_SUCCESS;
+
+TRACE_EVENT_OPEN_EXIT:
+    return err;
+}
+
+void trace_event_close(void)
+{
+    pthread_mutex_lock(&s_trace_event_mutex);
+    g_trace_event_enabled = false;
+
+    if(s_trace_event_file)
+    {
+        fprintf(s_trace_event_file, "\n]\n");
+        fclose(s_trace_event_file);
+        s_trace_event_file = NULL;
+    }
+
+    if(s_trace_event_buf)
+    {
+        free(s_trace_event_buf);
+        s_trace_event_buf = NULL;
+    }
+    pthread_mutex_unlock(&s_trace_event_mutex);
+}
+
+void trace_event_begin(const char *name, const char *category)
+{
+    if(!g_trace_event_enabled)
+        return;
+
+    write_event(name, category, 'B');
+}
+
+void trace_event_end(const char *name, const char *category)
+{
+    if(!g_trace_event_enabled)
+        return;
+
+    write_event(name, category, 'E');
+}
+
+void trace_event_counter(const char *name, const char *series, unsigned long long value)
+{
+    if(!g_trace_event_enabled)
+        return;
+
+    pthread_mutex_lock(&s_trace_event_mutex);
+    write_counter(name, series, value);
+    pthread_mutex_unlock(&s_trace_event_mutex);
+}
+
+void trace_event_count_bytes(bool output, int len)
+{
+    if(!g_trace_event_enabled || (len <= 0))
+        return;
+
+    pthread_mutex_lock(&s_trace_event_mutex);
+    if(output)
+    {
+        s_bytes_out += len;
+        write_counter("hidraw_bytes_out", "bytes", s_bytes_out);
+    }
+    else
+    {
+        s_bytes_in += len;
+        write_counter("hidraw_bytes_in", "bytes", s_bytes_in);
+    }
+    pthread_mutex_unlock(&s_trace_event_mutex);
+}
+
+int trace_usleep(unsigned int usec)
+{
+    int ret = 0;
+
+    // Bus-Idle Wait, Give the I2C Adapter to Other Panels
+    hidraw_bus_release();
+
+    if(!g_trace_event_enabled)
+        return usleep(usec);
+
+    // Never Sleep with the Lock Held
+    pthread_mutex_lock(&s_trace_event_mutex);
+    if(s_trace_event_file)
+    {
+        write_event_head("usleep", TRACE_CATEGORY_SLEEP, 'B');
+        fprintf(s_trace_event_file, ",\"args\":{\"usec\":%u}}", usec);
+    }
+    pthread_mutex_unlock(&s_trace_event_mutex);
+    ret = usleep(usec);
+    trace_event_end("usleep", TRACE_CATEGORY_SLEEP);
+
+    return ret;
+}
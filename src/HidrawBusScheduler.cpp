@@ -0,0 +1,72 @@
+/** @file
+
+  Implementation of I2C Adapter Arbitration for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawBusScheduler.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <pthread.h>
+#include "HidrawBusScheduler.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+static pthread_once_t s_bus_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t s_bus_token[HIDRAW_BUS_MAX_ADAPTERS];
+
+// Per-Thread Binding
+static __thread int s_bound_bus = HIDRAW_BUS_NONE;
+static __thread bool s_token_held = false;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static void bus_token_init(void)
+{
+    int index = 0;
+
+    for(index = 0; index < HIDRAW_BUS_MAX_ADAPTERS; index++)
+        pthread_mutex_init(&s_bus_token[index], NULL);
+}
+
+void hidraw_bus_bind(int i2c_bus)
+{
+    hidraw_bus_release();
+
+    if(i2c_bus >= 0)
+        pthread_once(&s_bus_once, bus_token_init);
+
+    s_bound_bus = (i2c_bus >= 0) ? i2c_bus : HIDRAW_BUS_NONE;
+}
+
+int hidraw_bus_get_bound(void)
+{
+    return s_bound_bus;
+}
+
+void hidraw_bus_acquire(void)
+{
+    if((s_bound_bus == HIDRAW_BUS_NONE) || s_token_held)
+        return;
+
+    pthread_mutex_lock(&s_bus_token[s_bound_bus % HIDRAW_BUS_MAX_ADAPTERS]);
+    s_token_held = true;
+}
+
+void hidraw_bus_release(void)
+{
+    if(!s_token_held)
+        return;
+
+    s_token_held = false;
+    pthread_mutex_unlock(&s_bus_token[s_bound_bus % HIDRAW_BUS_MAX_ADAPTERS]);
+}
@@ -0,0 +1,218 @@
+/** @file
+
+  Implementation of hidraw Hotplug Waiting (inotify) for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawHotplug.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>			/* PATH_MAX */
+#include <fcntl.h>			/* open */
+#include <unistd.h>			/* close, read */
+#include <poll.h>
+#include <time.h>			/* clock_gettime */
+#include <dirent.h>			/* opendir, readdir */
+#include <sys/ioctl.h>
+#include <sys/inotify.h>
+#include <linux/hidraw.h>	/* HIDIOCGRAWINFO, HIDIOCGRAWPHYS */
+#include <linux/input.h>	/* BUS_I2C */
+#include "ErrCode.h"
+#include "HidrawHotplug.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+static char s_dev_dir[PATH_MAX] = HIDRAW_HOTPLUG_DEV_DIR;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+int hidraw_hotplug_set_dev_dir(const char *dev_dir)
+{
+    if((dev_dir == NULL) || (strlen(dev_dir) == 0) || (strlen(dev_dir) >= sizeof(s_dev_dir)))
+        return TP_ERR_INVALID_PARAM;
+
+    strcpy(s_dev_dir, dev_dir);
+    return TP_SUCCESS;
+}
+
+const char *hidraw_hotplug_get_dev_dir(void)
+{
+    return s_dev_dir;
+}
+
+static unsigned long long hotplug_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+// Open Node & Compare Identity, true if Wanted
+static bool match_node(const struct hidraw_hotplug_match *p_match, const char *name, char *device_path, size_t device_path_size)
+{
+    int fd = -1;
+    bool matched = false;
+    char path[PATH_MAX] = {0},
+         phys[HIDRAW_HOTPLUG_PHYS_LEN_MAX] = {0};
+    struct hidraw_devinfo info;
+
+    if(strncmp(name, "hidraw", 6) != 0)
+        return false;
+    if((p_match->name != NULL) && (strcmp(p_match->name, name) != 0))
+        return false;
+
+    snprintf(path, sizeof(path), "%s/%s", s_dev_dir, name);
+    fd = open(path, O_RDWR | O_NONBLOCK);
+    if(fd < 0) // Not Ready Yet (ex: udev Still Setting Permission), Retried on IN_ATTRIB
+        return false;
+
+    if((ioctl(fd, HIDIOCGRAWINFO, &info) < 0) || ((unsigned int)info.vendor != p_match->vid))
+        goto MATCH_NODE_CLOSE;
+
+    if((p_match->phys != NULL) && (strcmp(p_match->phys, "") != 0))
+    {
+        if(ioctl(fd, HIDIOCGRAWPHYS(sizeof(phys)), phys) < 0)
+            goto MATCH_NODE_CLOSE;
+        phys[sizeof(phys) - 1] = '\0';
+        if(strcmp(phys, p_match->phys) != 0)
+            goto MATCH_NODE_CLOSE;
+    }
+    else if(p_match->pid != 0)
+    {
+        if((unsigned int)info.product != p_match->pid)
+            goto MATCH_NODE_CLOSE;
+    }
+    else if(info.bustype != BUS_I2C)
+        goto MATCH_NODE_CLOSE;
+
+    if(snprintf(device_path, device_path_size, "%s", path) >= (int)device_path_size)
+        goto MATCH_NODE_CLOSE;
+    matched = true;
+
+MATCH_NODE_CLOSE:
+    close(fd);
+    return matched;
+}
+
+int hidraw_hotplug_get_phys(const char *device_path, char *phys, size_t phys_size)
+{
+    int fd = -1;
+
+    if((device_path == NULL) || (phys == NULL) || (phys_size == 0))
+        return TP_ERR_INVALID_PARAM;
+
+    memset(phys, 0, phys_size);
+    fd = open(device_path, O_RDWR | O_NONBLOCK);
+    if(fd < 0)
+        return TP_ERR_NOT_FOUND_DEVICE;
+
+    if(ioctl(fd, HIDIOCGRAWPHYS(phys_size), phys) < 0)
+        memset(phys, 0, phys_size);
+    phys[phys_size - 1] = '\0';
+
+    close(fd);
+    return TP_SUCCESS;
+}
+
+// Check Nodes Already Present
+static bool scan_nodes(const struct hidraw_hotplug_match *p_match, char *device_path, size_t device_path_size)
+{
+    bool found = false;
+    DIR *p_directory = NULL;
+    struct dirent *p_entry = NULL;
+
+    p_directory = opendir(s_dev_dir);
+    if(p_directory == NULL)
+        return false;
+
+    while((p_entry = readdir(p_directory)) != NULL)
+    {
+        if(match_node(p_match, p_entry->d_name, device_path, device_path_size))
+        {
+            found = true;
+            break;
+        }
+    }
+
+    closedir(p_directory);
+    return found;
+}
+
+int hidraw_hotplug_wait(const struct hidraw_hotplug_match *p_match, int timeout_ms, char *device_path, size_t device_path_size)
+{
+    int err = TP_ERR_TIMEOUT,
+        inotify_fd = -1,
+        len = 0,
+        offset = 0,
+        remaining_ms = 0;
+    unsigned long long deadline_ms = 0,
+                       now_ms = 0;
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *p_event = NULL;
+    struct pollfd poll_fd;
+
+    if((p_match == NULL) || (timeout_ms < 0) || (device_path == NULL) || (device_path_size == 0))
+        return TP_ERR_INVALID_PARAM;
+
+    deadline_ms = hotplug_now_ms() + timeout_ms;
+
+    // Watch before Scanning, so a Node Created in between is Not Missed
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(inotify_fd < 0)
+        return TP_ERR_IO_ERROR;
+    if(inotify_add_watch(inotify_fd, s_dev_dir, IN_CREATE | IN_ATTRIB | IN_MOVED_TO) < 0)
+    {
+        err = TP_ERR_NOT_FOUND_DEVICE;
+        goto HIDRAW_HOTPLUG_WAIT_EXIT;
+    }
+
+    if(scan_nodes(p_match, device_path, device_path_size))
+    {
+        err = TP_SUCCESS;
+        goto HIDRAW_HOTPLUG_WAIT_EXIT;
+    }
+
+    while(true)
+    {
+        now_ms = hotplug_now_ms();
+        if(now_ms >= deadline_ms)
+        {
+            err = TP_ERR_TIMEOUT;
+            break;
+        }
+        remaining_ms = (int)(deadline_ms - now_ms);
+
+        poll_fd.fd = inotify_fd;
+        poll_fd.events = POLLIN;
+        poll_fd.revents = 0;
+        if(poll(&poll_fd, 1, remaining_ms) <= 0)
+            continue; // Timeout (Checked Above) or Signal
+
+        len = read(inotify_fd, events, sizeof(events));
+        for(offset = 0; offset < len; offset += sizeof(struct inotify_event) + p_event->len)
+        {
+            p_event = (const struct inotify_event *)&events[offset];
+            if((p_event->len > 0) && match_node(p_match, p_event->name, device_path, device_path_size))
+            {
+                err = TP_SUCCESS;
+                goto HIDRAW_HOTPLUG_WAIT_EXIT;
+            }
+        }
+    }
+
+HIDRAW_HOTPLUG_WAIT_EXIT:
+    close(inotify_fd);
+    return err;
+}
@@ -0,0 +1,320 @@
+/** @file
+
+  Implementation of hidraw Transport Latency Statistics for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawLatencyStats.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <string.h>
+#include <time.h>		/* clock_gettime */
+#include "HidrawLatencyStats.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Largest Value Must Fit the Last Bucket
+typedef char latency_histogram_range_check[(LATENCY_HISTOGRAM_MAX_EXP < 64) ? 1 : -1];
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::CLatencyHistogram()
+
+CLatencyHistogram::CLatencyHistogram(void)
+{
+    Reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::Reset()
+
+void CLatencyHistogram::Reset(void)
+{
+    memset(m_nCounts, 0, sizeof(m_nCounts));
+    m_ullCount = 0;
+    m_ullSum = 0;
+    m_ullMax = 0;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::BucketIndex()
+
+int CLatencyHistogram::BucketIndex(unsigned long long ullValueUs)
+{
+    int nMsb = 0,
+        nShift = 0;
+
+    if(ullValueUs < LATENCY_HISTOGRAM_SUB_COUNT)
+        return (int)ullValueUs;
+
+    if(ullValueUs >= (1ULL << LATENCY_HISTOGRAM_MAX_EXP))
+        ullValueUs = (1ULL << LATENCY_HISTOGRAM_MAX_EXP) - 1;
+
+    nMsb = 63 - __builtin_clzll(ullValueUs);
+    nShift = nMsb - LATENCY_HISTOGRAM_SUB_BITS;
+
+    // Sub-Bucket is the SUB_BITS Bits Below the MSB
+    return LATENCY_HISTOGRAM_SUB_COUNT * (nShift + 1) + (int)((ullValueUs >> nShift) - LATENCY_HISTOGRAM_SUB_COUNT);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::BucketUpperBound()
+
+unsigned long long CLatencyHistogram::BucketUpperBound(int nIndex)
+{
+    int nShift = 0;
+    unsigned long long ullMantissa = 0;
+
+    if(nIndex < LATENCY_HISTOGRAM_SUB_COUNT)
+        return (nIndex < 0) ? 0 : (unsigned long long)nIndex;
+
+    nShift = (nIndex / LATENCY_HISTOGRAM_SUB_COUNT) - 1;
+    ullMantissa = LATENCY_HISTOGRAM_SUB_COUNT + (nIndex % LATENCY_HISTOGRAM_SUB_COUNT);
+
+    return ((ullMantissa + 1) << nShift) - 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::Record()
+
+void CLatencyHistogram::Record(unsigned long long ullValueUs)
+{
+    unsigned long long ullMax = m_ullMax;
+
+    __sync_fetch_and_add(&m_nCounts[BucketIndex(ullValueUs)], 1);
+    __sync_fetch_and_add(&m_ullSum, ullValueUs);
+    __sync_fetch_and_add(&m_ullCount, 1);
+
+    while(ullValueUs > ullMax)
+    {
+        if(__sync_bool_compare_and_swap(&m_ullMax, ullMax, ullValueUs))
+            break;
+        ullMax = m_ullMax;
+    }
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::GetCount() / GetMax() / GetSum()
+
+unsigned long long CLatencyHistogram::GetCount(void) const
+{
+    return m_ullCount;
+}
+
+unsigned long long CLatencyHistogram::GetMax(void) const
+{
+    return m_ullMax;
+}
+
+unsigned long long CLatencyHistogram::GetSum(void) const
+{
+    return m_ullSum;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CLatencyHistogram::GetPercentile()
+
+unsigned long long CLatencyHistogram::GetPercentile(double dPercentile) const
+{
+    int nIndex = 0;
+    unsigned long long ullTotal = 0,
+                       ullTarget = 0,
+                       ullSeen = 0,
+                       ullValue = 0;
+
+    for(nIndex = 0; nIndex < LATENCY_HISTOGRAM_BUCKET_COUNT; nIndex++)
+        ullTotal += m_nCounts[nIndex];
+    if(ullTotal == 0)
+        return 0;
+
+    // Rank of the Percentile (1-Based, Rounded Up)
+    ullTarget = (unsigned long long)((ullTotal * dPercentile) / 100.0);
+    if((double)ullTarget < (ullTotal * dPercentile) / 100.0)
+        ullTarget++;
+    if(ullTarget == 0)
+        ullTarget = 1;
+
+    for(nIndex = 0; nIndex < LATENCY_HISTOGRAM_BUCKET_COUNT; nIndex++)
+    {
+        ullSeen += m_nCounts[nIndex];
+        if(ullSeen >= ullTarget)
+            break;
+    }
+
+    ullValue = BucketUpperBound(nIndex);
+    return (ullValue < m_ullMax) ? ullValue : m_ullMax;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::CHidrawLatencyStats()
+
+CHidrawLatencyStats::CHidrawLatencyStats(void)
+{
+    int nOpcode = 0;
+
+    for(nOpcode = 0; nOpcode < HIDRAW_LATENCY_OPCODE_COUNT; nOpcode++)
+        m_pOpcodeStats[nOpcode] = NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::~CHidrawLatencyStats()
+
+CHidrawLatencyStats::~CHidrawLatencyStats(void)
+{
+    int nOpcode = 0;
+
+    for(nOpcode = 0; nOpcode < HIDRAW_LATENCY_OPCODE_COUNT; nOpcode++)
+    {
+        delete m_pOpcodeStats[nOpcode];
+        m_pOpcodeStats[nOpcode] = NULL;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::NowNs()
+
+unsigned long long CHidrawLatencyStats::NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::GetOpcode()
+// Byte 3 is a data offset in vendor frames, so it only keys bridge commands
+
+int CHidrawLatencyStats::GetOpcode(const unsigned char *pbyReport, int nLen)
+{
+    if (nLen <= HIDRAW_LATENCY_VENDOR_OPCODE_OFFSET)
+        return -1;
+
+    if (pbyReport[HIDRAW_LATENCY_VENDOR_OPCODE_OFFSET] != 0x00) // Vendor Command
+        return pbyReport[HIDRAW_LATENCY_VENDOR_OPCODE_OFFSET];
+
+    return (nLen > HIDRAW_LATENCY_OPCODE_OFFSET) ? pbyReport[HIDRAW_LATENCY_OPCODE_OFFSET] : -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::GetOrCreate()
+
+struct CHidrawLatencyStats::opcode_stats *CHidrawLatencyStats::GetOrCreate(unsigned char byOpcode)
+{
+    struct opcode_stats *pStats = m_pOpcodeStats[byOpcode];
+
+    if(pStats != NULL)
+        return pStats;
+
+    pStats = new opcode_stats;
+    pStats->timeouts = 0;
+
+    // Lost the Race => Use the Published Entry
+    if(!__sync_bool_compare_and_swap(&m_pOpcodeStats[byOpcode], (struct opcode_stats *)NULL, pStats))
+    {
+        delete pStats;
+        pStats = m_pOpcodeStats[byOpcode];
+    }
+
+    return pStats;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::RecordWrite() / RecordResponse() / RecordTimeout()
+
+void CHidrawLatencyStats::RecordWrite(unsigned char byOpcode, unsigned long long ullLatencyNs)
+{
+    GetOrCreate(byOpcode)->write.Record(ullLatencyNs / 1000ULL);
+    return;
+}
+
+void CHidrawLatencyStats::RecordResponse(unsigned char byOpcode, unsigned long long ullLatencyNs)
+{
+    GetOrCreate(byOpcode)->response.Record(ullLatencyNs / 1000ULL);
+    return;
+}
+
+void CHidrawLatencyStats::RecordTimeout(unsigned char byOpcode)
+{
+    __sync_fetch_and_add(&GetOrCreate(byOpcode)->timeouts, 1);
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::Reset()
+
+void CHidrawLatencyStats::Reset(void)
+{
+    int nOpcode = 0;
+    struct opcode_stats *pStats = NULL;
+
+    for(nOpcode = 0; nOpcode < HIDRAW_LATENCY_OPCODE_COUNT; nOpcode++)
+    {
+        pStats = m_pOpcodeStats[nOpcode];
+        if(pStats == NULL)
+            continue;
+        pStats->write.Reset();
+        pStats->response.Reset();
+        pStats->timeouts = 0;
+    }
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::GetOpcodeStats()
+
+const struct CHidrawLatencyStats::opcode_stats *CHidrawLatencyStats::GetOpcodeStats(unsigned char byOpcode) const
+{
+    return m_pOpcodeStats[byOpcode];
+}
+
+// One Row of Latency Table (ms)
+static void print_histogram_row(FILE *pStream, int nOpcode, const char *pszKind, const CLatencyHistogram &histogram, unsigned long long ullTimeouts)
+{
+    fprintf(pStream, "0x%02x   %-9s %8llu %10.3f %10.3f %10.3f %10.3f %9llu\r\n", nOpcode, pszKind, histogram.GetCount(),
+            histogram.GetPercentile(50.0) / 1000.0, histogram.GetPercentile(90.0) / 1000.0,
+            histogram.GetPercentile(99.0) / 1000.0, histogram.GetMax() / 1000.0, ullTimeouts);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawLatencyStats::PrintSummary()
+
+void CHidrawLatencyStats::PrintSummary(FILE *pStream) const
+{
+    int nOpcode = 0;
+    const struct opcode_stats *pStats = NULL;
+
+    if(pStream == NULL)
+        return;
+
+    fprintf(pStream, "--------------------------------\r\n");
+    fprintf(pStream, "[hidraw Latency]\r\n");
+    fprintf(pStream, "%-6s %-9s %8s %10s %10s %10s %10s %9s\r\n", "opcode", "kind", "count", "p50(ms)", "p90(ms)", "p99(ms)", "max(ms)", "timeouts");
+    for(nOpcode = 0; nOpcode < HIDRAW_LATENCY_OPCODE_COUNT; nOpcode++)
+    {
+        pStats = m_pOpcodeStats[nOpcode];
+        if(pStats == NULL)
+            continue;
+        if(pStats->write.GetCount() > 0)
+            print_histogram_row(pStream, nOpcode, "write", pStats->write, 0);
+        if((pStats->response.GetCount() > 0) || (pStats->timeouts > 0))
+            print_histogram_row(pStream, nOpcode, "response", pStats->response, pStats->timeouts);
+    }
+
+    return;
+}
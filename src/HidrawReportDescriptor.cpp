@@ -0,0 +1,225 @@
+/** @file
+
+  Implementation of HID Report Descriptor Parser for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawReportDescriptor.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <string.h>
+#include "ErrCode.h"
+#include "HidrawReportDescriptor.h"
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Item Types & Tags (HID 1.11, 6.2.2)
+#define HID_ITEM_TYPE_MAIN				0
+#define HID_ITEM_TYPE_GLOBAL			1
+#define HID_ITEM_TYPE_LOCAL				2
+#define HID_ITEM_LONG_PREFIX			0xFE
+
+#define HID_MAIN_TAG_INPUT				0x8
+#define HID_MAIN_TAG_OUTPUT				0x9
+#define HID_MAIN_TAG_FEATURE			0xB
+
+#define HID_GLOBAL_TAG_USAGE_PAGE		0x0
+#define HID_GLOBAL_TAG_REPORT_SIZE		0x7
+#define HID_GLOBAL_TAG_REPORT_ID		0x8
+#define HID_GLOBAL_TAG_REPORT_COUNT		0x9
+#define HID_GLOBAL_TAG_PUSH				0xA
+#define HID_GLOBAL_TAG_POP				0xB
+
+#define HID_USAGE_PAGE_VENDOR_MIN		0xFF00
+
+// Depth of Push / Pop
+#define HID_GLOBAL_STACK_DEPTH			4
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+// Global Item State
+struct hid_global_state
+{
+    unsigned int usage_page;
+    unsigned int report_size;
+    unsigned int report_count;
+    int report_id;
+};
+
+// Bit Length Accumulated per Report
+struct hid_report_bits
+{
+    int type;
+    int report_id;
+    unsigned int bits;
+    bool vendor;
+};
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static unsigned int item_data(const unsigned char *p_data, int data_len)
+{
+    unsigned int value = 0;
+    int index = 0;
+
+    for(index = data_len - 1; index >= 0; index--)
+        value = (value << 8) | p_data[index];
+
+    return value;
+}
+
+static void add_field(struct hid_report_bits *p_bits, int *p_bits_count, int type, const struct hid_global_state *p_state)
+{
+    int index = 0;
+
+    for(index = 0; index < *p_bits_count; index++)
+    {
+        if((p_bits[index].type == type) && (p_bits[index].report_id == p_state->report_id))
+            break;
+    }
+
+    if(index == *p_bits_count)
+    {
+        if(*p_bits_count >= HIDRAW_RDESC_MAX_REPORTS)
+            return;
+        memset(&p_bits[index], 0, sizeof(p_bits[index]));
+        p_bits[index].type = type;
+        p_bits[index].report_id = p_state->report_id;
+        (*p_bits_count)++;
+    }
+
+    p_bits[index].bits += p_state->report_size * p_state->report_count;
+    if(p_state->usage_page >= HID_USAGE_PAGE_VENDOR_MIN)
+        p_bits[index].vendor = true;
+}
+
+int hidraw_rdesc_parse(const unsigned char *p_desc, int desc_len, struct hidraw_report_layout *p_layout)
+{
+    int offset = 0,
+        data_len = 0,
+        item_type = 0,
+        item_tag = 0,
+        stack_depth = 0,
+        bits_count = 0,
+        index = 0;
+    unsigned int value = 0;
+    struct hid_global_state state,
+                            stack[HID_GLOBAL_STACK_DEPTH];
+    struct hid_report_bits bits[HIDRAW_RDESC_MAX_REPORTS];
+
+    if((p_desc == NULL) || (desc_len <= 0) || (p_layout == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    memset(&state, 0, sizeof(state));
+    memset(p_layout, 0, sizeof(*p_layout));
+
+    while(offset < desc_len)
+    {
+        // Long Item: | 0xFE | bDataSize | bLongItemTag | data |
+        if(p_desc[offset] == HID_ITEM_LONG_PREFIX)
+        {
+            if(offset + 2 >= desc_len)
+                return TP_ERR_DATA_PATTERN;
+            offset += 3 + p_desc[offset + 1];
+            continue;
+        }
+
+        // Short Item: | bTag (4) | bType (2) | bSize (2) | data (0, 1, 2 or 4 bytes) |
+        data_len = p_desc[offset] & 0x3;
+        if(data_len == 3)
+            data_len = 4;
+        item_type = (p_desc[offset] >> 2) & 0x3;
+        item_tag = (p_desc[offset] >> 4) & 0xF;
+        if(offset + 1 + data_len > desc_len)
+            return TP_ERR_DATA_PATTERN;
+        value = item_data(&p_desc[offset + 1], data_len);
+        offset += 1 + data_len;
+
+        if(item_type == HID_ITEM_TYPE_GLOBAL)
+        {
+            switch(item_tag)
+            {
+                case HID_GLOBAL_TAG_USAGE_PAGE:
+                    state.usage_page = value;
+                    break;
+                case HID_GLOBAL_TAG_REPORT_SIZE:
+                    state.report_size = value;
+                    break;
+                case HID_GLOBAL_TAG_REPORT_ID:
+                    state.report_id = (int)value;
+                    break;
+                case HID_GLOBAL_TAG_REPORT_COUNT:
+                    state.report_count = value;
+                    break;
+                case HID_GLOBAL_TAG_PUSH:
+                    if(stack_depth < HID_GLOBAL_STACK_DEPTH)
+                        stack[stack_depth++] = state;
+                    break;
+                case HID_GLOBAL_TAG_POP:
+                    if(stack_depth > 0)
+                        state = stack[--stack_depth];
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if(item_type == HID_ITEM_TYPE_MAIN)
+        {
+            if(item_tag == HID_MAIN_TAG_INPUT)
+                add_field(bits, &bits_count, HIDRAW_REPORT_TYPE_INPUT, &state);
+            else if(item_tag == HID_MAIN_TAG_OUTPUT)
+                add_field(bits, &bits_count, HIDRAW_REPORT_TYPE_OUTPUT, &state);
+            else if(item_tag == HID_MAIN_TAG_FEATURE)
+                add_field(bits, &bits_count, HIDRAW_REPORT_TYPE_FEATURE, &state);
+        }
+    }
+
+    for(index = 0; index < bits_count; index++)
+    {
+        p_layout->reports[index].type = bits[index].type;
+        p_layout->reports[index].report_id = bits[index].report_id;
+        p_layout->reports[index].size = (bits[index].bits + 7) / 8;
+        p_layout->reports[index].vendor = bits[index].vendor;
+    }
+    p_layout->report_count = bits_count;
+
+    return TP_SUCCESS;
+}
+
+const struct hidraw_report_info *hidraw_rdesc_find(const struct hidraw_report_layout *p_layout, int type, int report_id)
+{
+    int index = 0;
+    const struct hidraw_report_info *p_found = NULL;
+
+    if(p_layout == NULL)
+        return NULL;
+
+    for(index = 0; index < p_layout->report_count; index++)
+    {
+        const struct hidraw_report_info *p_report = &p_layout->reports[index];
+
+        if(p_report->type != type)
+            continue;
+
+        if(report_id != HIDRAW_RDESC_ANY_REPORT_ID)
+        {
+            if(p_report->report_id == report_id)
+                return p_report;
+        }
+        else if(p_report->vendor && ((p_found == NULL) || (p_report->size > p_found->size)))
+            p_found = p_report;
+    }
+
+    return p_found;
+}
@@ -0,0 +1,154 @@
+/** @file
+
+  Implementation of hidraw Response Correlation for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawResponseMatcher.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <string.h>
+#include "HidrawLatencyStats.h"	/* NowNs */
+#include "HidrawResponseMatcher.h"
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::CHidrawResponseQueue()
+
+CHidrawResponseQueue::CHidrawResponseQueue(void)
+{
+    Clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::Clear()
+
+void CHidrawResponseQueue::Clear(void)
+{
+    m_nHead = 0;
+    m_nCount = 0;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::GetCount()
+
+int CHidrawResponseQueue::GetCount(void) const
+{
+    return m_nCount;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::Match()
+// pbyReport includes the 2-byte report header
+
+bool CHidrawResponseQueue::Match(const struct hidraw_response_pattern *pPattern, const unsigned char *pbyReport, int nLen)
+{
+    int nIndex = 0;
+
+    if ((pPattern == NULL) || (pPattern->length <= 0))
+        return true;
+
+    if ((pPattern->length > HIDRAW_RESPONSE_PATTERN_LEN_MAX) || (nLen < HIDRAW_RESPONSE_DATA_OFFSET + pPattern->length))
+        return false;
+
+    for (nIndex = 0; nIndex < pPattern->length; nIndex++)
+    {
+        if ((pbyReport[HIDRAW_RESPONSE_DATA_OFFSET + nIndex] & pPattern->mask[nIndex]) != pPattern->value[nIndex])
+            return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::DropStale()
+// Reports arrive in order, so stale ones are always at the head
+
+void CHidrawResponseQueue::DropStale(void)
+{
+    unsigned long long ullNowNs = CHidrawLatencyStats::NowNs();
+
+    while ((m_nCount > 0) && (ullNowNs - m_reports[m_nHead].ullTimeNs >= HIDRAW_RESPONSE_STALE_MSEC * 1000000ULL))
+    {
+        m_nHead = (m_nHead + 1) % HIDRAW_RESPONSE_QUEUE_SIZE;
+        m_nCount--;
+    }
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::Push()
+
+void CHidrawResponseQueue::Push(const unsigned char *pbyReport, int nLen)
+{
+    struct queued_report *pReport = NULL;
+
+    if ((pbyReport == NULL) || (nLen <= 0))
+        return;
+
+    DropStale();
+
+    // Full, the oldest report gives way
+    if (m_nCount == HIDRAW_RESPONSE_QUEUE_SIZE)
+    {
+        m_nHead = (m_nHead + 1) % HIDRAW_RESPONSE_QUEUE_SIZE;
+        m_nCount--;
+    }
+
+    pReport = &m_reports[(m_nHead + m_nCount) % HIDRAW_RESPONSE_QUEUE_SIZE];
+    pReport->ullTimeNs = CHidrawLatencyStats::NowNs();
+    pReport->nLen = (nLen <= HIDRAW_RESPONSE_REPORT_LEN_MAX) ? nLen : HIDRAW_RESPONSE_REPORT_LEN_MAX;
+    memcpy(pReport->data, pbyReport, pReport->nLen);
+    m_nCount++;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawResponseQueue::Take()
+
+bool CHidrawResponseQueue::Take(const struct hidraw_response_pattern *pPattern, unsigned char *pbyReport, int nLen)
+{
+    int nIndex = 0,
+        nSlot = 0,
+        nNext = 0;
+
+    if ((pbyReport == NULL) || (nLen <= 0))
+        return false;
+
+    DropStale();
+
+    for (nIndex = 0; nIndex < m_nCount; nIndex++)
+    {
+        nSlot = (m_nHead + nIndex) % HIDRAW_RESPONSE_QUEUE_SIZE;
+        if (!Match(pPattern, m_reports[nSlot].data, m_reports[nSlot].nLen))
+            continue;
+
+        memset(pbyReport, 0, nLen);
+        memcpy(pbyReport, m_reports[nSlot].data, (nLen <= m_reports[nSlot].nLen) ? nLen : m_reports[nSlot].nLen);
+
+        // Close the gap, keeping arrival order
+        for (; nIndex < m_nCount - 1; nIndex++)
+        {
+            nSlot = (m_nHead + nIndex) % HIDRAW_RESPONSE_QUEUE_SIZE;
+            nNext = (nSlot + 1) % HIDRAW_RESPONSE_QUEUE_SIZE;
+            m_reports[nSlot] = m_reports[nNext];
+        }
+        m_nCount--;
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,290 @@
+/** @file
+
+  Implementation of hidraw sysfs Lookup for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawSysfs.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>		/* realpath, strtol */
+#include <string.h>
+#include <limits.h>		/* PATH_MAX */
+#include <dirent.h>		/* opendir, readdir */
+#include <time.h>		/* clock_gettime */
+#include <pthread.h>
+#include <linux/input.h>	/* BUS_I2C */
+#include "ErrCode.h"
+#include "HidrawSysfs.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Discovery Cache
+static struct hidraw_sysfs_info s_cache_nodes[HIDRAW_SYSFS_MAX_NODES];
+static int s_cache_count = 0;
+static bool s_cache_valid = false;
+static unsigned long long s_cache_time_ns = 0;
+static pthread_mutex_t s_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static unsigned long long sysfs_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Number N of the Last "i2c-N" Component, -1 if None
+static int parse_i2c_bus(const char *device_path)
+{
+    int i2c_bus = -1;
+    long value = 0;
+    const char *p_component = device_path;
+    char *p_end = NULL;
+
+    while((p_component = strstr(p_component, "/i2c-")) != NULL)
+    {
+        p_component += strlen("/i2c-");
+        value = strtol(p_component, &p_end, 10);
+        if((p_end != p_component) && ((*p_end == '/') || (*p_end == '\0')))
+            i2c_bus = (int)value;
+    }
+
+    return i2c_bus;
+}
+
+// id/version of the First Input Device under hidraw Node, 0 if None
+static unsigned int read_input_version(const char *hidraw_name)
+{
+    unsigned int version = 0;
+    char path[PATH_MAX] = {0};
+    DIR *p_directory = NULL;
+    struct dirent *p_entry = NULL;
+    FILE *p_file = NULL;
+
+    snprintf(path, sizeof(path), "%s/%s/device/input", HIDRAW_SYSFS_CLASS_DIR, hidraw_name);
+    p_directory = opendir(path);
+    if(p_directory == NULL)
+        return 0;
+
+    while((p_entry = readdir(p_directory)) != NULL)
+    {
+        if(strncmp(p_entry->d_name, "input", 5) != 0)
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s/device/input/%s/id/version", HIDRAW_SYSFS_CLASS_DIR, hidraw_name, p_entry->d_name);
+        p_file = fopen(path, "r");
+        if(p_file == NULL)
+            continue;
+        if(fscanf(p_file, "%x", &version) != 1)
+            version = 0;
+        fclose(p_file);
+        break;
+    }
+
+    closedir(p_directory);
+    return version;
+}
+
+int hidraw_sysfs_get_info(const char *hidraw_name, struct hidraw_sysfs_info *p_info)
+{
+    int err = TP_SUCCESS;
+    const char *p_name = NULL;
+    char path[PATH_MAX] = {0},
+         device_path[PATH_MAX] = {0},
+         line[128] = {0};
+    FILE *p_file = NULL;
+    bool found = false;
+
+    if((hidraw_name == NULL) || (p_info == NULL))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto HIDRAW_SYSFS_GET_INFO_EXIT;
+    }
+
+    // "/dev/hidraw3" => "hidraw3"
+    p_name = strrchr(hidraw_name, '/');
+    p_name = (p_name) ? p_name + 1 : hidraw_name;
+    if((strncmp(p_name, "hidraw", 6) != 0) || (strlen(p_name) >= sizeof(p_info->name)))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto HIDRAW_SYSFS_GET_INFO_EXIT;
+    }
+
+    memset(p_info, 0, sizeof(*p_info));
+    strcpy(p_info->name, p_name);
+
+    // HID_ID=0018:000004F3:00002A03
+    snprintf(path, sizeof(path), "%s/%s/device/uevent", HIDRAW_SYSFS_CLASS_DIR, p_name);
+    p_file = fopen(path, "r");
+    if(p_file == NULL)
+    {
+        err = TP_ERR_NOT_FOUND_DEVICE;
+        goto HIDRAW_SYSFS_GET_INFO_EXIT;
+    }
+    while(fgets(line, sizeof(line), p_file) != NULL)
+    {
+        if(sscanf(line, "HID_ID=%x:%x:%x", &p_info->bus_type, &p_info->vid, &p_info->pid) == 3)
+        {
+            found = true;
+            break;
+        }
+    }
+    fclose(p_file);
+    if(found == false)
+    {
+        err = TP_ERR_NOT_FOUND_DEVICE;
+        goto HIDRAW_SYSFS_GET_INFO_EXIT;
+    }
+
+    // Parent Adapter, ex: /sys/devices/.../i2c-1/i2c-ELAN9008:00/0018:04F3:2A03.0001
+    p_info->i2c_bus = -1;
+    snprintf(path, sizeof(path), "%s/%s/device", HIDRAW_SYSFS_CLASS_DIR, p_name);
+    if(realpath(path, device_path) != NULL)
+        p_info->i2c_bus = parse_i2c_bus(device_path);
+
+    // HID Version, Only Exposed through the Input Device (if hid-multitouch / hid-generic Bound One)
+    p_info->version = read_input_version(p_name);
+
+    // Success
+    err = TP_SUCCESS;
+
+HIDRAW_SYSFS_GET_INFO_EXIT:
+    return err;
+}
+
+// Walk HIDRAW_SYSFS_CLASS_DIR into the Cache (Caller Holds s_cache_mutex)
+static int refresh_cache(void)
+{
+    DIR *p_directory = NULL;
+    struct dirent *p_entry = NULL;
+
+    p_directory = opendir(HIDRAW_SYSFS_CLASS_DIR);
+    if(p_directory == NULL)
+        return TP_ERR_NOT_FOUND_DEVICE;
+
+    s_cache_count = 0;
+    while(((p_entry = readdir(p_directory)) != NULL) && (s_cache_count < HIDRAW_SYSFS_MAX_NODES))
+    {
+        if(hidraw_sysfs_get_info(p_entry->d_name, &s_cache_nodes[s_cache_count]) == TP_SUCCESS)
+            s_cache_count++;
+    }
+    closedir(p_directory);
+
+    s_cache_valid = true;
+    s_cache_time_ns = sysfs_now_ns();
+    return TP_SUCCESS;
+}
+
+int hidraw_sysfs_scan(struct hidraw_sysfs_info *p_list, int list_size, int *p_count)
+{
+    int err = TP_SUCCESS;
+
+    if((p_list == NULL) || (list_size <= 0) || (p_count == NULL))
+        return TP_ERR_INVALID_PARAM;
+
+    pthread_mutex_lock(&s_cache_mutex);
+
+    if(!s_cache_valid || (sysfs_now_ns() - s_cache_time_ns >= HIDRAW_SYSFS_CACHE_MSEC * 1000000ULL))
+    {
+        err = refresh_cache();
+        if(err != TP_SUCCESS)
+            goto HIDRAW_SYSFS_SCAN_UNLOCK;
+    }
+
+    *p_count = (s_cache_count < list_size) ? s_cache_count : list_size;
+    memcpy(p_list, s_cache_nodes, *p_count * sizeof(struct hidraw_sysfs_info));
+
+    // Success
+    err = TP_SUCCESS;
+
+HIDRAW_SYSFS_SCAN_UNLOCK:
+    pthread_mutex_unlock(&s_cache_mutex);
+    return err;
+}
+
+void hidraw_sysfs_invalidate(void)
+{
+    pthread_mutex_lock(&s_cache_mutex);
+    s_cache_valid = false;
+    pthread_mutex_unlock(&s_cache_mutex);
+}
+
+int hidraw_sysfs_find(unsigned int vid, unsigned int pid, int i2c_bus, char *device_path, size_t device_path_size)
+{
+    int err = TP_ERR_NOT_FOUND_DEVICE,
+        index = 0,
+        count = 0;
+    struct hidraw_sysfs_info nodes[HIDRAW_SYSFS_MAX_NODES],
+                             *p_info = NULL;
+
+    if((device_path == NULL) || (device_path_size == 0))
+        return TP_ERR_INVALID_PARAM;
+
+    if(hidraw_sysfs_scan(nodes, HIDRAW_SYSFS_MAX_NODES, &count) != TP_SUCCESS)
+        return TP_ERR_NOT_FOUND_DEVICE;
+
+    for(index = 0; index < count; index++)
+    {
+        p_info = &nodes[index];
+
+        if(p_info->vid != vid)
+            continue;
+        if((pid != 0) && (p_info->pid != pid))
+            continue;
+        if((pid == 0) && (p_info->bus_type != BUS_I2C)) // Same Rule as Force-Connect PID of FindHidrawDevice()
+            continue;
+        if((i2c_bus != HIDRAW_ANY_I2C_BUS) && (p_info->i2c_bus != i2c_bus))
+            continue;
+
+        if(snprintf(device_path, device_path_size, "/dev/%s", p_info->name) >= (int)device_path_size)
+            err = TP_ERR_INVALID_PARAM;
+        else
+            err = TP_SUCCESS;
+        break;
+    }
+
+    return err;
+}
+
+int hidraw_sysfs_resolve_selector(unsigned int vid, const char *selector, char *device_path, size_t device_path_size)
+{
+    int i2c_bus = HIDRAW_ANY_I2C_BUS;
+    long pid = 0;
+    char *p_end = NULL;
+
+    if((selector == NULL) || (device_path == NULL) || (device_path_size == 0))
+        return TP_ERR_INVALID_PARAM;
+
+    if(selector[0] == '/')
+    {
+        if(snprintf(device_path, device_path_size, "%s", selector) >= (int)device_path_size)
+            return TP_ERR_INVALID_PARAM;
+        return TP_SUCCESS;
+    }
+
+    pid = strtol(selector, &p_end, 16);
+    if((p_end == selector) || (pid < 0) || (pid > 0xFFFF))
+        return TP_ERR_INVALID_PARAM;
+    if(*p_end == '@')
+    {
+        if(sscanf(p_end, "@i2c-%d", &i2c_bus) != 1)
+            return TP_ERR_INVALID_PARAM;
+    }
+    else if(*p_end != '\0')
+        return TP_ERR_INVALID_PARAM;
+
+    return hidraw_sysfs_find(vid, (unsigned int)pid, i2c_bus, device_path, device_path_size);
+}
@@ -0,0 +1,593 @@
+/** @file
+
+  Implementation of Binary hidraw Trace for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawTrace.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+**/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>		/* clock_gettime */
+#include <fcntl.h>		/* open */
+#include <unistd.h>		/* write, close */
+#include <errno.h>		/* errno */
+#include <signal.h>		/* sigaction */
+#include <pthread.h>	/* pthread_mutex */
+#include "HidrawTrace.h"
+
+/***************************************************
+ * Global Variable Declaration
+ ***************************************************/
+
+// Fatal Signals Hooked by Flight Recorder
+// (No SIGINT / SIGTERM: termination belongs to the application, not the library.)
+static const int s_flight_recorder_signals[] = { SIGSEGV, SIGBUS, SIGABRT };
+
+#define FLIGHT_RECORDER_SIGNAL_COUNT	(int)(sizeof(s_flight_recorder_signals) / sizeof(s_flight_recorder_signals[0]))
+
+// Recorders Dumped by Fatal Signal Handler (Slots Guarded by s_flight_recorder_mutex)
+static CHidrawFlightRecorder * volatile s_p_live_flight_recorders[HIDRAW_FLIGHT_RECORDER_MAX_LIVE] = {NULL};
+static int s_live_flight_recorder_count = 0;
+static pthread_mutex_t s_flight_recorder_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Actions Replaced by the Handler, Restored When the Last Recorder Goes
+static struct sigaction s_flight_recorder_previous_actions[FLIGHT_RECORDER_SIGNAL_COUNT];
+
+// Slot Index is Masked, so Flight Recorder Depth Must be Power of 2
+typedef char flight_recorder_depth_check[((HIDRAW_FLIGHT_RECORDER_DEPTH & (HIDRAW_FLIGHT_RECORDER_DEPTH - 1)) == 0) ? 1 : -1];
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static void put_le16(unsigned char *p_buf, unsigned int value)
+{
+    p_buf[0] = (unsigned char)value;
+    p_buf[1] = (unsigned char)(value >> 8);
+}
+
+static void put_le64(unsigned char *p_buf, unsigned long long value)
+{
+    int index = 0;
+
+    for(index = 0; index < 8; index++)
+        p_buf[index] = (unsigned char)(value >> (8 * index));
+}
+
+static unsigned int get_le16(const unsigned char *p_buf)
+{
+    return p_buf[0] | ((unsigned int)p_buf[1] << 8);
+}
+
+static unsigned long long get_le64(const unsigned char *p_buf)
+{
+    unsigned long long value = 0;
+    int index = 0;
+
+    for(index = 7; index >= 0; index--)
+        value = (value << 8) | p_buf[index];
+    return value;
+}
+
+static unsigned long long monotonic_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void encode_file_header(unsigned char *p_header)
+{
+    memset(p_header, 0, HIDRAW_TRACE_FILE_HEADER_SIZE);
+    memcpy(p_header, HIDRAW_TRACE_MAGIC, HIDRAW_TRACE_MAGIC_LEN);
+    put_le16(&p_header[8], HIDRAW_TRACE_VERSION);
+    put_le16(&p_header[10], HIDRAW_TRACE_FILE_HEADER_SIZE);
+    put_le16(&p_header[12], HIDRAW_TRACE_RECORD_HEADER_SIZE);
+}
+
+// Encode One Record to p_dest (Room for Header + length Bytes), Return Encoded Size
+static unsigned int encode_record(unsigned char *p_dest, unsigned long long timestamp_ns, int direction, const unsigned char *p_buf, unsigned int length)
+{
+    unsigned int stored = length;
+
+    // Strip Trailing Zero Bytes
+    while((stored > 0) && (p_buf[stored - 1] == 0))
+        stored--;
+
+    put_le64(&p_dest[0], timestamp_ns);
+    put_le16(&p_dest[8], length | ((direction == HIDRAW_TRACE_DIR_INPUT) ? HIDRAW_TRACE_DIR_INPUT_FLAG : 0));
+    put_le16(&p_dest[10], stored);
+    memcpy(&p_dest[HIDRAW_TRACE_RECORD_HEADER_SIZE], p_buf, stored);
+
+    return HIDRAW_TRACE_RECORD_HEADER_SIZE + stored;
+}
+
+// write() All Bytes, Retry on EINTR (Async-Signal-Safe)
+static int write_all(int fd, const unsigned char *p_buf, unsigned int length)
+{
+    unsigned int written = 0;
+    ssize_t result = 0;
+
+    while(written < length)
+    {
+        result = write(fd, p_buf + written, length - written);
+        if(result < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return TP_ERR_FILE_IO_ERROR;
+        }
+        written += (unsigned int)result;
+    }
+    return TP_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::CHidrawTrace()
+
+CHidrawTrace::CHidrawTrace(void)
+{
+    m_nTraceFd = -1;
+    m_pTraceBuf = NULL;
+    m_nTraceBufUsed = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::~CHidrawTrace()
+
+CHidrawTrace::~CHidrawTrace(void)
+{
+    Close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::Open()
+// Create (Truncate) Trace File & Write File Header
+
+int CHidrawTrace::Open(const char *pszTracePath)
+{
+    int nRet = TP_SUCCESS;
+    unsigned char header[HIDRAW_TRACE_FILE_HEADER_SIZE] = {0};
+
+    if((pszTracePath == NULL) || (pszTracePath[0] == '\0'))
+    {
+        nRet = TP_ERR_INVALID_PARAM;
+        goto OPEN_EXIT;
+    }
+
+    // Re-Open
+    Close();
+
+    m_pTraceBuf = (unsigned char *)malloc(HIDRAW_TRACE_BUF_SIZE);
+    if(m_pTraceBuf == NULL)
+    {
+        nRet = TP_ERR_IO_ERROR;
+        goto OPEN_EXIT;
+    }
+
+    m_nTraceFd = open(pszTracePath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(m_nTraceFd < 0)
+    {
+        free(m_pTraceBuf);
+        m_pTraceBuf = NULL;
+        nRet = TP_ERR_FILE_IO_ERROR;
+        goto OPEN_EXIT;
+    }
+
+    // File Header
+    encode_file_header(header);
+    memcpy(m_pTraceBuf, header, sizeof(header));
+    m_nTraceBufUsed = sizeof(header);
+
+    // Success
+    nRet = TP_SUCCESS;
+
+OPEN_EXIT:
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::Close()
+
+void CHidrawTrace::Close(void)
+{
+    if(m_nTraceFd >= 0)
+    {
+        Flush();
+        close(m_nTraceFd);
+        m_nTraceFd = -1;
+    }
+
+    if(m_pTraceBuf)
+    {
+        free(m_pTraceBuf);
+        m_pTraceBuf = NULL;
+    }
+    m_nTraceBufUsed = 0;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::IsOpen()
+
+bool CHidrawTrace::IsOpen(void)
+{
+    return (m_nTraceFd >= 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::Flush()
+// Write Buffered Records to File
+
+void CHidrawTrace::Flush(void)
+{
+    // On Error, Drop Buffered Records and Keep Tracing
+    write_all(m_nTraceFd, m_pTraceBuf, m_nTraceBufUsed);
+    m_nTraceBufUsed = 0;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawTrace::Record()
+// Append One Report to Trace Buffer
+
+void CHidrawTrace::Record(int nDirection, const unsigned char *pbyBuf, int nLen)
+{
+    unsigned int nLength = 0;
+
+    if((m_nTraceFd < 0) || (pbyBuf == NULL) || (nLen <= 0))
+        return;
+
+    nLength = ((unsigned int)nLen <= HIDRAW_TRACE_MAX_REPORT_SIZE) ? (unsigned int)nLen : HIDRAW_TRACE_MAX_REPORT_SIZE;
+    if(m_nTraceBufUsed + HIDRAW_TRACE_RECORD_HEADER_SIZE + nLength > HIDRAW_TRACE_BUF_SIZE)
+        Flush();
+
+    m_nTraceBufUsed += encode_record(m_pTraceBuf + m_nTraceBufUsed, monotonic_time_ns(), nDirection, pbyBuf, nLength);
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::CHidrawFlightRecorder()
+
+CHidrawFlightRecorder::CHidrawFlightRecorder(void)
+{
+    memset(m_records, 0, sizeof(m_records));
+    m_nRecordCount[HIDRAW_TRACE_DIR_OUTPUT] = 0;
+    m_nRecordCount[HIDRAW_TRACE_DIR_INPUT] = 0;
+    memset(m_szDumpPath, 0, sizeof(m_szDumpPath));
+    m_nSignalSlot = -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::~CHidrawFlightRecorder()
+
+CHidrawFlightRecorder::~CHidrawFlightRecorder(void)
+{
+    RemoveSignalHandler();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::SetDumpPath()
+
+void CHidrawFlightRecorder::SetDumpPath(const char *pszDumpPath)
+{
+    memset(m_szDumpPath, 0, sizeof(m_szDumpPath));
+    if(pszDumpPath)
+        strncpy(m_szDumpPath, pszDumpPath, sizeof(m_szDumpPath) - 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::GetDumpPath()
+
+const char *CHidrawFlightRecorder::GetDumpPath(void)
+{
+    return m_szDumpPath;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::Record()
+// Overwrite the Oldest Slot of the Direction
+
+void CHidrawFlightRecorder::Record(int nDirection, const unsigned char *pbyBuf, int nLen)
+{
+    struct flight_record *pRecord = NULL;
+    int nDir = (nDirection == HIDRAW_TRACE_DIR_INPUT) ? HIDRAW_TRACE_DIR_INPUT : HIDRAW_TRACE_DIR_OUTPUT;
+
+    if((pbyBuf == NULL) || (nLen <= 0))
+        return;
+
+    pRecord = &m_records[nDir][m_nRecordCount[nDir] & (HIDRAW_FLIGHT_RECORDER_DEPTH - 1)];
+    pRecord->timestamp_ns = monotonic_time_ns();
+    pRecord->length = (unsigned short)((nLen <= HIDRAW_FLIGHT_RECORDER_SLOT_SIZE) ? nLen : HIDRAW_FLIGHT_RECORDER_SLOT_SIZE);
+    memcpy(pRecord->data, pbyBuf, pRecord->length);
+    m_nRecordCount[nDir]++;
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::Dump()
+// Write Both Rings to Dump Path, Merged in Time Order (Async-Signal-Safe)
+
+int CHidrawFlightRecorder::Dump(void)
+{
+    int nRet = TP_SUCCESS,
+        nFd = -1,
+        nDir = 0;
+    unsigned int nCount[2] = {0},
+                 nNext[2] = {0},
+                 nEnd[2] = {0},
+                 nSize = 0;
+    const struct flight_record *pRecord[2] = {NULL};
+    unsigned char szHeader[HIDRAW_TRACE_FILE_HEADER_SIZE];
+    unsigned char szRecord[HIDRAW_TRACE_RECORD_HEADER_SIZE + HIDRAW_FLIGHT_RECORDER_SLOT_SIZE];
+
+    if(m_szDumpPath[0] == '\0')
+    {
+        nRet = TP_ERR_INVALID_PARAM;
+        goto DUMP_EXIT;
+    }
+
+    nFd = open(m_szDumpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(nFd < 0)
+    {
+        nRet = TP_ERR_FILE_IO_ERROR;
+        goto DUMP_EXIT;
+    }
+
+    encode_file_header(szHeader);
+    nRet = write_all(nFd, szHeader, sizeof(szHeader));
+    if(nRet != TP_SUCCESS)
+        goto DUMP_EXIT;
+
+    // Oldest Surviving Report of Each Direction
+    for(nDir = 0; nDir < 2; nDir++)
+    {
+        nCount[nDir] = m_nRecordCount[nDir];
+        nEnd[nDir] = nCount[nDir];
+        nNext[nDir] = (nCount[nDir] > HIDRAW_FLIGHT_RECORDER_DEPTH) ? (nCount[nDir] - HIDRAW_FLIGHT_RECORDER_DEPTH) : 0;
+    }
+
+    while((nNext[0] != nEnd[0]) || (nNext[1] != nEnd[1]))
+    {
+        for(nDir = 0; nDir < 2; nDir++)
+            pRecord[nDir] = (nNext[nDir] != nEnd[nDir]) ? &m_records[nDir][nNext[nDir] & (HIDRAW_FLIGHT_RECORDER_DEPTH - 1)] : NULL;
+
+        if(pRecord[0] == NULL)
+            nDir = 1;
+        else if(pRecord[1] == NULL)
+            nDir = 0;
+        else
+            nDir = (pRecord[1]->timestamp_ns < pRecord[0]->timestamp_ns) ? 1 : 0;
+
+        nSize = encode_record(szRecord, pRecord[nDir]->timestamp_ns, nDir, pRecord[nDir]->data, pRecord[nDir]->length);
+        nRet = write_all(nFd, szRecord, nSize);
+        if(nRet != TP_SUCCESS)
+            goto DUMP_EXIT;
+        nNext[nDir]++;
+    }
+
+    // Success
+    nRet = TP_SUCCESS;
+
+DUMP_EXIT:
+    if(nFd >= 0)
+        close(nFd);
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::SignalHandler()
+// Dump Every Live Recorder, then Let the Previous Action (Default: Core) Happen
+
+void CHidrawFlightRecorder::SignalHandler(int nSignal)
+{
+    int nIndex = 0;
+
+    DumpAll();
+
+    // Hand Signal Back to Previous Action
+    for(nIndex = 0; nIndex < FLIGHT_RECORDER_SIGNAL_COUNT; nIndex++)
+    {
+        if(s_flight_recorder_signals[nIndex] == nSignal)
+            sigaction(nSignal, &s_flight_recorder_previous_actions[nIndex], NULL);
+    }
+    raise(nSignal);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::DumpAll()
+// Lock-Free Walk over the Slot Table, Safe from a Signal Handler
+
+void CHidrawFlightRecorder::DumpAll(void)
+{
+    CHidrawFlightRecorder *pRecorder = NULL;
+    int nIndex = 0;
+
+    for(nIndex = 0; nIndex < HIDRAW_FLIGHT_RECORDER_MAX_LIVE; nIndex++)
+    {
+        pRecorder = s_p_live_flight_recorders[nIndex];
+        if(pRecorder)
+            pRecorder->Dump();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::InstallSignalHandler()
+
+int CHidrawFlightRecorder::InstallSignalHandler(void)
+{
+    struct sigaction action;
+    int nIndex = 0;
+
+    pthread_mutex_lock(&s_flight_recorder_mutex);
+
+    if(m_nSignalSlot >= 0)
+        goto INSTALL_SIGNAL_HANDLER_EXIT;
+
+    // Take a Free Slot
+    for(nIndex = 0; nIndex < HIDRAW_FLIGHT_RECORDER_MAX_LIVE; nIndex++)
+    {
+        if(s_p_live_flight_recorders[nIndex] == NULL)
+            break;
+    }
+    if(nIndex == HIDRAW_FLIGHT_RECORDER_MAX_LIVE)
+        goto INSTALL_SIGNAL_HANDLER_EXIT;
+    m_nSignalSlot = nIndex;
+    s_p_live_flight_recorders[m_nSignalSlot] = this;
+
+    // First Live Recorder Installs the Handler
+    if(s_live_flight_recorder_count++ == 0)
+    {
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = SignalHandler;
+        action.sa_flags = SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+
+        for(nIndex = 0; nIndex < FLIGHT_RECORDER_SIGNAL_COUNT; nIndex++)
+            sigaction(s_flight_recorder_signals[nIndex], &action, &s_flight_recorder_previous_actions[nIndex]);
+    }
+
+INSTALL_SIGNAL_HANDLER_EXIT:
+    pthread_mutex_unlock(&s_flight_recorder_mutex);
+    return m_nSignalSlot;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CHidrawFlightRecorder::RemoveSignalHandler()
+
+void CHidrawFlightRecorder::RemoveSignalHandler(void)
+{
+    int nIndex = 0;
+
+    pthread_mutex_lock(&s_flight_recorder_mutex);
+
+    if(m_nSignalSlot < 0)
+        goto REMOVE_SIGNAL_HANDLER_EXIT;
+
+    s_p_live_flight_recorders[m_nSignalSlot] = NULL;
+    m_nSignalSlot = -1;
+
+    // Last Live Recorder Restores the Previous Actions
+    if(--s_live_flight_recorder_count == 0)
+    {
+        for(nIndex = 0; nIndex < FLIGHT_RECORDER_SIGNAL_COUNT; nIndex++)
+            sigaction(s_flight_recorder_signals[nIndex], &s_flight_recorder_previous_actions[nIndex], NULL);
+    }
+
+REMOVE_SIGNAL_HANDLER_EXIT:
+    pthread_mutex_unlock(&s_flight_recorder_mutex);
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// hidraw_trace_read_header()
+// Validate File Header & Skip to First Record
+
+int hidraw_trace_read_header(FILE *p_file)
+{
+    int err = TP_SUCCESS;
+    unsigned char header[HIDRAW_TRACE_FILE_HEADER_SIZE] = {0};
+    unsigned int header_size = 0;
+
+    if(p_file == NULL)
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto READ_HEADER_EXIT;
+    }
+
+    if(fread(header, 1, sizeof(header), p_file) != sizeof(header))
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto READ_HEADER_EXIT;
+    }
+
+    if((memcmp(header, HIDRAW_TRACE_MAGIC, HIDRAW_TRACE_MAGIC_LEN) != 0) ||
+       (get_le16(&header[8]) != HIDRAW_TRACE_VERSION) ||
+       (get_le16(&header[12]) != HIDRAW_TRACE_RECORD_HEADER_SIZE))
+    {
+        err = TP_ERR_DATA_PATTERN;
+        goto READ_HEADER_EXIT;
+    }
+
+    // Skip Header Extension (If Any)
+    header_size = get_le16(&header[10]);
+    if((header_size > sizeof(header)) && (fseek(p_file, header_size, SEEK_SET) != 0))
+    {
+        err = TP_ERR_FILE_IO_ERROR;
+        goto READ_HEADER_EXIT;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+READ_HEADER_EXIT:
+    return err;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// hidraw_trace_read_record()
+// Read Next Record; TP_ERR_DATA_NOT_FOUND at End of File
+
+int hidraw_trace_read_record(FILE *p_file, struct hidraw_trace_record *p_record)
+{
+    int err = TP_SUCCESS;
+    unsigned char header[HIDRAW_TRACE_RECORD_HEADER_SIZE] = {0};
+    unsigned int dir_length = 0,
+                 stored = 0;
+    size_t read_bytes = 0;
+
+    if((p_file == NULL) || (p_record == NULL))
+    {
+        err = TP_ERR_INVALID_PARAM;
+        goto READ_RECORD_EXIT;
+    }
+
+    read_bytes = fread(header, 1, sizeof(header), p_file);
+    if(read_bytes == 0)
+    {
+        err = TP_ERR_DATA_NOT_FOUND;
+        goto READ_RECORD_EXIT;
+    }
+    else if(read_bytes != sizeof(header))
+    {
+        err = TP_ERR_DATA_PATTERN; // Truncated Record
+        goto READ_RECORD_EXIT;
+    }
+
+    dir_length = get_le16(&header[8]);
+    stored = get_le16(&header[10]);
+
+    p_record->timestamp_ns = get_le64(&header[0]);
+    p_record->direction = (dir_length & HIDRAW_TRACE_DIR_INPUT_FLAG) ? HIDRAW_TRACE_DIR_INPUT : HIDRAW_TRACE_DIR_OUTPUT;
+    p_record->length = dir_length & HIDRAW_TRACE_LENGTH_MASK;
+    if((p_record->length > HIDRAW_TRACE_MAX_REPORT_SIZE) || (stored > p_record->length))
+    {
+        err = TP_ERR_DATA_PATTERN;
+        goto READ_RECORD_EXIT;
+    }
+
+    memset(p_record->data, 0, p_record->length);
+    if(fread(p_record->data, 1, stored, p_file) != stored)
+    {
+        err = TP_ERR_DATA_PATTERN; // Truncated Record
+        goto READ_RECORD_EXIT;
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+READ_RECORD_EXIT:
+    return err;
+}
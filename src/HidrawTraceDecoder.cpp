@@ -0,0 +1,284 @@
+/** @file
+
+  Offline Decoder of Binary hidraw Trace for Elan I2C-HID Tool.
+
+  Copyright (c) ELAN microelectronics corp. 2022, All Rights Reserved
+
+  Module Name:
+	HidrawTraceDecoder.cpp
+
+  Environment:
+	All kinds of Linux-like Platform.
+
+  Usage:
+	elan_hidraw_trace_decode [-o opcode]... [-l] [-q] trace_file
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "HidrawTrace.h"
+
+/***************************************************
+ * Definitions
+ ***************************************************/
+
+// Report Layout (See I2CHIDLinuxGet.h)
+#define OUTPUT_REPORT_OPCODE_OFFSET	3	// | Report ID | Bridge Command | Length | Command... |
+#define INPUT_REPORT_OPCODE_OFFSET	2	// | Report ID | Length | Data... |
+
+/***************************************************
+ * Declaration of Data Structure
+ ***************************************************/
+
+struct opcode_latency
+{
+    unsigned int count;
+    unsigned long long total_ns;
+    unsigned long long min_ns;
+    unsigned long long max_ns;
+};
+
+/***************************************************
+ * Global Variables Declaration
+ ***************************************************/
+
+// Opcode Filter (Empty Filter Shows All)
+static bool s_opcode_filter[256];
+static bool s_opcode_filter_set = false;
+
+// Options
+static bool s_show_latency = false;
+static bool s_quiet = false;
+
+// Response Latency (Output Report -> First Input Report) per Opcode
+static struct opcode_latency s_latency[256];
+
+/***************************************************
+ * Function Implements
+ ***************************************************/
+
+static const char *opcode_name(unsigned char opcode)
+{
+    switch(opcode)
+    {
+        case 0x53:
+            return "Read Register";
+        case 0x54:
+            return "Write Register";
+        case 0x55:
+            return "Enter Test Mode";
+        case 0x59:
+            return "Show Bulk ROM Data";
+        case 0x96:
+            return "Read ROM Data";
+        case 0xA5:
+            return "Exit Test Mode";
+        default:
+            return "-";
+    }
+}
+
+static int record_opcode(const struct hidraw_trace_record *p_record)
+{
+    unsigned int offset = (p_record->direction == HIDRAW_TRACE_DIR_OUTPUT) ? OUTPUT_REPORT_OPCODE_OFFSET : INPUT_REPORT_OPCODE_OFFSET;
+
+    if(p_record->length <= offset)
+        return -1;
+    return p_record->data[offset];
+}
+
+static void print_record(unsigned int index, const struct hidraw_trace_record *p_record, unsigned long long start_ns, unsigned long long prev_ns, int opcode)
+{
+    unsigned int last = p_record->length,
+                 byte_index = 0;
+    unsigned long long rel_ns = p_record->timestamp_ns - start_ns,
+                       delta_ns = p_record->timestamp_ns - prev_ns;
+
+    // Trailing Zeros were not Recorded; Don't Print Them Either
+    while((last > 0) && (p_record->data[last - 1] == 0))
+        last--;
+
+    printf("%6u %6llu.%06llu %+10.3f %-3s %4u ",
+           index, rel_ns / 1000000000ULL, (rel_ns / 1000ULL) % 1000000ULL, delta_ns / 1000.0,
+           (p_record->direction == HIDRAW_TRACE_DIR_OUTPUT) ? "OUT" : "IN", p_record->length);
+    if(opcode >= 0)
+        printf("%02x %-18s ", opcode, opcode_name((unsigned char)opcode));
+    else
+        printf("-- %-18s ", "-");
+
+    for(byte_index = 0; byte_index < last; byte_index++)
+        printf("%02x ", p_record->data[byte_index]);
+    printf("\r\n");
+}
+
+static void print_latency_summary(void)
+{
+    int opcode = 0;
+
+    printf("\r\n[Response Latency (OUT -> First IN), us]\r\n");
+    printf("opcode %-18s %8s %10s %10s %10s\r\n", "name", "count", "min", "avg", "max");
+    for(opcode = 0; opcode < 256; opcode++)
+    {
+        if(s_latency[opcode].count == 0)
+            continue;
+        if(s_opcode_filter_set && !s_opcode_filter[opcode])
+            continue;
+        printf("    %02x %-18s %8u %10.3f %10.3f %10.3f\r\n", opcode, opcode_name((unsigned char)opcode), s_latency[opcode].count,
+               s_latency[opcode].min_ns / 1000.0, (s_latency[opcode].total_ns / (double)s_latency[opcode].count) / 1000.0, s_latency[opcode].max_ns / 1000.0);
+    }
+}
+
+static void show_help_information(void)
+{
+    printf("Usage: elan_hidraw_trace_decode [-o opcode]... [-l] [-q] trace_file\r\n");
+    printf("-o, --opcode: Only show commands with this opcode and their responses (hex, repeatable). Ex: -o 53 -o 54\r\n");
+    printf("-l, --latency: Print response latency (OUT -> first IN) per opcode.\r\n");
+    printf("-q, --quiet: Do not print reports (use with -l).\r\n");
+    printf("-h, --help: Show this help.\r\n");
+}
+
+int main(int argc, char **argv)
+{
+    int err = TP_SUCCESS,
+        opt = 0,
+        opcode = 0,
+        command_opcode = -1,
+        pending_opcode = -1;
+    unsigned int index = 0;
+    unsigned long long start_ns = 0,
+                       prev_ns = 0,
+                       pending_ns = 0,
+                       latency_ns = 0;
+    FILE *p_file = NULL;
+    struct hidraw_trace_record *p_record = NULL;
+    const struct option long_options[] =
+    {
+        { "opcode",		1, NULL, 'o'},
+        { "latency",	0, NULL, 'l'},
+        { "quiet",		0, NULL, 'q'},
+        { "help",		0, NULL, 'h'},
+        { NULL,			0, NULL, 0},
+    };
+
+    while((opt = getopt_long(argc, argv, "o:lqh", long_options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'o': /* Opcode Filter */
+                opcode = (int)strtol(optarg, NULL, 16);
+                if((opcode < 0) || (opcode > 0xFF))
+                {
+                    fprintf(stderr, "Invalid Opcode: %s!\r\n", optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto EXIT;
+                }
+                s_opcode_filter[opcode] = true;
+                s_opcode_filter_set = true;
+                break;
+
+            case 'l': /* Latency Summary */
+                s_show_latency = true;
+                break;
+
+            case 'q': /* Quiet */
+                s_quiet = true;
+                break;
+
+            case 'h': /* Help */
+            default:
+                show_help_information();
+                goto EXIT;
+        }
+    }
+
+    if(optind >= argc)
+    {
+        show_help_information();
+        err = TP_ERR_INVALID_PARAM;
+        goto EXIT;
+    }
+
+    p_file = fopen(argv[optind], "rb");
+    if(p_file == NULL)
+    {
+        fprintf(stderr, "Fail to open trace file \"%s\"!\r\n", argv[optind]);
+        err = TP_ERR_FILE_NOT_FOUND;
+        goto EXIT;
+    }
+
+    err = hidraw_trace_read_header(p_file);
+    if(err != TP_SUCCESS)
+    {
+        fprintf(stderr, "\"%s\" is not a hidraw trace file! err=0x%x.\r\n", argv[optind], err);
+        goto EXIT1;
+    }
+
+    p_record = (struct hidraw_trace_record *)malloc(sizeof(struct hidraw_trace_record));
+    if(p_record == NULL)
+    {
+        err = TP_ERR_IO_ERROR;
+        goto EXIT1;
+    }
+
+    if(!s_quiet)
+        printf("%6s %13s %10s %-3s %4s op %-18s data\r\n", "#", "time(s)", "delta(us)", "dir", "len", "name");
+
+    for(index = 0; ; index++)
+    {
+        err = hidraw_trace_read_record(p_file, p_record);
+        if(err == TP_ERR_DATA_NOT_FOUND) // End of File
+        {
+            err = TP_SUCCESS;
+            break;
+        }
+        else if(err != TP_SUCCESS)
+        {
+            fprintf(stderr, "Corrupted record #%u! err=0x%x.\r\n", index, err);
+            break;
+        }
+
+        if(index == 0)
+            start_ns = prev_ns = p_record->timestamp_ns;
+
+        opcode = record_opcode(p_record);
+
+        // Response Latency: Time from a Command to the First Report Read after It
+        if(p_record->direction == HIDRAW_TRACE_DIR_OUTPUT)
+        {
+            command_opcode = opcode;
+            pending_opcode = opcode;
+            pending_ns = p_record->timestamp_ns;
+        }
+        else if(pending_opcode >= 0)
+        {
+            latency_ns = p_record->timestamp_ns - pending_ns;
+            if((s_latency[pending_opcode].count == 0) || (latency_ns < s_latency[pending_opcode].min_ns))
+                s_latency[pending_opcode].min_ns = latency_ns;
+            if(latency_ns > s_latency[pending_opcode].max_ns)
+                s_latency[pending_opcode].max_ns = latency_ns;
+            s_latency[pending_opcode].total_ns += latency_ns;
+            s_latency[pending_opcode].count++;
+            pending_opcode = -1;
+        }
+
+        // Filter: Commands by Opcode, Input Reports by Own Opcode or Last Command's
+        if(!s_quiet && (!s_opcode_filter_set ||
+                        ((opcode >= 0) && s_opcode_filter[opcode]) ||
+                        ((p_record->direction == HIDRAW_TRACE_DIR_INPUT) && (command_opcode >= 0) && s_opcode_filter[command_opcode])))
+            print_record(index, p_record, start_ns, prev_ns, opcode);
+
+        prev_ns = p_record->timestamp_ns;
+    }
+
+    if(s_show_latency)
+        print_latency_summary();
+
+    free(p_record);
+EXIT1:
+    fclose(p_file);
+EXIT:
+    return (err == TP_SUCCESS) ? 0 : 1;
+}
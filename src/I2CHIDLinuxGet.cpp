@@ -14,6 +14,10 @@
 #include "win32_debug_utility.h"
 #endif // Debug Utility
 #include "I2CHIDLinuxGet.h"
+#include "ElanTsProbe.h"
+#include "HidrawBusScheduler.h"
+#include "HidrawSysfs.h"
+#include "HidrawReportDescriptor.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CI2CHIDLinuxGet::CI2CHIDGetLinux()
@@ -26,16 +30,20 @@ CI2CHIDLinuxGet::CI2CHIDLinuxGet(char *pszLogDirPath, char *pszDebugLogFileName)
 {
     //DBG("Construct CI2CHIDLinuxGet.");
 
-    // Initialize hidraw device handler
-    m_nHidrawFd = -1;
+    // Initialize hidraw device handlers & chip data
+    memset(m_devices, 0, sizeof(m_devices));
+    for (int nDevIdx = 0; nDevIdx < I2CHID_MAX_DEVICES; nDevIdx++)
+        m_devices[nDevIdx].nFd = -1;
+    m_nDevCount = 0;
+    m_nHotplugReopenTimeoutMS = HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC;
+    m_bFeatureChannel = false;
 
     // Initialize file descriptor monitor
     memset(&m_tvRead, 0, sizeof(struct timeval));
 
-    // Assign initial values to chip data
-    m_usVID = 0;
-    m_usPID = 0;
-    m_usVersion = 0;
+    // No command awaiting response
+    m_nPendingOpcode = -1;
+    m_ullWriteDoneNs = 0;
 
     // Assign Initial values to buffers
     m_inBuf 	= NULL;
@@ -46,18 +54,32 @@ CI2CHIDLinuxGet::CI2CHIDLinuxGet(char *pszLogDirPath, char *pszDebugLogFileName)
     // Initialize mutex
     sem_init(&m_ioMutex,  0 /*scope is in this file*/, 1 /*active in initial*/);
 
-    // Allocate memory to inBuffer
-    m_inBufSize = ELAN_I2CHID_INPUT_BUFFER_SIZE;
+    // Allocate memory to inBuffer, large enough for any report descriptor accepted
+    m_inBufSize = I2CHID_REPORT_LEN_MAX;
     //DBG("Allocate %d bytes to inBuffer.", m_inBufSize);
     m_inBuf = (unsigned char*)malloc(sizeof(unsigned char) * m_inBufSize);
     memset(m_inBuf, 0, sizeof(unsigned char)*m_inBufSize);
 
     // Allocate memory to outBuffer
-    m_outBufSize = ELAN_I2CHID_OUTPUT_BUFFER_SIZE;
+    m_outBufSize = I2CHID_REPORT_LEN_MAX;
     //DBG("Allocate %d bytes to outBuffer.", m_outBufSize);
     m_outBuf = (unsigned char*)malloc(sizeof(unsigned char) * m_outBufSize);
     memset(m_outBuf, 0, sizeof(unsigned char)*m_outBufSize);
 
+    // Arm flight recorder, dumped to log directory on failure or fatal signal
+    // (one file per live instance: slot 0 keeps the plain name, later slots append their index)
+    {
+        char szDumpPath[PATH_LEN_MAX] = {0};
+        const char *pszDumpDir = (strcmp(m_szLogDirPath, "") != 0) ? m_szLogDirPath : "/tmp";
+        int nSlot = m_flightRecorder.InstallSignalHandler();
+
+        if (nSlot > 0)
+            snprintf(szDumpPath, sizeof(szDumpPath), "%s/%s.%d", pszDumpDir, DEFAULT_FLIGHT_RECORDER_FILE, nSlot);
+        else
+            snprintf(szDumpPath, sizeof(szDumpPath), "%s/%s", pszDumpDir, DEFAULT_FLIGHT_RECORDER_FILE);
+        m_flightRecorder.SetDumpPath(szDumpPath);
+    }
+
     return;
 }
 
@@ -69,6 +91,12 @@ CI2CHIDLinuxGet::CI2CHIDLinuxGet(char *pszLogDirPath, char *pszDebugLogFileName)
 
 CI2CHIDLinuxGet::~CI2CHIDLinuxGet(void)
 {
+    // Flush & close trace file
+    DisableTrace();
+
+    // Stop dumping flight recorder on fatal signals
+    m_flightRecorder.RemoveSignalHandler();
+
     // Deinitialize mutex (semaphore)
     sem_destroy(&m_ioMutex);
 
@@ -90,10 +118,9 @@ CI2CHIDLinuxGet::~CI2CHIDLinuxGet(void)
         m_outBufSize    = 0;
     }
 
-    // Clear Chip Data
-    m_usVID = 0;
-    m_usPID = 0;
-    m_usVersion = 0;
+    // Release hidraw device handlers & clear chip data
+    Close();
+    memset(m_devices, 0, sizeof(m_devices));
 
     return;
 }
@@ -106,13 +133,19 @@ CI2CHIDLinuxGet::~CI2CHIDLinuxGet(void)
 
 void CI2CHIDLinuxGet::Close(void)
 {
-    if (m_nHidrawFd >= 0)
+    int nDevIdx = 0;
+
+    for (nDevIdx = 0; nDevIdx < m_nDevCount; nDevIdx++)
     {
-        // Release acquired hidraw device handler
-        DBG("%s: Release hidraw device handle (fd=%d).", __func__, m_nHidrawFd);
-        close(m_nHidrawFd);
-        m_nHidrawFd = -1;
+        if (m_devices[nDevIdx].nFd >= 0)
+        {
+            // Release acquired hidraw device handler
+            DBG("%s: Release hidraw device handle \'%s\' (fd=%d).", __func__, m_devices[nDevIdx].szPath, m_devices[nDevIdx].nFd);
+            close(m_devices[nDevIdx].nFd);
+            m_devices[nDevIdx].nFd = -1;
+        }
     }
+    m_nDevCount = 0;
 
     return;
 }
@@ -128,7 +161,11 @@ int CI2CHIDLinuxGet::GetDeviceHandle(int nVID, int nPID)
 {
     int nRet = TP_SUCCESS,
         nError = 0;
-    char szHidrawDevPath[64] = {0};
+    char szHidrawDevPath[I2CHID_DEV_PATH_LEN_MAX] = {0};
+    struct hidraw_devinfo info;
+
+    // Release devices of a previous connection
+    Close();
 
     // Look for elan hidraw device with specific PID
     nError = FindHidrawDevice(nVID, nPID, szHidrawDevPath);
@@ -151,22 +188,364 @@ int CI2CHIDLinuxGet::GetDeviceHandle(int nVID, int nPID)
     }
 
     // Acquire hidraw device handler for I/O
-    nError = open(szHidrawDevPath, O_RDWR | O_NONBLOCK);
-    if (nError < 0)
+    nError = OpenDevice(0, szHidrawDevPath, &info);
+    if (nError != TP_SUCCESS)
     {
-        ERR("%s: Fail to Open Device %s! errno=%d.", __func__, szHidrawDevPath, nError);
+        // Node may come from a stale discovery cache (device re-enumerated), look again next time
+        hidraw_sysfs_invalidate();
         nRet = TP_ERR_NOT_FOUND_DEVICE;
         goto GET_DEVICE_HANDLE_EXIT;
     }
 
     // Success
-    m_nHidrawFd = nError;
-    DBG("%s: Open hidraw device \'%s\' (non-blocking), fd=%d.", __func__, szHidrawDevPath, m_nHidrawFd);
+    m_nDevCount = 1;
 
 GET_DEVICE_HANDLE_EXIT:
     return nRet;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetDeviceHandleByPath()
+// Open a known hidraw node (ex: "/dev/hidraw3") without scanning /dev,
+// and fill VID & PID from the node
+
+int CI2CHIDLinuxGet::GetDeviceHandleByPath(const char *pszDevicePath)
+{
+    int nRet = TP_SUCCESS;
+    struct hidraw_devinfo info;
+
+    // Release devices of a previous connection
+    Close();
+
+    if ((pszDevicePath == NULL) || (strcmp(pszDevicePath, "") == 0))
+    {
+        ERR("%s: NULL Device Path!", __func__);
+        nRet = TP_ERR_INVALID_PARAM;
+        goto GET_DEVICE_HANDLE_BY_PATH_EXIT;
+    }
+
+    nRet = OpenDevice(0, pszDevicePath, &info);
+    if (nRet != TP_SUCCESS)
+        goto GET_DEVICE_HANDLE_BY_PATH_EXIT;
+
+    if (info.vendor != ELAN_USB_VID)
+    {
+        ERR("%s: %s is not an Elan device (VID 0x%04hx)!", __func__, pszDevicePath, info.vendor);
+        close(m_devices[0].nFd);
+        m_devices[0].nFd = -1;
+        nRet = TP_ERR_NOT_FOUND_DEVICE;
+        goto GET_DEVICE_HANDLE_BY_PATH_EXIT;
+    }
+
+    // Success
+    m_nDevCount = 1;
+    nRet = TP_SUCCESS;
+
+GET_DEVICE_HANDLE_BY_PATH_EXIT:
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::EnumerateDevices()
+// Open every I2C-HID node of vendor nVID (index 0, 1, ...), so one instance
+// can drive all panels of the host by nDevIdx
+
+int CI2CHIDLinuxGet::EnumerateDevices(int nVID)
+{
+    int nRet = TP_SUCCESS,
+        nIndex = 0,
+        nCount = 0;
+    DIR *pDirectory = NULL;
+    struct dirent *pDirEntry = NULL;
+    char szFile[I2CHID_DEV_PATH_LEN_MAX] = {0};
+    struct hidraw_devinfo info;
+    struct hidraw_sysfs_info nodes[HIDRAW_SYSFS_MAX_NODES];
+
+    // Release devices of a previous connection
+    Close();
+
+    if (hidraw_sysfs_scan(nodes, HIDRAW_SYSFS_MAX_NODES, &nCount) == TP_SUCCESS)
+    {
+        // Identity from sysfs, only matching nodes are opened
+        for (nIndex = 0; (nIndex < nCount) && (m_nDevCount < I2CHID_MAX_DEVICES); nIndex++)
+        {
+            if ((nodes[nIndex].vid != (unsigned int)nVID) || (nodes[nIndex].bus_type != BUS_I2C))
+                continue;
+
+            sprintf(szFile, "/dev/%s", nodes[nIndex].name);
+            if (OpenDevice(m_nDevCount, szFile, &info) == TP_SUCCESS)
+                m_nDevCount++;
+        }
+    }
+    else
+    {
+        // No sysfs, open every /dev/hidraw* and keep the matching ones
+        pDirectory = opendir("/dev");
+        if (pDirectory == NULL)
+        {
+            ERR("%s: Fail to Open Directory /dev.\r\n", __func__);
+            nRet = TP_ERR_NOT_FOUND_DEVICE;
+            goto ENUMERATE_DEVICES_EXIT;
+        }
+
+        while (((pDirEntry = readdir(pDirectory)) != NULL) && (m_nDevCount < I2CHID_MAX_DEVICES))
+        {
+            if (strncmp(pDirEntry->d_name, "hidraw", 6))
+                continue;
+
+            snprintf(szFile, sizeof(szFile), "/dev/%s", pDirEntry->d_name);
+            if (OpenDevice(m_nDevCount, szFile, &info) != TP_SUCCESS)
+                continue;
+
+            if ((info.vendor == nVID) && (info.bustype == BUS_I2C))
+                m_nDevCount++;
+            else
+            {
+                close(m_devices[m_nDevCount].nFd);
+                m_devices[m_nDevCount].nFd = -1;
+            }
+        }
+
+        closedir(pDirectory);
+    }
+
+    DBG("%s: %d device(s) of VID 0x%04x opened.", __func__, m_nDevCount, nVID);
+    nRet = (m_nDevCount > 0) ? TP_SUCCESS : TP_ERR_NOT_FOUND_DEVICE;
+
+ENUMERATE_DEVICES_EXIT:
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::OpenDevice()
+// Open one hidraw node (non-blocking) into slot nDevIdx and fill its attributes
+
+int CI2CHIDLinuxGet::OpenDevice(int nDevIdx, const char *pszDevicePath, struct hidraw_devinfo *pInfo)
+{
+    int nFd = -1;
+    struct i2chid_device *pDevice = &m_devices[nDevIdx];
+    struct hidraw_sysfs_info sysfsInfo;
+
+    nFd = open(pszDevicePath, O_RDWR | O_NONBLOCK);
+    if (nFd < 0)
+    {
+        ERR("%s: Fail to Open Device %s! errno=%d.", __func__, pszDevicePath, errno);
+        return TP_ERR_NOT_FOUND_DEVICE;
+    }
+
+    if (ioctl(nFd, HIDIOCGRAWINFO, pInfo) < 0)
+    {
+        ERR("%s: %s is not a hidraw device! errno=%d.", __func__, pszDevicePath, errno);
+        close(nFd);
+        return TP_ERR_NOT_FOUND_DEVICE;
+    }
+
+    pDevice->nFd = nFd;
+    snprintf(pDevice->szPath, sizeof(pDevice->szPath), "%s", pszDevicePath);
+    pDevice->usVID = (unsigned short) pInfo->vendor;
+    pDevice->usPID = (unsigned short) pInfo->product;
+    pDevice->usVersion = (hidraw_sysfs_get_info(pszDevicePath, &sysfsInfo) == TP_SUCCESS) ? (unsigned short) sysfsInfo.version : 0;
+    memset(pDevice->szPhys, 0, sizeof(pDevice->szPhys));
+    if (ioctl(nFd, HIDIOCGRAWPHYS(sizeof(pDevice->szPhys)), pDevice->szPhys) < 0)
+        memset(pDevice->szPhys, 0, sizeof(pDevice->szPhys));
+    pDevice->szPhys[sizeof(pDevice->szPhys) - 1] = '\0';
+    DBG("%s: Open hidraw device \'%s\' as #%d (VID 0x%04x, PID 0x%04x, non-blocking), fd=%d.", __func__,
+        pszDevicePath, nDevIdx, pDevice->usVID, pDevice->usPID, pDevice->nFd);
+
+    // Report IDs & lengths from report descriptor
+    ConfigureReports(nDevIdx);
+
+    // Responses queued for the previous node are gone with it
+    m_responseQueues[nDevIdx].Clear();
+
+    return TP_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::ConfigureReports()
+// Take vendor output / input report ID & length of device nDevIdx from its
+// report descriptor (HIDIOCGRDESC). Report ID 0x03 / 0x02 is preferred, else
+// the largest vendor-defined report. Without a usable descriptor, or with an
+// output report shorter than 33 bytes, the fixed 33 / 65-byte reports and
+// report ID rules of bridge PIDs are kept. The largest numbered vendor
+// feature report, if 33 bytes or more, is kept for the feature channel.
+
+void CI2CHIDLinuxGet::ConfigureReports(int nDevIdx)
+{
+    int nDescSize = 0;
+    struct i2chid_device *pDevice = &m_devices[nDevIdx];
+    struct hidraw_report_descriptor desc;
+    struct hidraw_report_layout layout;
+    const struct hidraw_report_info *pReport = NULL;
+
+    // Defaults
+    pDevice->byOutReportID = (pDevice->usPID == 0x7) ? ELAN_HID_OUTPUT_REPORT_ID_PID_7 : ELAN_HID_OUTPUT_REPORT_ID;
+    pDevice->nOutReportLen = ELAN_I2CHID_OUTPUT_BUFFER_SIZE;
+    pDevice->byInReportID = (pDevice->usPID == 0xb) ? ELAN_HID_INPUT_REPORT_ID_PID_B : ELAN_HID_INPUT_REPORT_ID;
+    pDevice->nInReportLen = ELAN_I2CHID_INPUT_BUFFER_SIZE;
+    pDevice->byFeatureReportID = 0;
+    pDevice->nFeatureReportLen = 0;
+    pDevice->bFeaturePending = false;
+    memset(&pDevice->featureReply, 0, sizeof(pDevice->featureReply));
+
+    if ((ioctl(pDevice->nFd, HIDIOCGRDESCSIZE, &nDescSize) < 0) || (nDescSize <= 0) || (nDescSize > HID_MAX_DESCRIPTOR_SIZE))
+    {
+        DBG("%s: No report descriptor of device #%d (errno=%d), use default reports.", __func__, nDevIdx, errno);
+        return;
+    }
+
+    memset(&desc, 0, sizeof(desc));
+    desc.size = nDescSize;
+    if (ioctl(pDevice->nFd, HIDIOCGRDESC, &desc) < 0)
+    {
+        DBG("%s: Fail to get report descriptor of device #%d (errno=%d), use default reports.", __func__, nDevIdx, errno);
+        return;
+    }
+
+    if (hidraw_rdesc_parse(desc.value, (int)desc.size, &layout) != TP_SUCCESS)
+    {
+        ERR("%s: Malformed report descriptor of device #%d (%d bytes), use default reports.", __func__, nDevIdx, nDescSize);
+        return;
+    }
+
+    // Feature report: numbered only, its ID byte leads every GET_FEATURE response
+    pReport = hidraw_rdesc_find(&layout, HIDRAW_REPORT_TYPE_FEATURE, HIDRAW_RDESC_ANY_REPORT_ID);
+    if ((pReport != NULL) && (pReport->report_id != 0) && (1 + (int)pReport->size >= ELAN_I2CHID_OUTPUT_BUFFER_SIZE) && (1 + pReport->size <= I2CHID_REPORT_LEN_MAX))
+    {
+        pDevice->byFeatureReportID = (unsigned char)pReport->report_id;
+        pDevice->nFeatureReportLen = 1 + pReport->size;
+        DBG("%s: Device #%d feature report 0x%02x (%d bytes).", __func__, nDevIdx, pDevice->byFeatureReportID, pDevice->nFeatureReportLen);
+    }
+
+    // Output report: hidraw always takes the report ID byte, 0 if unnumbered
+    pReport = hidraw_rdesc_find(&layout, HIDRAW_REPORT_TYPE_OUTPUT, ELAN_HID_OUTPUT_REPORT_ID);
+    if (pReport == NULL)
+        pReport = hidraw_rdesc_find(&layout, HIDRAW_REPORT_TYPE_OUTPUT, HIDRAW_RDESC_ANY_REPORT_ID);
+    if ((pReport != NULL) && (1 + (int)pReport->size >= ELAN_I2CHID_OUTPUT_BUFFER_SIZE) && (1 + pReport->size <= I2CHID_REPORT_LEN_MAX))
+    {
+        pDevice->byOutReportID = (unsigned char)pReport->report_id;
+        pDevice->nOutReportLen = 1 + pReport->size;
+    }
+    else
+    {
+        DBG("%s: No usable vendor output report of device #%d, use default reports.", __func__, nDevIdx);
+        return;
+    }
+
+    // Input report: ID byte only precedes numbered reports
+    pReport = hidraw_rdesc_find(&layout, HIDRAW_REPORT_TYPE_INPUT, ELAN_HID_INPUT_REPORT_ID);
+    if (pReport == NULL)
+        pReport = hidraw_rdesc_find(&layout, HIDRAW_REPORT_TYPE_INPUT, HIDRAW_RDESC_ANY_REPORT_ID);
+    if ((pReport != NULL) && (((pReport->report_id != 0) ? 1 : 0) + pReport->size <= I2CHID_REPORT_LEN_MAX))
+    {
+        pDevice->byInReportID = (unsigned char)pReport->report_id;
+        pDevice->nInReportLen = ((pReport->report_id != 0) ? 1 : 0) + pReport->size;
+    }
+
+    DBG("%s: Device #%d output report 0x%02x (%d bytes), input report 0x%02x (%d bytes).", __func__,
+        nDevIdx, pDevice->byOutReportID, pDevice->nOutReportLen, pDevice->byInReportID, pDevice->nInReportLen);
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::ReopenDevice()
+// Wait (inotify) for the node of device nDevIdx to come back, matched by
+// physical path (or VID & PID if unknown), and reopen it into the same slot
+
+int CI2CHIDLinuxGet::ReopenDevice(int nDevIdx, int nTimeoutMS)
+{
+    int nRet = TP_SUCCESS;
+    char szPath[I2CHID_DEV_PATH_LEN_MAX] = {0},
+         szPhys[HIDRAW_HOTPLUG_PHYS_LEN_MAX] = {0};
+    struct hidraw_hotplug_match match;
+    struct hidraw_devinfo info;
+
+    if ((nDevIdx < 0) || (nDevIdx >= m_nDevCount))
+        return TP_ERR_INVALID_PARAM;
+
+    sem_wait(&m_ioMutex);
+
+    // Release the stale handler, slot keeps identity
+    if (m_devices[nDevIdx].nFd >= 0)
+    {
+        close(m_devices[nDevIdx].nFd);
+        m_devices[nDevIdx].nFd = -1;
+    }
+    strcpy(szPhys, m_devices[nDevIdx].szPhys);
+
+    match.name = NULL;
+    match.vid = m_devices[nDevIdx].usVID;
+    match.pid = m_devices[nDevIdx].usPID;
+    match.phys = szPhys;
+    DBG("%s: Wait for \'%s\' (VID 0x%04x, PID 0x%04x, phys \"%s\") to come back, up to %d ms.", __func__,
+        m_devices[nDevIdx].szPath, match.vid, match.pid, szPhys, nTimeoutMS);
+
+    nRet = hidraw_hotplug_wait(&match, nTimeoutMS, szPath, sizeof(szPath));
+    if (nRet != TP_SUCCESS)
+    {
+        ERR("%s: Device #%d (%s) did not come back! err=0x%x.", __func__, nDevIdx, m_devices[nDevIdx].szPath, nRet);
+        goto REOPEN_DEVICE_EXIT;
+    }
+
+    nRet = OpenDevice(nDevIdx, szPath, &info);
+    if (nRet != TP_SUCCESS)
+        goto REOPEN_DEVICE_EXIT;
+
+    // Stale sysfs discovery no longer describes the host
+    hidraw_sysfs_invalidate();
+    INFO("%s: Device #%d reopened as \'%s\' (PID 0x%04x).", __func__, nDevIdx, szPath, m_devices[nDevIdx].usPID);
+
+REOPEN_DEVICE_EXIT:
+    sem_post(&m_ioMutex);
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::SetHotplugReopenTimeout()
+// Time given to a removed node to come back before I/O fails (0: no reopen)
+
+void CI2CHIDLinuxGet::SetHotplugReopenTimeout(int nTimeoutMS)
+{
+    m_nHotplugReopenTimeoutMS = (nTimeoutMS > 0) ? nTimeoutMS : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::SetFeatureChannel()
+// Send single-reply queries of WriteCommand() through SET_FEATURE and read
+// their reply through GET_FEATURE, on devices having a vendor feature report.
+// Other devices, other commands (bulk ROM, flash key, calibration, IAP) and
+// raw I/O stay on output / input reports.
+
+void CI2CHIDLinuxGet::SetFeatureChannel(bool bEnable)
+{
+    int nDevIdx = 0;
+
+    sem_wait(&m_ioMutex);
+    m_bFeatureChannel = bEnable;
+    for (nDevIdx = 0; nDevIdx < I2CHID_MAX_DEVICES; nDevIdx++)
+        m_devices[nDevIdx].bFeaturePending = false;
+    sem_post(&m_ioMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::HasFeatureChannel()
+// Check if device nDevIdx exposes a vendor feature report usable as command channel
+
+bool CI2CHIDLinuxGet::HasFeatureChannel(int nDevIdx)
+{
+    return IsDevIdxValid(nDevIdx) && (m_devices[nDevIdx].nFeatureReportLen > 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::IsDevIdxValid()
+// Check if nDevIdx addresses an opened device
+
+bool CI2CHIDLinuxGet::IsDevIdxValid(int nDevIdx)
+{
+    return (nDevIdx >= 0) && (nDevIdx < m_nDevCount) && (m_devices[nDevIdx].nFd >= 0);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CI2CHIDLinuxGet::IsConnected()
 // Check if device connected
@@ -174,7 +553,7 @@ bool CI2CHIDLinuxGet::IsConnected(void)
 {
     bool bRet = false;
 
-    if (m_nHidrawFd >= 0)
+    if (IsDevIdxValid(0))
     {
         //DBG("Device is connected!\r\n");
         bRet = true;
@@ -194,48 +573,82 @@ int CI2CHIDLinuxGet::WriteRawBytes(unsigned char* pszBuf, int nLen, int nTimeout
 {
     int nRet = 0,
         nResult = 0,
+        nReportLen = 0,
         nPollIndex = 0,
         nPollCount = 0;
+    unsigned long long ullWriteStartNs = 0;
+    bool bNodeGone = false,
+         bReopened = false;
 
     nPollCount = nTimeout;
+    ELAN_PROBE2(hidraw_write_entry, nLen, nTimeout);
 
-    if ((unsigned)nLen > m_outBufSize)
+    if (!IsDevIdxValid(nDevIdx))
     {
-        ERR("%s: Data length too large(data=%d, buffer size=%d), ret=%d.\r\n", __func__, nLen, m_outBufSize, nRet);
+        ERR("%s: Device #%d not opened!", __func__, nDevIdx);
         nRet = TP_ERR_INVALID_PARAM;
         goto WRITE_RAW_BYTES_EXIT;
     }
 
+    if ((nLen < 0) || (nLen > m_devices[nDevIdx].nOutReportLen))
+    {
+        ERR("%s: Data length too large(data=%d, report length=%d), ret=%d.\r\n", __func__, nLen, m_devices[nDevIdx].nOutReportLen, nRet);
+        nRet = TP_ERR_INVALID_PARAM;
+        goto WRITE_RAW_BYTES_EXIT;
+    }
+
+WRITE_RAW_BYTES_RETRY:
+    // Hold the I2C adapter for the rest of this burst (no-op if thread is not bound to one)
+    hidraw_bus_acquire();
+
     // Mutex locks the critical section
     sem_wait(&m_ioMutex);
 
-    // Copy data to local buffer and write buffer data to usb
+    // Copy data to local buffer (zero-padded to output report length) and write buffer data to usb
+    nReportLen = m_devices[nDevIdx].nOutReportLen;
     memset(m_outBuf, 0, sizeof(unsigned char)*m_outBufSize);
-    memcpy(m_outBuf, pszBuf, ((unsigned)nLen <= m_outBufSize) ? nLen : m_outBufSize);
+    memcpy(m_outBuf, pszBuf, nLen);
 
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_OUTBUF_DEBUG__)
-    if ((g_bEnableDebug == true) && (g_bEnableOutputBufferDebug == true))
-        DebugPrintBuffer("m_outBuf", m_outBuf, nLen);
-#endif //__ENABLE_DEBUG__ && __ENABLE_OUTBUF_DEBUG__
+    if (g_bEnableOutputBufferDebug == true)
+        DBG_BUFFER("m_outBuf", m_outBuf, nLen);
 
     // Write Buffer Data to hidraw device
-    // Since ELAN i2c-hid FW has its special limit, make sure to send all 33 byte once to IC.
-    // If data size is not 33, FW will not accept the command even if data format is correct.
+    // Since ELAN i2c-hid FW has its special limit, make sure to send the whole output report (33 bytes by default) once to IC.
+    // If data size is not the report length, FW will not accept the command even if data format is correct.
+    ullWriteStartNs = CHidrawLatencyStats::NowNs();
     for (nPollIndex = 0; nPollIndex < nPollCount; nPollIndex++)
     {
-        nResult = write(m_nHidrawFd, m_outBuf, m_outBufSize);
+        nResult = write(m_devices[nDevIdx].nFd, m_outBuf, nReportLen);
         if (nResult < 0)
         {
-            ERR("%s: Fail to write data! errno=%d.", __func__, nResult);
+            ERR("%s: Fail to write data! errno=%d.", __func__, errno);
             nRet = TP_ERR_IO_ERROR;
+
+            // Node removed (panel reset & re-enumerated), retrying this fd is pointless
+            if ((errno == ENODEV) || (errno == EIO))
+            {
+                bNodeGone = true;
+                break;
+            }
         }
-        else if ((unsigned)nResult != m_outBufSize)
+        else if (nResult != nReportLen)
         {
-            ERR("%s: Fail to write data! (write_bytes=%d, data_total=%d)", __func__, nResult, m_outBufSize);
+            ERR("%s: Fail to write data! (write_bytes=%d, data_total=%d)", __func__, nResult, nReportLen);
             nRet = TP_ERR_IO_ERROR;
         }
         else // Write len bytes of data
         {
+            RecordReport(HIDRAW_TRACE_DIR_OUTPUT, m_outBuf, nResult);
+
+            // Responses now come back on input reports
+            m_devices[nDevIdx].bFeaturePending = false;
+
+            // Key latency by command opcode, response timer starts here
+            m_ullWriteDoneNs = CHidrawLatencyStats::NowNs();
+            m_nPendingOpcode = CHidrawLatencyStats::GetOpcode(m_outBuf, nLen);
+            if (m_nPendingOpcode >= 0)
+                m_latencyStats.RecordWrite((unsigned char)m_nPendingOpcode, m_ullWriteDoneNs - ullWriteStartNs);
+
             nRet = TP_SUCCESS;
             break;
         }
@@ -244,7 +657,20 @@ int CI2CHIDLinuxGet::WriteRawBytes(unsigned char* pszBuf, int nLen, int nTimeout
     // Mutex unlocks the critical section
     sem_post(&m_ioMutex);
 
+    // Send once more on the re-created node
+    if (bNodeGone && !bReopened && (m_nHotplugReopenTimeoutMS > 0))
+    {
+        bReopened = true;
+        bNodeGone = false;
+
+        // Let other panels on the adapter run while waiting for the node to return
+        hidraw_bus_release();
+        if (ReopenDevice(nDevIdx, m_nHotplugReopenTimeoutMS) == TP_SUCCESS)
+            goto WRITE_RAW_BYTES_RETRY;
+    }
+
 WRITE_RAW_BYTES_EXIT:
+    ELAN_PROBE1(hidraw_write_return, nRet);
     return nRet;
 }
 
@@ -258,13 +684,18 @@ WRITE_RAW_BYTES_EXIT:
 int CI2CHIDLinuxGet::WriteCommand(unsigned char* pszCommandBuf, int nCommandLen, int nTimeout, int nDevIdx)
 {
     int nRet = TP_SUCCESS;
+    bool bFeature = false;
+    struct hidraw_response_pattern reply;
 
     // Clear Command Raw Buffer
     memset(m_szOutputBuf, 0, sizeof(m_szOutputBuf));
 
     // Insert 3-Byte Header Before Command
-    if (m_usPID == 0x7)
-        m_szOutputBuf[0] = ELAN_HID_OUTPUT_REPORT_ID_PID_B; // HID Report ID
+    bFeature = m_bFeatureChannel && HasFeatureChannel(nDevIdx) && GetFeatureReply(pszCommandBuf, nCommandLen, &reply);
+    if (bFeature)
+        m_szOutputBuf[0] = m_devices[nDevIdx].byFeatureReportID; // HID Report ID
+    else if (IsDevIdxValid(nDevIdx))
+        m_szOutputBuf[0] = m_devices[nDevIdx].byOutReportID; // HID Report ID
     else
         m_szOutputBuf[0] = ELAN_HID_OUTPUT_REPORT_ID; // HID Report ID
     m_szOutputBuf[1] = 0x0; // Bridge Command
@@ -274,7 +705,10 @@ int CI2CHIDLinuxGet::WriteCommand(unsigned char* pszCommandBuf, int nCommandLen,
     memcpy(&m_szOutputBuf[3], pszCommandBuf, nCommandLen);
 
     // Output Command Raw Buffer
-    nRet = WriteRawBytes(m_szOutputBuf, nCommandLen + 3, nTimeout, nDevIdx);
+    if (bFeature)
+        nRet = WriteFeature(m_szOutputBuf, nCommandLen + 3, &reply, nDevIdx);
+    else
+        nRet = WriteRawBytes(m_szOutputBuf, nCommandLen + 3, nTimeout, nDevIdx);
     if (nRet != TP_SUCCESS)
     {
         ERR("%s: Fail to Write Raw Bytes! err=%d.", __func__, nRet);
@@ -283,6 +717,179 @@ int CI2CHIDLinuxGet::WriteCommand(unsigned char* pszCommandBuf, int nCommandLen,
     return nRet;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetFeatureReply()
+// Signature of the single reply of a query command, false if the command may
+// go unanswered or be answered by several reports (kept off the feature channel)
+
+bool CI2CHIDLinuxGet::GetFeatureReply(const unsigned char *pszCommandBuf, int nCommandLen, struct hidraw_response_pattern *pReply)
+{
+    if ((pszCommandBuf == NULL) || (nCommandLen < 2) || (pReply == NULL))
+        return false;
+
+    memset(pReply, 0, sizeof(*pReply));
+    switch (pszCommandBuf[0])
+    {
+    case 0x53: // Get (FW ID / FW Version / BC Version / Re-K Counter ...) => 0x52, Same Sub-Command Nibble
+        pReply->length = 2;
+        pReply->value[0] = 0x52;
+        pReply->mask[0] = 0xFF;
+        pReply->value[1] = pszCommandBuf[1] & 0xF0;
+        pReply->mask[1] = 0xF0;
+        return true;
+
+    case 0x96: // Read ROM Data => 0x95
+        pReply->length = 1;
+        pReply->value[0] = 0x95;
+        pReply->mask[0] = 0xFF;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::WriteFeature()
+// Send a command as vendor feature report (HIDIOCSFEATURE), zero-padded to
+// the feature report length; ReadData() then polls GET_FEATURE for the one
+// report matching pReply
+
+int CI2CHIDLinuxGet::WriteFeature(unsigned char* pszBuf, int nLen, const struct hidraw_response_pattern *pReply, int nDevIdx)
+{
+    int nRet = TP_SUCCESS,
+        nReportLen = 0;
+    unsigned long long ullWriteStartNs = 0;
+
+    if (!HasFeatureChannel(nDevIdx))
+    {
+        ERR("%s: Device #%d has no feature channel!", __func__, nDevIdx);
+        return TP_ERR_INVALID_PARAM;
+    }
+
+    nReportLen = m_devices[nDevIdx].nFeatureReportLen;
+    if ((nLen < 0) || (nLen > nReportLen))
+    {
+        ERR("%s: Data length too large(data=%d, report length=%d).", __func__, nLen, nReportLen);
+        return TP_ERR_INVALID_PARAM;
+    }
+
+    // Hold the I2C adapter for the rest of this burst (no-op if thread is not bound to one)
+    hidraw_bus_acquire();
+
+    // Mutex locks the critical section
+    sem_wait(&m_ioMutex);
+
+    memset(m_outBuf, 0, sizeof(unsigned char)*m_outBufSize);
+    memcpy(m_outBuf, pszBuf, nLen);
+
+    if (g_bEnableOutputBufferDebug == true)
+        DBG_BUFFER("m_outBuf", m_outBuf, nLen);
+
+    ullWriteStartNs = CHidrawLatencyStats::NowNs();
+    if (ioctl(m_devices[nDevIdx].nFd, HIDIOCSFEATURE(nReportLen), m_outBuf) < 0)
+    {
+        ERR("%s: Fail to set feature report 0x%02x! errno=%d.", __func__, m_outBuf[0], errno);
+        nRet = TP_ERR_IO_ERROR;
+    }
+    else
+    {
+        RecordReport(HIDRAW_TRACE_DIR_OUTPUT, m_outBuf, nReportLen);
+        m_devices[nDevIdx].bFeaturePending = true;
+        m_devices[nDevIdx].featureReply = *pReply;
+
+        // Key latency by command opcode, response timer starts here
+        m_ullWriteDoneNs = CHidrawLatencyStats::NowNs();
+        m_nPendingOpcode = CHidrawLatencyStats::GetOpcode(m_outBuf, nLen);
+        if (m_nPendingOpcode >= 0)
+            m_latencyStats.RecordWrite((unsigned char)m_nPendingOpcode, m_ullWriteDoneNs - ullWriteStartNs);
+
+        nRet = TP_SUCCESS;
+    }
+
+    // Mutex unlocks the critical section
+    sem_post(&m_ioMutex);
+
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::ReadFeature()
+// Poll vendor feature report (HIDIOCGFEATURE) until the response is ready,
+// i.e. its length byte (after report ID) is non-zero and its data matches the
+// reply of the pending command, or nTimeout expires. A feature report is
+// state, not a queue: the reply is taken once, later reads go to input reports.
+// Layout matches the input report: | Report ID | Length | Data |
+
+int CI2CHIDLinuxGet::ReadFeature(unsigned char* pszBuf, int nLen, int nTimeout, int nDevIdx)
+{
+    int nRet = TP_ERR_TIMEOUT,
+        nResult = 0,
+        nReportLen = 0;
+    unsigned long long ullDeadlineNs = 0;
+
+    // Waiting on the panel, let other panels on the same I2C adapter transfer meanwhile
+    hidraw_bus_release();
+
+    if (!HasFeatureChannel(nDevIdx))
+    {
+        ERR("%s: Device #%d has no feature channel!", __func__, nDevIdx);
+        return TP_ERR_INVALID_PARAM;
+    }
+
+    nReportLen = m_devices[nDevIdx].nFeatureReportLen;
+    if ((nLen < 0) || (nLen > nReportLen))
+    {
+        ERR("%s: Data length too large(data=%d, report length=%d).", __func__, nLen, nReportLen);
+        return TP_ERR_INVALID_PARAM;
+    }
+
+    ullDeadlineNs = CHidrawLatencyStats::NowNs() + (unsigned long long)nTimeout * 1000000ULL;
+    do
+    {
+        // Each GET_FEATURE is a transfer of its own, adapter & mutex are held only across it
+        hidraw_bus_acquire();
+        sem_wait(&m_ioMutex);
+
+        memset(m_inBuf, 0, sizeof(unsigned char)*m_inBufSize);
+        m_inBuf[0] = m_devices[nDevIdx].byFeatureReportID;
+        nResult = ioctl(m_devices[nDevIdx].nFd, HIDIOCGFEATURE(nReportLen), m_inBuf);
+        if (nResult < 0)
+        {
+            ERR("%s: Fail to get feature report 0x%02x! errno=%d.", __func__, m_devices[nDevIdx].byFeatureReportID, errno);
+            nRet = TP_ERR_IO_ERROR;
+        }
+        else if ((nResult > 2) && (m_inBuf[1] != 0) &&
+                 CHidrawResponseQueue::Match(&m_devices[nDevIdx].featureReply, m_inBuf, nResult))
+        {
+            RecordReport(HIDRAW_TRACE_DIR_INPUT, m_inBuf, nResult);
+            DBG_BUFFER("m_inBuf", m_inBuf, nLen);
+            memcpy(pszBuf, m_inBuf, nLen);
+            m_devices[nDevIdx].bFeaturePending = false;
+            nRet = TP_SUCCESS;
+        }
+
+        if (nRet != TP_ERR_TIMEOUT)
+            RecordReadLatency(nRet, true); // Only Matching Replies Succeed
+
+        sem_post(&m_ioMutex);
+        hidraw_bus_release();
+
+        if (nRet != TP_ERR_TIMEOUT)
+            return nRet;
+
+        // Response not ready yet
+        usleep(I2CHID_FEATURE_POLL_INTERVAL_USEC);
+    } while (CHidrawLatencyStats::NowNs() < ullDeadlineNs);
+
+    DBG("%s: timeout (%d ms)!", __func__, nTimeout);
+    sem_wait(&m_ioMutex);
+    RecordReadLatency(nRet, false);
+    sem_post(&m_ioMutex);
+
+    return nRet;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CI2CHIDLinuxGet::ReadRawBytes()
 // Read Data from HID device
@@ -293,6 +900,18 @@ int CI2CHIDLinuxGet::ReadRawBytes(unsigned char* pszBuf, int nLen, int nTimeout,
 {
     int nRet = TP_SUCCESS,
         nError = 0;
+    bool bNodeGone = false;
+
+    ELAN_PROBE2(hidraw_read_entry, nLen, nTimeout);
+
+    // Waiting on the panel, let other panels on the same I2C adapter transfer meanwhile
+    hidraw_bus_release();
+
+    if (!IsDevIdxValid(nDevIdx))
+    {
+        ERR("%s: Device #%d not opened!", __func__, nDevIdx);
+        return TP_ERR_INVALID_PARAM;
+    }
 
     // Mutex locks the critical section
     sem_wait(&m_ioMutex);
@@ -301,14 +920,14 @@ int CI2CHIDLinuxGet::ReadRawBytes(unsigned char* pszBuf, int nLen, int nTimeout,
     FD_ZERO(&m_fdsHidraw);
 
     // Add hidraw device handler to file descriptor monitor
-    FD_SET(m_nHidrawFd, &m_fdsHidraw);
+    FD_SET(m_devices[nDevIdx].nFd, &m_fdsHidraw);
 
     // Set wait time up to nTimeout millisecond
     m_tvRead.tv_sec = nTimeout / 1000; // sec
     m_tvRead.tv_usec = (nTimeout % 1000) * 1000; // usec
 
     // Add file descriptor & timeout to file descriptor monitor
-    nError = select(m_nHidrawFd + 1, &m_fdsHidraw, NULL, NULL, &m_tvRead);
+    nError = select(m_devices[nDevIdx].nFd + 1, &m_fdsHidraw, NULL, NULL, &m_tvRead);
     if (nError < 0)
     {
         ERR("%s: File descriptor monitor select fail! errno=%d.", __func__, nError);
@@ -325,16 +944,19 @@ int CI2CHIDLinuxGet::ReadRawBytes(unsigned char* pszBuf, int nLen, int nTimeout,
     {
         memset(m_inBuf, 0, sizeof(unsigned char)*m_inBufSize);
 
-        if (FD_ISSET(m_nHidrawFd, &m_fdsHidraw))
+        if (FD_ISSET(m_devices[nDevIdx].nFd, &m_fdsHidraw))
         {
-            nError = read(m_nHidrawFd, m_inBuf, m_inBufSize);
+            nError = read(m_devices[nDevIdx].nFd, m_inBuf, m_inBufSize);
             if (nError < 0)
             {
-                ERR("%s: Fail to Read Data! errno=%d.", __func__, nError);
+                ERR("%s: Fail to Read Data! errno=%d.", __func__, errno);
                 nRet = TP_ERR_IO_ERROR;
+                bNodeGone = (errno == ENODEV) || (errno == EIO);
                 goto READ_RAW_BYTES_EXIT;
             }
 
+            RecordReport(HIDRAW_TRACE_DIR_INPUT, m_inBuf, nError);
+
             //DBG("Succesfully read %d bytes.\n", nError);
             nRet = TP_SUCCESS;
         }
@@ -342,18 +964,22 @@ int CI2CHIDLinuxGet::ReadRawBytes(unsigned char* pszBuf, int nLen, int nTimeout,
 
     //DBG("Successfully read %d bytes of data from device, return %d.", transfer_cnt, ret);
 
-#if defined(__ENABLE_DEBUG__) && defined(__ENABLE_INBUF_DEBUG__)
-    if (g_bEnableDebug)
-        DebugPrintBuffer("m_inBuf", m_inBuf, nLen);
-#endif //__ENABLE_DEBUG__ && __ENABLE_INBUF_DEBUG__
+    DBG_BUFFER("m_inBuf", m_inBuf, nLen);
 
     // Copy inBuf data to input buffer pointer
     memcpy(pszBuf, m_inBuf, ((unsigned)nLen <= m_inBufSize) ? nLen : m_inBufSize);
 
 READ_RAW_BYTES_EXIT:
+    RecordReadLatency(nRet, m_inBuf[0] == m_devices[nDevIdx].byInReportID);
+
     // Mutex unlocks the critical section
     sem_post(&m_ioMutex);
 
+    // Response is lost with the removed node; reopen so the caller's retry reaches the panel
+    if (bNodeGone && (m_nHotplugReopenTimeoutMS > 0) && (ReopenDevice(nDevIdx, m_nHotplugReopenTimeoutMS) == TP_SUCCESS))
+        nRet = TP_ERR_TIMEOUT;
+
+    ELAN_PROBE1(hidraw_read_return, nRet);
     return nRet;
 }
 
@@ -362,9 +988,19 @@ int CI2CHIDLinuxGet::ReadGhostRawBytes(unsigned char* pszBuf, int nLen, int nTim
 {
     int nRet = TP_SUCCESS,
         nError = 0;
+    bool bNodeGone = false;
 
     //DBG("Read start, cBuf=%p, nLen=%d.", cBuf, (int)nLen);
 
+    // Waiting on the panel, let other panels on the same I2C adapter transfer meanwhile
+    hidraw_bus_release();
+
+    if (!IsDevIdxValid(nDevIdx))
+    {
+        ERR("%s: Device #%d not opened!", __func__, nDevIdx);
+        return TP_ERR_INVALID_PARAM;
+    }
+
     // Mutex locks the critical section
     sem_wait(&m_ioMutex);
 
@@ -372,14 +1008,14 @@ int CI2CHIDLinuxGet::ReadGhostRawBytes(unsigned char* pszBuf, int nLen, int nTim
     FD_ZERO(&m_fdsHidraw);
 
     // Add hidraw device handler to file descriptor monitor
-    FD_SET(m_nHidrawFd, &m_fdsHidraw);
+    FD_SET(m_devices[nDevIdx].nFd, &m_fdsHidraw);
 
     // Set wait time up to nTimeout millisecond
     m_tvRead.tv_sec = nTimeout / 1000; // sec
     m_tvRead.tv_usec = (nTimeout % 1000) * 1000; // usec
 
     // Add file descriptor & timeout to file descriptor monitor
-    nError = select(m_nHidrawFd + 1, &m_fdsHidraw, NULL, NULL, &m_tvRead);
+    nError = select(m_devices[nDevIdx].nFd + 1, &m_fdsHidraw, NULL, NULL, &m_tvRead);
     if (nError < 0)
     {
         ERR("%s: File descriptor monitor select fail! errno=%d.", __func__, nError);
@@ -396,16 +1032,19 @@ int CI2CHIDLinuxGet::ReadGhostRawBytes(unsigned char* pszBuf, int nLen, int nTim
     {
         memset(m_inBuf, 0, sizeof(unsigned char)*m_inBufSize);
 
-        if (FD_ISSET(m_nHidrawFd, &m_fdsHidraw))
+        if (FD_ISSET(m_devices[nDevIdx].nFd, &m_fdsHidraw))
         {
-            nError = read(m_nHidrawFd, m_inBuf, m_inBufSize);
+            nError = read(m_devices[nDevIdx].nFd, m_inBuf, m_inBufSize);
             if (nError < 0)
             {
-                ERR("%s: Fail to Read Data! errno=%d.", __func__, nError);
+                ERR("%s: Fail to Read Data! errno=%d.", __func__, errno);
                 nRet = TP_ERR_IO_ERROR;
+                bNodeGone = (errno == ENODEV) || (errno == EIO);
                 goto READ_RAW_BYTES_EXIT;
             }
 
+            RecordReport(HIDRAW_TRACE_DIR_INPUT, m_inBuf, nError);
+
             //DBG("Succesfully read %d bytes.\n", nError);
             nRet = TP_SUCCESS;
         }
@@ -413,18 +1052,21 @@ int CI2CHIDLinuxGet::ReadGhostRawBytes(unsigned char* pszBuf, int nLen, int nTim
 
     //DBG("Successfully read %d bytes of data from device, return %d.", transfer_cnt, ret);
 
-#ifdef __ENABLE_DEBUG__
-    if (g_bEnableDebug)
-        DebugPrintBuffer("m_inBuf", m_inBuf, nLen);
-#endif //__ENABLE_DEBUG__
+    DBG_BUFFER("m_inBuf", m_inBuf, nLen);
 
     // Copy inBuf data to input buffer pointer
     memcpy(pszBuf, m_inBuf, ((unsigned)nLen <= m_inBufSize) ? nLen : m_inBufSize);
 
 READ_RAW_BYTES_EXIT:
+    RecordReadLatency(nRet, m_inBuf[0] == m_devices[nDevIdx].byInReportID);
+
     // Mutex unlocks the critical section
     sem_post(&m_ioMutex);
 
+    // Response is lost with the removed node; reopen so the caller's retry reaches the panel
+    if (bNodeGone && (m_nHotplugReopenTimeoutMS > 0) && (ReopenDevice(nDevIdx, m_nHotplugReopenTimeoutMS) == TP_SUCCESS))
+        nRet = TP_ERR_TIMEOUT;
+
     return nRet;
 }
 
@@ -439,12 +1081,18 @@ int CI2CHIDLinuxGet::ReadData(unsigned char* pszDataBuf, int nDataLen, int nTime
 {
     int nRet = TP_SUCCESS,
         nReportID = 0;
+    bool bFeature = false;
 
     // Clear Data Raw Buffer
     memset(m_szInputBuf, 0, sizeof(m_szInputBuf));
 
     // Read 2-Byte Header & Command Data to Data Raw Buffer
-    nRet = ReadRawBytes(m_szInputBuf, nDataLen + 2, nTimeout, nDevIdx);
+    // (Response of a feature command comes from the feature report, no touch / pen reports in between)
+    bFeature = IsDevIdxValid(nDevIdx) && m_devices[nDevIdx].bFeaturePending;
+    if (bFeature)
+        nRet = ReadFeature(m_szInputBuf, nDataLen + 2, nTimeout, nDevIdx);
+    else
+        nRet = ReadRawBytes(m_szInputBuf, nDataLen + 2, nTimeout, nDevIdx);
     if (nRet == TP_ERR_TIMEOUT)
     {
         DBG("%s: Fail to Read Raw Bytes! err=0x%x.", __func__, nRet);
@@ -457,16 +1105,14 @@ int CI2CHIDLinuxGet::ReadData(unsigned char* pszDataBuf, int nDataLen, int nTime
     }
 
     // Set Report ID Number for Checking
-    if (m_usPID == 0xb)
-        nReportID = ELAN_HID_INPUT_REPORT_ID_PID_B; // HID Report ID
-    else
-        nReportID = ELAN_HID_INPUT_REPORT_ID; // HID Report ID
+    nReportID = (bFeature) ? m_devices[nDevIdx].byFeatureReportID : m_devices[nDevIdx].byInReportID; // HID Report ID
 
     // Check if Report ID of Packet is correct
     if ((m_szInputBuf[0] != nReportID) &&
-        (m_szInputBuf[0] != ELAN_HID_FINGER_REPORT_ID) &&
-        (m_szInputBuf[0] != ELAN_HID_PEN_REPORT_ID)	 &&
-        (m_szInputBuf[0] != ELAN_HID_PEN_DEBUG_REPORT_ID))
+        (bFeature ||
+         ((m_szInputBuf[0] != ELAN_HID_FINGER_REPORT_ID) &&
+          (m_szInputBuf[0] != ELAN_HID_PEN_REPORT_ID)	 &&
+          (m_szInputBuf[0] != ELAN_HID_PEN_DEBUG_REPORT_ID))))
     {
         nRet = TP_ERR_DATA_PATTERN;
         goto READ_DATA_EXIT;
@@ -487,6 +1133,105 @@ READ_DATA_EXIT:
     return nRet;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::ReadResponse()
+// Wait up to nTimeout ms for the response matching pPattern (NULL: any).
+// A response queued by an earlier wait is taken first. Responses read that
+// do not match are queued for later waits, touch & pen reports are dropped,
+// so neither fails the wait. Several commands may be outstanding at once.
+
+int CI2CHIDLinuxGet::ReadResponse(const struct hidraw_response_pattern *pPattern, unsigned char* pszDataBuf, int nDataLen, int nTimeout, int nDevIdx, bool bFilter)
+{
+    int nRet = TP_SUCCESS,
+        nReportID = 0,
+        nReadLen = 0,
+        nRemainMS = 0;
+    unsigned long long ullDeadlineNs = 0,
+                       ullNowNs = 0;
+    unsigned char byReport[HIDRAW_RESPONSE_REPORT_LEN_MAX];
+    bool bFound = false;
+
+    if ((pszDataBuf == NULL) || (nDataLen < 0) || (nDataLen + HIDRAW_RESPONSE_DATA_OFFSET > HIDRAW_RESPONSE_REPORT_LEN_MAX))
+    {
+        ERR("%s: Input Parameters Invalid! (pszDataBuf=%p, nDataLen=%d)", __func__, pszDataBuf, nDataLen);
+        nRet = TP_ERR_INVALID_PARAM;
+        goto READ_RESPONSE_EXIT;
+    }
+
+    if (!IsDevIdxValid(nDevIdx))
+    {
+        ERR("%s: Device #%d not opened!", __func__, nDevIdx);
+        nRet = TP_ERR_INVALID_PARAM;
+        goto READ_RESPONSE_EXIT;
+    }
+
+    // Answer may have come in while waiting for another response
+    sem_wait(&m_ioMutex);
+    bFound = m_responseQueues[nDevIdx].Take(pPattern, byReport, sizeof(byReport));
+    sem_post(&m_ioMutex);
+
+    ullDeadlineNs = CHidrawLatencyStats::NowNs() + (unsigned long long)nTimeout * 1000000ULL;
+    while (!bFound)
+    {
+        ullNowNs = CHidrawLatencyStats::NowNs();
+        if (ullNowNs >= ullDeadlineNs)
+        {
+            DBG("%s: timeout (%d ms)!", __func__, nTimeout);
+            nRet = TP_ERR_TIMEOUT;
+            goto READ_RESPONSE_EXIT;
+        }
+        nRemainMS = (int)((ullDeadlineNs - ullNowNs + 999999ULL) / 1000000ULL);
+
+        memset(byReport, 0, sizeof(byReport));
+        if (m_devices[nDevIdx].bFeaturePending)
+        {
+            nReportID = m_devices[nDevIdx].byFeatureReportID;
+            nReadLen = ((int)sizeof(byReport) <= m_devices[nDevIdx].nFeatureReportLen) ? (int)sizeof(byReport) : m_devices[nDevIdx].nFeatureReportLen;
+            nRet = ReadFeature(byReport, nReadLen, nRemainMS, nDevIdx);
+        }
+        else
+        {
+            nReportID = m_devices[nDevIdx].byInReportID;
+            nRet = ReadRawBytes(byReport, sizeof(byReport), nRemainMS, nDevIdx);
+        }
+        if (nRet != TP_SUCCESS)
+            goto READ_RESPONSE_EXIT;
+
+        // Touch / pen report, not a response
+        if (byReport[0] != nReportID)
+            continue;
+
+        if (CHidrawResponseQueue::Match(pPattern, byReport, sizeof(byReport)))
+        {
+            bFound = true;
+            break;
+        }
+
+        // Late answer or answer of another outstanding command, keep it for its own wait
+        DBG("%s: Queue unmatched response %02x %02x %02x %02x.", __func__, byReport[2], byReport[3], byReport[4], byReport[5]);
+        sem_wait(&m_ioMutex);
+        m_responseQueues[nDevIdx].Push(byReport, sizeof(byReport));
+        sem_post(&m_ioMutex);
+    }
+
+    if (bFilter == true)
+    {
+        // Strip 2-Byte Report Header & Load Data to Buffer
+        memcpy(pszDataBuf, &byReport[HIDRAW_RESPONSE_DATA_OFFSET], nDataLen);
+    }
+    else // if(bFilter == false)
+    {
+        // Load Report Header & Data to Buffer
+        memcpy(pszDataBuf, byReport, nDataLen);
+    }
+
+    // Success
+    nRet = TP_SUCCESS;
+
+READ_RESPONSE_EXIT:
+    return nRet;
+}
+
 int CI2CHIDLinuxGet::ReadGhostData(unsigned char* pszDataBuf, int nDataLen, int nTimeout, int nDevIdx, bool bFilter)
 {
     int nRet = TP_SUCCESS,
@@ -504,10 +1249,7 @@ int CI2CHIDLinuxGet::ReadGhostData(unsigned char* pszDataBuf, int nDataLen, int
     }
 
     // Set Report ID Number for Checking
-    if (m_usPID == 0xb)
-        nReportID = ELAN_HID_INPUT_REPORT_ID_PID_B; // HID Report ID
-    else
-        nReportID = ELAN_HID_INPUT_REPORT_ID; // HID Report ID
+    nReportID = m_devices[nDevIdx].byInReportID; // HID Report ID
 
     // Check if Report ID of Packet is correct
     if ((m_szInputBuf[0] != nReportID) &&
@@ -551,7 +1293,7 @@ int	CI2CHIDLinuxGet::GetDevVidPid(unsigned int* p_nVid, unsigned int* p_nPid, in
     }
 
     // Make Sure Device Found
-    if((m_usVID == 0) && (m_usPID == 0))
+    if((nDevIdx < 0) || (nDevIdx >= I2CHID_MAX_DEVICES) || ((m_devices[nDevIdx].usVID == 0) && (m_devices[nDevIdx].usPID == 0)))
     {
         ERR("%s: I2C-HID device has never been found!\r\n", __func__);
         nRet = TP_ERR_NOT_FOUND_DEVICE;
@@ -559,8 +1301,8 @@ int	CI2CHIDLinuxGet::GetDevVidPid(unsigned int* p_nVid, unsigned int* p_nPid, in
     }
 
     // Set PID & VID
-    *p_nVid = m_usVID;
-    *p_nPid = m_usPID;
+    *p_nVid = m_devices[nDevIdx].usVID;
+    *p_nPid = m_devices[nDevIdx].usPID;
 
     // Success
     nRet = TP_SUCCESS;
@@ -569,6 +1311,160 @@ GET_DEV_VID_PID_EXIT:
     return nRet;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetDevFd()
+// Return hidraw file descriptor, so callers can wait on many devices at once
+// Reports must still be read through ReadData() / ReadRawBytes()
+
+int CI2CHIDLinuxGet::GetDevFd(int nDevIdx)
+{
+    return (IsDevIdxValid(nDevIdx)) ? m_devices[nDevIdx].nFd : -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetDevCount()
+// Return number of opened devices
+
+int CI2CHIDLinuxGet::GetDevCount(void)
+{
+    return m_nDevCount;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetDevPath()
+// Return hidraw node path of device nDevIdx, such as /dev/hidraw0
+
+int CI2CHIDLinuxGet::GetDevPath(int nDevIdx, char *pszDevPath, int nLen)
+{
+    if ((pszDevPath == NULL) || (nLen <= 0))
+        return TP_ERR_INVALID_PARAM;
+
+    if (!IsDevIdxValid(nDevIdx))
+        return TP_ERR_NOT_FOUND_DEVICE;
+
+    if (snprintf(pszDevPath, nLen, "%s", m_devices[nDevIdx].szPath) >= nLen)
+        return TP_ERR_INVALID_PARAM;
+
+    return TP_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetDevVersion()
+// Return HID version (wVersionID of HID descriptor) of device nDevIdx
+
+int CI2CHIDLinuxGet::GetDevVersion(unsigned int* p_nVer, int nDevIdx)
+{
+    if (p_nVer == NULL)
+        return TP_ERR_INVALID_PARAM;
+
+    if (!IsDevIdxValid(nDevIdx))
+        return TP_ERR_NOT_FOUND_DEVICE;
+
+    *p_nVer = m_devices[nDevIdx].usVersion;
+    return TP_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::EnableTrace()
+// Record every hidraw report written / read to a binary trace file
+
+int CI2CHIDLinuxGet::EnableTrace(const char *pszTracePath)
+{
+    int nRet = TP_SUCCESS;
+
+    sem_wait(&m_ioMutex);
+    nRet = m_hidrawTrace.Open(pszTracePath);
+    sem_post(&m_ioMutex);
+
+    if (nRet != TP_SUCCESS)
+        ERR("%s: Fail to open trace file \"%s\"! err=0x%x.", __func__, (pszTracePath) ? pszTracePath : "(null)", nRet);
+
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::DisableTrace()
+// Flush & close the binary trace file
+
+void CI2CHIDLinuxGet::DisableTrace(void)
+{
+    sem_wait(&m_ioMutex);
+    m_hidrawTrace.Close();
+    sem_post(&m_ioMutex);
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::DumpFlightRecorder()
+// Write the last reports of each direction to the flight recorder file
+
+int CI2CHIDLinuxGet::DumpFlightRecorder(void)
+{
+    int nRet = TP_SUCCESS;
+
+    sem_wait(&m_ioMutex);
+    nRet = m_flightRecorder.Dump();
+    sem_post(&m_ioMutex);
+
+    if (nRet != TP_SUCCESS)
+        ERR("%s: Fail to dump flight recorder to \"%s\"! err=0x%x.", __func__, m_flightRecorder.GetDumpPath(), nRet);
+    else
+        INFO("%s: Flight recorder dumped to \"%s\".", __func__, m_flightRecorder.GetDumpPath());
+
+    return nRet;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::RecordReport()
+// Feed a transferred report to flight recorder (& trace file if enabled)
+// Caller holds m_ioMutex
+
+void CI2CHIDLinuxGet::RecordReport(int nDirection, const unsigned char *pbyBuf, int nLen)
+{
+    m_flightRecorder.Record(nDirection, pbyBuf, nLen);
+    m_hidrawTrace.Record(nDirection, pbyBuf, nLen);
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::RecordReadLatency()
+// First vendor report read after a write completes its response latency
+// (touch / pen reports in between do not), a timeout while waiting is
+// counted against the pending opcode
+// Caller holds m_ioMutex
+
+void CI2CHIDLinuxGet::RecordReadLatency(int nRet, bool bVendorReport)
+{
+    if (m_nPendingOpcode < 0)
+        return;
+
+    if ((nRet == TP_SUCCESS) && bVendorReport)
+    {
+        m_latencyStats.RecordResponse((unsigned char)m_nPendingOpcode, CHidrawLatencyStats::NowNs() - m_ullWriteDoneNs);
+        m_nPendingOpcode = -1;
+    }
+    else if (nRet == TP_ERR_TIMEOUT)
+    {
+        m_latencyStats.RecordTimeout((unsigned char)m_nPendingOpcode);
+    }
+
+    return;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::PrintLatencyStats()
+// Print p50 / p90 / p99 / max of write & response latency per opcode
+
+void CI2CHIDLinuxGet::PrintLatencyStats(FILE *pStream)
+{
+    // Histograms are updated atomically, no need to hold m_ioMutex
+    m_latencyStats.PrintSummary(pStream);
+
+    return;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // CI2CHIDLinuxGet::GetInBufferSize()
 // Return Input Buffer Size
@@ -576,7 +1472,7 @@ GET_DEV_VID_PID_EXIT:
 int CI2CHIDLinuxGet::GetInBufferSize(void)
 {
     //DBG("Current Input Buffer Size = %d.", m_inBufSize);
-    return m_inBufSize;
+    return GetInReportLength(0);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -586,7 +1482,34 @@ int CI2CHIDLinuxGet::GetInBufferSize(void)
 int CI2CHIDLinuxGet::GetOutBufferSize(void)
 {
     //DBG("Current Output Buffer Size = %d.", m_outBufSize);
-    return m_outBufSize;
+    return GetOutReportLength(0);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetOutReportID()
+// Return vendor output report ID of device nDevIdx (default if not opened)
+
+int CI2CHIDLinuxGet::GetOutReportID(int nDevIdx)
+{
+    return (IsDevIdxValid(nDevIdx)) ? m_devices[nDevIdx].byOutReportID : ELAN_HID_OUTPUT_REPORT_ID;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetOutReportLength()
+// Return bytes written per output report of device nDevIdx, report ID included
+
+int CI2CHIDLinuxGet::GetOutReportLength(int nDevIdx)
+{
+    return (IsDevIdxValid(nDevIdx)) ? m_devices[nDevIdx].nOutReportLen : ELAN_I2CHID_OUTPUT_BUFFER_SIZE;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::GetInReportLength()
+// Return bytes of vendor input report of device nDevIdx
+
+int CI2CHIDLinuxGet::GetInReportLength(int nDevIdx)
+{
+    return (IsDevIdxValid(nDevIdx)) ? m_devices[nDevIdx].nInReportLen : ELAN_I2CHID_INPUT_BUFFER_SIZE;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -639,7 +1562,67 @@ const char* CI2CHIDLinuxGet::bus_str(int bus)
 ////////////////////////////////////////////////////////////////////////////
 // CI2CHIDLinuxGet::FindHidrawDevice()
 // Find hidraw device name with specific VID and PID, such as /dev/hidraw0
+// Identity comes from sysfs (HID_ID of uevent), so no device node is opened;
+// only falls back to opening every /dev/hidraw* if sysfs is not available
 int CI2CHIDLinuxGet::FindHidrawDevice(int nVID, int nPID, char *pszDevicePath)
+{
+    int nRet = TP_SUCCESS,
+        nIndex = 0,
+        nCount = 0;
+    bool bFound = false;
+    struct hidraw_sysfs_info nodes[HIDRAW_SYSFS_MAX_NODES];
+
+    // Check if filename ptr is valid
+    if (pszDevicePath == NULL)
+    {
+        ERR("%s: NULL Device Path Buffer!", __func__);
+        nRet = TP_ERR_INVALID_PARAM;
+        goto FIND_HIDRAW_DEVICE_EXIT;
+    }
+
+    if (hidraw_sysfs_scan(nodes, HIDRAW_SYSFS_MAX_NODES, &nCount) != TP_SUCCESS)
+    {
+        DBG("%s: %s not available, scan /dev instead.", __func__, HIDRAW_SYSFS_CLASS_DIR);
+        nRet = FindHidrawDeviceInDev(nVID, nPID, pszDevicePath);
+        goto FIND_HIDRAW_DEVICE_EXIT;
+    }
+
+    for (nIndex = 0; nIndex < nCount; nIndex++)
+    {
+        DBG("%s: %s: bustype=0x%02x (%s), vendor=0x%04x, product=0x%04x.", __func__,
+            nodes[nIndex].name, nodes[nIndex].bus_type, bus_str(nodes[nIndex].bus_type), nodes[nIndex].vid, nodes[nIndex].pid);
+
+        // Same rule as the /dev scan: PID 0 takes the first Elan device on BUS_I2C
+        if ((nodes[nIndex].bus_type == BUS_I2C) &&
+            (nodes[nIndex].vid == ELAN_USB_VID) &&
+            (nPID == ELAN_USB_FORCE_CONNECT_PID))
+        {
+            nPID = nodes[nIndex].pid;
+            DBG("%s: bustype=0x%02x, VID=0x%04x, PID=0x%04x => PID changes to 0x%04x.", __func__, BUS_I2C, ELAN_USB_VID, ELAN_USB_FORCE_CONNECT_PID, nPID);
+        }
+
+        if ((nodes[nIndex].vid == (unsigned int)nVID) && (nodes[nIndex].pid == (unsigned int)nPID))
+        {
+            DBG("%s: Found hidraw device with VID 0x%x and PID 0x%x!", __func__, nVID, nPID);
+            m_devices[0].usVID = (unsigned short) nVID;
+            m_devices[0].usPID = (unsigned short) nPID;
+            sprintf(pszDevicePath, "/dev/%s", nodes[nIndex].name);
+            bFound = true;
+            break;
+        }
+    }
+
+    if (!bFound)
+        nRet = TP_ERR_NOT_FOUND_DEVICE;
+
+FIND_HIDRAW_DEVICE_EXIT:
+    return nRet;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// CI2CHIDLinuxGet::FindHidrawDeviceInDev()
+// Fallback of FindHidrawDevice(): open every /dev/hidraw* and ask HIDIOCGRAWINFO
+int CI2CHIDLinuxGet::FindHidrawDeviceInDev(int nVID, int nPID, char *pszDevicePath)
 {
     int nRet = TP_SUCCESS,
         nError = 0,
@@ -711,8 +1694,8 @@ int CI2CHIDLinuxGet::FindHidrawDevice(int nVID, int nPID, char *pszDevicePath)
             if ((info.vendor == nVID) && (info.product == nPID))
             {
                 DBG("%s: Found hidraw device with VID 0x%x and PID 0x%x!", __func__, nVID, nPID);
-                m_usVID = (unsigned short) nVID;
-                m_usPID = (unsigned short) nPID;
+                m_devices[0].usVID = (unsigned short) nVID;
+                m_devices[0].usPID = (unsigned short) nPID;
                 memcpy(pszDevicePath, szFile, sizeof(szFile));
                 bFound = true;
             }
@@ -12,13 +12,22 @@
 #include <stdint.h>
 #include <string.h>
 #include <getopt.h>
+#include <signal.h>		/* sigaction, raise */
 #include "I2CHIDLinuxGet.h"
+#include "ElanTsDeviceIo.h"
 #include "ElanTsI2chidUtility.h"
 #include "ElanTsFuncApi.h"
 #include "ElanTsFwFileIoUtility.h"
 #include "ElanTsFwUpdateFlow.h"
 #include "ElanGen8TsI2chidHwParameters.h"
+#include "ElanTsChipCapability.h"
 #include "ElanGen8TsFwUpdateFlow.h"
+#include "ElanTsPhaseTiming.h"
+#include "ElanTsTraceEvent.h"
+#include "ElanTsRunMetrics.h"
+#include "ElanTsDaemon.h"
+#include "ElanTsManifest.h"
+#include "HidrawHotplug.h"
 
 /*******************************************
  * Definitions
@@ -48,23 +57,28 @@
  * Global Variables Declaration
  ******************************************/
 
-// Debug
-bool g_debug = false;
+// DEBUG_PRINTF / ERROR_PRINTF: See LogLevel.h
 
-#ifndef DEBUG_PRINTF
-#define DEBUG_PRINTF(fmt, argv...) if(g_debug) printf(fmt, ##argv)
-#endif //DEBUG_PRINTF
-
-#ifndef ERROR_PRINTF
-#define ERROR_PRINTF(fmt, argv...) fprintf(stderr, fmt, ##argv)
-#endif //ERROR_PRINTF
-
-// InterfaceGet Class
-CI2CHIDLinuxGet *g_pIntfGet = NULL;		// Pointer to I2CHID Inteface Class (CI2CHIDLinuxGet)
+// Debug (g_debug) & InterfaceGet Class (g_pIntfGet, Thread-Local): See ElanTsDeviceIo.h
 
 // PID
 int g_pid = ELAN_USB_FORCE_CONNECT_PID;
 
+// hidraw Node Given Directly (Skips Discovery)
+char g_device_path[64] = {0};
+
+// List Every Elan Panel of the Host
+bool g_list_devices = false;
+
+// Wait for hidraw Node to Appear before Connecting (Seconds, 0: No Wait)
+int g_wait_for_device_sec = 0;
+
+// Time Given to a Reset Panel's Node to Come Back (Milliseconds, 0: No Reopen)
+int g_reopen_timeout_msec = HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC;
+
+// Query Commands through Vendor Feature Report
+bool g_feature_channel = false;
+
 // Flag for Firmware Update
 bool g_update_fw = false;
 
@@ -88,6 +102,29 @@ int g_skip_action_code = 0;
 char g_log_file[FILE_NAME_LENGTH_MAX] = {0};
 #endif //__SUPPORT_RESULT_LOG__
 
+// Binary hidraw Trace File
+char g_trace_file[FILE_NAME_LENGTH_MAX] = {0};
+
+// Phase Timing Output File
+bool g_phase_timing = false;
+char g_timing_file[FILE_NAME_LENGTH_MAX] = {0};
+
+// Chrome Trace-Event (Perfetto) Output File
+char g_trace_json_file[FILE_NAME_LENGTH_MAX] = {0};
+
+// hidraw Latency Statistics
+bool g_latency_stats = false;
+
+// OpenMetrics (Prometheus Textfile) Output File
+char g_metrics_file[FILE_NAME_LENGTH_MAX] = {0};
+
+// Daemon Mode (Unix Socket Path)
+char g_daemon_socket[FILE_NAME_LENGTH_MAX] = {0};
+
+// Fleet Manifest & Concurrency Limit
+char g_manifest_file[FILE_NAME_LENGTH_MAX] = {0};
+int g_max_parallel = MANIFEST_DEFAULT_MAX_PARALLEL;
+
 // Message Mode
 message_mode_t	g_msg_mode = FULL_MESSAGE;
 
@@ -96,14 +133,20 @@ bool g_help = false;
 
 // Parameter Option Settings
 #ifdef __SUPPORT_RESULT_LOG__
-const char* const short_options = "p:P:f:s:oikcl:qdh";
+const char* const short_options = "p:P:f:s:oikcl:t:T:J:m:qdvh";
 #else
-const char* const short_options = "p:P:f:s:oikcqdh";
+const char* const short_options = "p:P:f:s:oikct:T:J:m:qdvh";
 #endif //__SUPPORT_RESULT_LOG__
 const struct option long_options[] =
 {
     { "pid",					1, NULL, 'p'},
     { "pid_hex",				1, NULL, 'P'},
+    { "device",					1, NULL, 'H'},	// Long Option Only
+    { "list-devices",			0, NULL, 'L'},	// Long Option Only
+    { "wait-for-device",		1, NULL, 'W'},	// Long Option Only
+    { "dev-dir",				1, NULL, 'R'},	// Long Option Only
+    { "reopen-timeout",			1, NULL, 'O'},	// Long Option Only
+    { "feature-channel",		0, NULL, 'C'},	// Long Option Only
     { "file_path",				1, NULL, 'f'},
     { "skip_action",			1, NULL, 's'},
     { "firmware_information",	0, NULL, 'i'},
@@ -112,8 +155,17 @@ const struct option long_options[] =
 #ifdef __SUPPORT_RESULT_LOG__
     { "log_filename",			1, NULL, 'l'},
 #endif //__SUPPORT_RESULT_LOG__
+    { "trace",					1, NULL, 't'},
+    { "timing",					1, NULL, 'T'},
+    { "trace-json",				1, NULL, 'J'},
+    { "stats",					0, NULL, 'S'},	// Long Option Only
+    { "metrics",				1, NULL, 'm'},
+    { "daemon",					1, NULL, 'D'},	// Long Option Only
+    { "manifest",				1, NULL, 'M'},	// Long Option Only
+    { "max-parallel",			1, NULL, 'N'},	// Long Option Only
     { "quiet",					0, NULL, 'q'},
     { "debug",					0, NULL, 'd'},
+    { "verbose",				0, NULL, 'v'},
     { "help",					0, NULL, 'h'},
 };
 
@@ -129,16 +181,13 @@ int generate_result_log(char *filename, size_t filename_len, bool result);
 // Help
 void show_help_information(void);
 
-// HID Raw I/O Function
-int __hidraw_write(unsigned char* buf, int len, int timeout_ms);
-int __hidraw_read(unsigned char* buf, int len, int timeout_ms);
-
-// Abstract Device I/O Function
-int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
-int read_data(unsigned char *data_buf, int len, int timeout_ms);
-int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms);
+// Device Function
 int open_device(void);
 int close_device(void);
+int list_devices(void);
+
+// Signal
+void install_termination_handler(void);
 
 // Default Function
 int process_parameter(int argc, char **argv);
@@ -146,107 +195,6 @@ int resource_init(void);
 int resource_free(void);
 int main(int argc, char **argv);
 
-/*******************************************
- * HID Raw I/O Functions
- ******************************************/
-
-int __hidraw_write(unsigned char* buf, int len, int timeout_ms)
-{
-    int nRet = TP_SUCCESS;
-
-    if(g_pIntfGet == NULL)
-    {
-        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
-        goto __HIDRAW_WRITE_EXIT;
-    }
-
-    nRet = g_pIntfGet->WriteRawBytes(buf, len, timeout_ms);
-
-__HIDRAW_WRITE_EXIT:
-    return nRet;
-}
-
-int __hidraw_read(unsigned char* buf, int len, int timeout_ms)
-{
-    int nRet = TP_SUCCESS;
-
-    if(g_pIntfGet == NULL)
-    {
-        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
-        goto __HIDRAW_READ_EXIT;
-    }
-
-    nRet = g_pIntfGet->ReadRawBytes(buf, len, timeout_ms);
-
-__HIDRAW_READ_EXIT:
-    return nRet;
-}
-
-int __hidraw_write_command(unsigned char* buf, int len, int timeout_ms)
-{
-    int nRet = TP_SUCCESS;
-
-    if(g_pIntfGet == NULL)
-    {
-        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
-        goto __HIDRAW_WRITE_EXIT;
-    }
-
-    nRet = g_pIntfGet->WriteCommand(buf, len, timeout_ms);
-
-__HIDRAW_WRITE_EXIT:
-    return nRet;
-}
-
-int __hidraw_read_data(unsigned char* buf, int len, int timeout_ms)
-{
-    int nRet = TP_SUCCESS;
-
-    if(g_pIntfGet == NULL)
-    {
-        nRet = TP_ERR_COMMAND_NOT_SUPPORT;
-        goto __HIDRAW_READ_EXIT;
-    }
-
-    nRet = g_pIntfGet->ReadData(buf, len, timeout_ms);
-
-__HIDRAW_READ_EXIT:
-    return nRet;
-}
-
-/***************************************************
- * Abstract I/O Functions
- ***************************************************/
-
-int write_cmd(unsigned char *cmd_buf, int len, int timeout_ms)
-{
-    //write_bytes_from_buffer_to_i2c(cmd_buf); //pseudo function
-
-    /*** example *********************/
-    return __hidraw_write_command(cmd_buf, len, timeout_ms);
-    /*********************************/
-}
-
-int read_data(unsigned char *data_buf, int len, int timeout_ms)
-{
-    //read_bytes_from_i2c_to_buffer(data_buf, len, timeout); //pseudo function
-
-    /*** example *********************/
-    return __hidraw_read_data(data_buf, len, timeout_ms);
-    /*********************************/
-}
-
-int write_vendor_cmd(unsigned char *cmd_buf, int len, int timeout_ms)
-{
-    unsigned char vendor_cmd_buf[ELAN_I2CHID_OUTPUT_BUFFER_SIZE] = {0};
-
-    // Add HID Header
-    vendor_cmd_buf[0] = ELAN_HID_OUTPUT_REPORT_ID;
-    memcpy(&vendor_cmd_buf[1], cmd_buf, len);
-
-    return __hidraw_write(vendor_cmd_buf, sizeof(vendor_cmd_buf), timeout_ms);
-}
-
 /*******************************************
  * Function Implementation
  ******************************************/
@@ -324,6 +272,31 @@ void show_help_information(void)
     printf("-P <PID in hex>.\r\n");
     printf("Ex: elan_iap -P 732 (0x732)\r\n");
 
+    // hidraw Node
+    printf("\n[Device Node]\r\n");
+    printf("--device <hidraw_node>. (Open this node directly, no discovery; PID is read from the node)\r\n");
+    printf("Ex: elan_iap --device /dev/hidraw3 -i\r\n");
+
+    // Wait for Device
+    printf("\n[Wait for Device]\r\n");
+    printf("--wait-for-device <seconds> [--dev-dir <dir>]. (Wait for the hidraw node to appear instead of failing; dev-dir default %s, also watched to reopen a panel re-enumerated by reset)\r\n", HIDRAW_HOTPLUG_DEV_DIR);
+    printf("Ex: elan_iap --wait-for-device 10 -P 2a03 -i\r\n");
+
+    // Reopen Timeout
+    printf("\n[Reopen Timeout]\r\n");
+    printf("--reopen-timeout <msec>. (Time given to a panel whose hidraw node vanished mid-I/O to come back before the I/O fails, 0 disables the reopen; default %d. Library: elan_iap_device_set_reopen_timeout())\r\n", HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC);
+    printf("Ex: elan_iap --reopen-timeout 10000 -P 2a03 -f firmware.ekt\r\n");
+
+    // Feature Channel
+    printf("\n[Feature Channel]\r\n");
+    printf("--feature-channel. (Send single-reply query commands (0x53 / 0x96) by SET_FEATURE and read their responses by GET_FEATURE, for panels whose report descriptor has a vendor feature report; no touch / pen report filtering, fewer retries. Bulk ROM, flash key, calibration and IAP commands stay on output / input reports)\r\n");
+    printf("Ex: elan_iap --feature-channel -P 2a03 -i\r\n");
+
+    // List Devices
+    printf("\n[List Devices]\r\n");
+    printf("--list-devices. (Open every Elan I2C-HID panel of the host, print node, VID:PID, HID version and FW version of each)\r\n");
+    printf("Ex: elan_iap --list-devices\r\n");
+
     // File Path
     printf("\n[File Path]\r\n");
     printf("-f <file_path>.\r\n");
@@ -358,6 +331,41 @@ void show_help_information(void)
     printf("Ex: elan_iap -l /tmp/result.txt\r\n");
 #endif //__SUPPORT_RESULT_LOG__
 
+    // Binary hidraw Trace
+    printf("\n[hidraw Trace File Path]\r\n");
+    printf("-t <trace_file_path>. (Decode with elan_hidraw_trace_decode)\r\n");
+    printf("Ex: elan_iap -t /tmp/hidraw.trace -f firmware.ekt\r\n");
+
+    // Phase Timing
+    printf("\n[Phase Timing]\r\n");
+    printf("-T <timing_file_path>. (Print phase timing table, write JSON to file, \"-\" for table only)\r\n");
+    printf("Ex: elan_iap -T /tmp/timing.json -f firmware.ekt\r\n");
+
+    // Chrome Trace-Event Timeline
+    printf("\n[Timeline (Chrome Trace-Event JSON)]\r\n");
+    printf("-J <trace_json_file_path>, --trace-json <trace_json_file_path>. (Open with Perfetto / chrome://tracing)\r\n");
+    printf("Ex: elan_iap --trace-json /tmp/iap.json -f firmware.ekt\r\n");
+
+    // hidraw Latency Statistics
+    printf("\n[hidraw Latency Statistics]\r\n");
+    printf("--stats. (Print p50/p90/p99/max of write & response latency per command opcode at exit)\r\n");
+    printf("Ex: elan_iap --stats -f firmware.ekt\r\n");
+
+    // OpenMetrics Textfile
+    printf("\n[OpenMetrics (Prometheus Textfile) File Path]\r\n");
+    printf("-m <prom_file_path>, --metrics <prom_file_path>. (Replaced atomically at the end of each run)\r\n");
+    printf("Ex: elan_iap -m /var/lib/node_exporter/textfile_collector/elan_iap.prom -f firmware.ekt\r\n");
+
+    // Daemon Mode
+    printf("\n[Daemon Mode]\r\n");
+    printf("--daemon <socket_path>. (Keep devices open, serve \"<cmd> <selector>\" info / counter / calibrate / update requests on a Unix socket; selector as in --manifest)\r\n");
+    printf("Ex: elan_iap --daemon /run/elan_iap.sock\r\n");
+
+    // Fleet Manifest
+    printf("\n[Fleet Manifest]\r\n");
+    printf("--manifest <manifest_file> [--max-parallel <n>]. (Lines of \"<selector> <firmware_file> [skip_action]\", selector: /dev/hidrawN, <pid_hex> or <pid_hex>@i2c-<N>; default %d at a time, spread over I2C adapters first)\r\n", MANIFEST_DEFAULT_MAX_PARALLEL);
+    printf("Ex: elan_iap --manifest /etc/elan_fleet.txt --max-parallel 8\r\n");
+
     // Silent (Quiet) Mode
     printf("\n[Silent Mode]\r\n");
     printf("-q.\r\n");
@@ -368,6 +376,11 @@ void show_help_information(void)
     printf("-d.\r\n");
     printf("Ex: elan_iap -d\r\n");
 
+    // Verbose
+    printf("\n[Verbose]\r\n");
+    printf("-v (debug), -vv (trace).\r\n");
+    printf("Ex: elan_iap -vv -i\r\n");
+
     // Help Information
     printf("\n[Help]\r\n");
     printf("-h.\r\n");
@@ -383,17 +396,68 @@ void show_help_information(void)
 int open_device(void)
 {
     int err = TP_SUCCESS;
+    const char *p_name = NULL;
+    char device_path[I2CHID_DEV_PATH_LEN_MAX] = {0};
+    struct hidraw_hotplug_match match;
+
+    // Wait for the node (ex: panel still enumerating after power-on or reset)
+    if(g_wait_for_device_sec > 0)
+    {
+        p_name = strrchr(g_device_path, '/');
+        match.name = (strcmp(g_device_path, "") != 0) ? ((p_name) ? p_name + 1 : g_device_path) : NULL;
+        match.vid = ELAN_USB_VID;
+        match.pid = g_pid;
+        match.phys = NULL;
+
+        DEBUG_PRINTF("Wait up to %ds for hidraw device in %s.\r\n", g_wait_for_device_sec, hidraw_hotplug_get_dev_dir());
+        err = hidraw_hotplug_wait(&match, g_wait_for_device_sec * 1000, device_path, sizeof(device_path));
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("No device appeared in %ds! err=0x%x.\r\n", g_wait_for_device_sec, err);
+            return err;
+        }
+
+        // Connect exactly the node that appeared
+        strcpy(g_device_path, device_path);
+    }
 
     // open specific device on i2c bus //pseudo function
 
     /*** example *********************/
     // Connect to Device
-    DEBUG_PRINTF("Get I2C-HID Device Handle (VID=0x%x, PID=0x%x).\r\n", ELAN_USB_VID, g_pid);
-    err = g_pIntfGet->GetDeviceHandle(ELAN_USB_VID, g_pid);
+    if(strcmp(g_device_path, "") != 0)
+    {
+        DEBUG_PRINTF("Get I2C-HID Device Handle (%s).\r\n", g_device_path);
+        err = g_pIntfGet->GetDeviceHandleByPath(g_device_path);
+    }
+    else
+    {
+        DEBUG_PRINTF("Get I2C-HID Device Handle (VID=0x%x, PID=0x%x).\r\n", ELAN_USB_VID, g_pid);
+        err = g_pIntfGet->GetDeviceHandle(ELAN_USB_VID, g_pid);
+    }
     if (err != TP_SUCCESS)
+    {
         ERROR_PRINTF("Device can't connected! err=0x%x.\n", err);
+        return err;
+    }
     /*********************************/
 
+    // Reopen window for a node re-enumerated by panel reset
+    g_pIntfGet->SetHotplugReopenTimeout(g_reopen_timeout_msec);
+    DEBUG_PRINTF("Reopen Timeout: %dms.\r\n", g_reopen_timeout_msec);
+
+    // Query commands & their responses through the vendor feature report
+    if(g_feature_channel == true)
+    {
+        if(g_pIntfGet->HasFeatureChannel())
+        {
+            g_pIntfGet->SetFeatureChannel(true);
+            DEBUG_PRINTF("Feature Channel: Enable.\r\n");
+        }
+        else
+            WARN_PRINTF("No vendor feature report on device, commands stay on output / input reports.\r\n");
+    }
+
     return err;
 }
 
@@ -411,6 +475,57 @@ int close_device(void)
     return err;
 }
 
+// Open Every Elan I2C-HID Panel on One Interface & Print One Line per Panel
+int list_devices(void)
+{
+    int err = TP_SUCCESS,
+        dev_idx = 0,
+        dev_count = 0;
+    unsigned int vid = 0,
+                 pid = 0,
+                 version = 0;
+    unsigned short fw_version = 0;
+    bool gen8_touch = false,
+         recovery = false;
+    char dev_path[I2CHID_DEV_PATH_LEN_MAX] = {0},
+         fw_text[16] = {0};
+
+    err = g_pIntfGet->EnumerateDevices(ELAN_USB_VID);
+    if(err != TP_SUCCESS)
+    {
+        ERROR_PRINTF("No Elan I2C-HID device found! err=0x%x.\r\n", err);
+        goto LIST_DEVICES_EXIT;
+    }
+
+    dev_count = g_pIntfGet->GetDevCount();
+    printf("%-3s %-14s %-10s %-8s %-5s %s\r\n", "#", "Device", "VID:PID", "HID Ver", "Gen8", "FW Version");
+    for(dev_idx = 0; dev_idx < dev_count; dev_idx++)
+    {
+        CDeviceIoBinding binding(g_pIntfGet, g_firmware_fd, dev_idx);
+
+        g_pIntfGet->GetDevPath(dev_idx, dev_path, sizeof(dev_path));
+        g_pIntfGet->GetDevVidPid(&vid, &pid, dev_idx);
+        g_pIntfGet->GetDevVersion(&version, dev_idx);
+
+        // One Bad Panel Does Not Hide the Others
+        strcpy(fw_text, "-");
+        if(detect_touch_state(&gen8_touch, &recovery) != TP_SUCCESS)
+            strcpy(fw_text, "(no response)");
+        else if(recovery)
+            strcpy(fw_text, "(recovery)");
+        else if(get_fw_version(&fw_version) == TP_SUCCESS)
+            snprintf(fw_text, sizeof(fw_text), "%04x", fw_version);
+
+        printf("%-3d %-14s %04x:%04x  %04x     %-5s %s\r\n", dev_idx, dev_path, vid, pid, version, (gen8_touch) ? "yes" : "no", fw_text);
+    }
+
+    // Success
+    err = TP_SUCCESS;
+
+LIST_DEVICES_EXIT:
+    return err;
+}
+
 /*******************************************
  *  Initialize & Free Resource
  ******************************************/
@@ -433,6 +548,17 @@ int resource_init(void)
         goto RESOURCE_INIT_EXIT;
     }
 
+    // Start hidraw Trace
+    if(strcmp(g_trace_file, "") != 0)
+    {
+        err = g_pIntfGet->EnableTrace(g_trace_file);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("Fail to open trace file \"%s\"! err=0x%x.\r\n", g_trace_file, err);
+            goto RESOURCE_INIT_EXIT;
+        }
+    }
+
     if(g_update_fw == true)
     {
         // Open Firmware File
@@ -650,6 +776,191 @@ int process_parameter(int argc, char **argv)
                 break;
 #endif //__SUPPORT_RESULT_LOG__
 
+            case 't': /* hidraw Trace Filename */
+
+                // Check if filename is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Trace Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set trace filename
+                strncpy(g_trace_file, optarg, sizeof(g_trace_file) - 1);
+                DEBUG_PRINTF("%s: Trace Filename: \"%s\".\r\n", __func__, g_trace_file);
+                break;
+
+            case 'T': /* Phase Timing */
+
+                // Check if filename is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Timing Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Enable phase timing report ("-" = summary table only)
+                g_phase_timing = true;
+                if (strcmp(optarg, "-") != 0)
+                    strncpy(g_timing_file, optarg, sizeof(g_timing_file) - 1);
+                DEBUG_PRINTF("%s: Phase Timing: Enable, File: \"%s\".\r\n", __func__, g_timing_file);
+                break;
+
+            case 'J': /* Chrome Trace-Event Timeline */
+
+                // Check if filename is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Trace JSON Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set trace-event filename
+                strncpy(g_trace_json_file, optarg, sizeof(g_trace_json_file) - 1);
+                DEBUG_PRINTF("%s: Trace JSON Filename: \"%s\".\r\n", __func__, g_trace_json_file);
+                break;
+
+            case 'm': /* OpenMetrics Filename */
+
+                // Check if filename is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Metrics Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set metrics filename
+                strncpy(g_metrics_file, optarg, sizeof(g_metrics_file) - 1);
+                DEBUG_PRINTF("%s: Metrics Filename: \"%s\".\r\n", __func__, g_metrics_file);
+                break;
+
+            case 'H': /* hidraw Node */
+
+                // Check if device path is valid
+                if ((strlen(optarg) == 0) || (strlen(optarg) >= sizeof(g_device_path)))
+                {
+                    ERROR_PRINTF("%s: Device Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set device path
+                strcpy(g_device_path, optarg);
+                DEBUG_PRINTF("%s: Device: \"%s\".\r\n", __func__, g_device_path);
+                break;
+
+            case 'W': /* Wait for Device */
+
+                // Make Sure Data Valid
+                g_wait_for_device_sec = atoi(optarg);
+                if (g_wait_for_device_sec <= 0)
+                {
+                    ERROR_PRINTF("%s: Invalid Wait Time: %s!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+                DEBUG_PRINTF("%s: Wait for Device: %ds.\r\n", __func__, g_wait_for_device_sec);
+                break;
+
+            case 'R': /* Device Directory */
+
+                // Set directory watched for hidraw nodes
+                err = hidraw_hotplug_set_dev_dir(optarg);
+                if (err != TP_SUCCESS)
+                {
+                    ERROR_PRINTF("%s: Device Directory (%s) Invalid!\r\n", __func__, optarg);
+                    goto PROCESS_PARAM_EXIT;
+                }
+                DEBUG_PRINTF("%s: Device Directory: \"%s\".\r\n", __func__, optarg);
+                break;
+
+            case 'O': /* Reopen Timeout */
+
+                // Make Sure Data Valid (0: Fail at Once when Node Vanishes)
+                g_reopen_timeout_msec = atoi(optarg);
+                if ((g_reopen_timeout_msec < 0) || ((g_reopen_timeout_msec == 0) && (strcmp(optarg, "0") != 0)))
+                {
+                    ERROR_PRINTF("%s: Invalid Reopen Timeout: %s!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+                DEBUG_PRINTF("%s: Reopen Timeout: %dms.\r\n", __func__, g_reopen_timeout_msec);
+                break;
+
+            case 'C': /* Feature Channel */
+
+                // Send query commands by SET_FEATURE, read their responses by GET_FEATURE
+                g_feature_channel = true;
+                DEBUG_PRINTF("%s: Feature Channel: Enable.\r\n", __func__);
+                break;
+
+            case 'L': /* List Devices */
+
+                // Enumerate every panel instead of connecting one
+                g_list_devices = true;
+                DEBUG_PRINTF("%s: List Devices: Enable.\r\n", __func__);
+                break;
+
+            case 'D': /* Daemon Mode */
+
+                // Check if socket path is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Daemon Socket Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set socket path
+                strncpy(g_daemon_socket, optarg, sizeof(g_daemon_socket) - 1);
+                DEBUG_PRINTF("%s: Daemon Socket: \"%s\".\r\n", __func__, g_daemon_socket);
+                break;
+
+            case 'M': /* Fleet Manifest */
+
+                // Check if filename is valid
+                file_path_len = strlen(optarg);
+                if ((file_path_len == 0) || (file_path_len >= FILE_NAME_LENGTH_MAX))
+                {
+                    ERROR_PRINTF("%s: Manifest Path (%s) Invalid!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+
+                // Set manifest filename
+                strncpy(g_manifest_file, optarg, sizeof(g_manifest_file) - 1);
+                DEBUG_PRINTF("%s: Manifest: \"%s\".\r\n", __func__, g_manifest_file);
+                break;
+
+            case 'N': /* Max Parallel Updates */
+
+                // Make Sure Data Valid
+                g_max_parallel = atoi(optarg);
+                if ((g_max_parallel <= 0) || (g_max_parallel > MANIFEST_MAX_ENTRIES))
+                {
+                    ERROR_PRINTF("%s: Invalid Max Parallel: %s!\r\n", __func__, optarg);
+                    err = TP_ERR_INVALID_PARAM;
+                    goto PROCESS_PARAM_EXIT;
+                }
+                DEBUG_PRINTF("%s: Max Parallel: %d.\r\n", __func__, g_max_parallel);
+                break;
+
+            case 'S': /* hidraw Latency Statistics */
+
+                // Print latency histograms at exit
+                g_latency_stats = true;
+                DEBUG_PRINTF("%s: Latency Statistics: Enable.\r\n", __func__);
+                break;
+
             case 'q': /* Silent Mode (Quiet) */
 
                 // Enable Silent Mode
@@ -661,9 +972,21 @@ int process_parameter(int argc, char **argv)
 
                 // Enable Debug & Output Buffer Debug
                 g_debug = true;
+                if(g_nLogLevel > LOG_LEVEL_DEBUG)
+                    g_nLogLevel = LOG_LEVEL_DEBUG;
                 DEBUG_PRINTF("Debug: %s.\r\n", (g_debug) ? "Enable" : "Disable");
                 break;
 
+            case 'v': /* Verbose (Repeatable) */
+
+                // Lower Console Log Level by One
+                if(g_nLogLevel > LOG_LEVEL_TRACE)
+                    g_nLogLevel--;
+                if(g_nLogLevel <= LOG_LEVEL_DEBUG)
+                    g_debug = true;
+                DEBUG_PRINTF("Log Level: %d.\r\n", g_nLogLevel);
+                break;
+
             case 'h': /* Help */
 
                 // Set debug
@@ -678,7 +1001,11 @@ int process_parameter(int argc, char **argv)
     }
 
     // Check if PID is not null
-    if(g_pid == 0)
+    if(strcmp(g_device_path, "") != 0)
+    {
+        DEBUG_PRINTF("%s: Device node is set, skip discovery.\r\n", __func__);
+    }
+    else if(g_pid == 0)
     {
         DEBUG_PRINTF("%s: PID is not set, look for an appropriate PID...\r\n", __func__);
     }
@@ -705,6 +1032,32 @@ PROCESS_PARAM_EXIT:
     return err;
 }
 
+/*******************************************
+ * Signal
+ ******************************************/
+
+// Killed CLI Run Still Leaves Its Flight Dump Behind
+// (The Library Only Hooks Fatal Signals; Termination Belongs to the Application.)
+static void termination_signal_handler(int signal_number)
+{
+    CHidrawFlightRecorder::DumpAll();
+
+    // SA_RESETHAND Restored the Default Action, so This Terminates
+    raise(signal_number);
+}
+
+void install_termination_handler(void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = termination_signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+}
+
 /*******************************************
  * Main Function
  ******************************************/
@@ -712,9 +1065,8 @@ PROCESS_PARAM_EXIT:
 int main(int argc, char **argv)
 {
     int err = TP_SUCCESS;
-    unsigned short fw_bc_version = 0,
-                   bc_bc_version = 0;
-    unsigned char hello_packet = 0;
+    unsigned int vid = 0,
+                 pid = 0;
     bool gen8_touch = false,	// True if Gen8 Touch
          recovery = false;		// True if Recovery Mode
     message_mode_t msg_mode;
@@ -738,6 +1090,56 @@ int main(int argc, char **argv)
         goto EXIT;
     }
 
+    /* Per-Run Reports Describe a Single Device, Not a Daemon or a Fleet */
+    if(((strcmp(g_daemon_socket, "") != 0) || (strcmp(g_manifest_file, "") != 0)) &&
+       ((strcmp(g_timing_file, "") != 0) || (strcmp(g_trace_json_file, "") != 0) || (strcmp(g_metrics_file, "") != 0)))
+    {
+        ERROR_PRINTF("--timing, --trace-json and --metrics can not be used with --daemon or --manifest!\r\n");
+        err = TP_ERR_INVALID_PARAM;
+        goto EXIT;
+    }
+
+    /* Devices of a Daemon or a Fleet Keep the Default Reopen Window */
+    if(((strcmp(g_daemon_socket, "") != 0) || (strcmp(g_manifest_file, "") != 0)) &&
+       (g_reopen_timeout_msec != HIDRAW_HOTPLUG_REOPEN_TIMEOUT_MSEC))
+    {
+        ERROR_PRINTF("--reopen-timeout can not be used with --daemon or --manifest!\r\n");
+        err = TP_ERR_INVALID_PARAM;
+        goto EXIT;
+    }
+
+    /* Daemon Mode */
+    if(strcmp(g_daemon_socket, "") != 0)
+    {
+        err = daemon_run(g_daemon_socket);
+        goto EXIT;
+    }
+
+    /* Dump Flight Recorders on SIGINT / SIGTERM (Daemon Takes Them from signalfd) */
+    install_termination_handler();
+
+    /* Fleet Manifest Mode */
+    if(strcmp(g_manifest_file, "") != 0)
+    {
+        err = manifest_run(g_manifest_file, g_max_parallel);
+        goto EXIT;
+    }
+
+    /* Start Phase Timing Clock */
+    phase_timing_reset();
+    run_metrics_reset();
+
+    /* Start Trace-Event Timeline */
+    if(strcmp(g_trace_json_file, "") != 0)
+    {
+        err = trace_event_open(g_trace_json_file);
+        if(err != TP_SUCCESS)
+        {
+            ERROR_PRINTF("Fail to open trace JSON file \"%s\"! err=0x%x.\r\n", g_trace_json_file, err);
+            goto EXIT;
+        }
+    }
+
     /* Initialize Resource */
     err = resource_init();
     if (err != TP_SUCCESS)
@@ -746,72 +1148,36 @@ int main(int argc, char **argv)
         goto EXIT1;
     }
 
+    /* List Every Panel */
+    if(g_list_devices == true)
+    {
+        err = list_devices();
+        goto EXIT2;
+    }
+
     /* Open Device */
+    phase_begin(PHASE_DEVICE_DISCOVERY);
     err = open_device() ;
+    phase_end(PHASE_DEVICE_DISCOVERY);
     if (err != TP_SUCCESS)
     {
         ERROR_PRINTF("Fail to Open Device! err=0x%x.\r\n", err);
         goto EXIT2;
     }
 
-    /* Detect Touch State */
+    /* Record Device VID / PID */
+    if(g_pIntfGet->GetDevVidPid(&vid, &pid) == TP_SUCCESS)
+        run_metrics_set_device(vid, pid);
 
-    // Get Hello Packet
-    err = get_hello_packet_bc_version_with_error_retry(&hello_packet, &bc_bc_version, ERROR_RETRY_COUNT);
+    /* Detect Touch State */
+    phase_begin(PHASE_HELLO_PROBE);
+    err = detect_touch_state(&gen8_touch, &recovery);
+    phase_end(PHASE_HELLO_PROBE);
     if(err != TP_SUCCESS)
     {
-        ERROR_PRINTF("Fail to Get Hello Packet (& BC Version)! err=0x%x.\r\n", err);
+        ERROR_PRINTF("Fail to Detect Touch State! err=0x%x.\r\n", err);
         goto EXIT2;
     }
-    DEBUG_PRINTF("Hello Packet: 0x%02x, Recovery Mode BC Version: 0x%04x.\r\n", hello_packet, bc_bc_version);
-
-    // Identify HW Series & Touch State
-    switch (hello_packet)
-    {
-        case ELAN_I2CHID_NORMAL_MODE_HELLO_PACKET:
-            // BC Version (Normal Mode)
-            err = get_boot_code_version(&fw_bc_version);
-            if(err != TP_SUCCESS)
-            {
-                ERROR_PRINTF("%s: Fail to Get BC Version (Normal Mode)! err=0x%x.\r\n", __func__, err);
-                goto EXIT2;
-            }
-            DEBUG_PRINTF("Normal Mode BC Version: 0x%04x.\r\n", fw_bc_version);
-
-            // Special Case: First BC of EM32F901 / EM32F902
-            if((HIGH_BYTE(fw_bc_version) == BC_VER_H_BYTE_FOR_EM32F901_I2CHID) /* EM32F901 */ ||
-               (HIGH_BYTE(fw_bc_version) == BC_VER_H_BYTE_FOR_EM32F902_I2CHID) /* FM32F902 */)
-                gen8_touch = true;	// Gen8 Touch
-            else
-                gen8_touch = false;	// Gen5/6/7 Touch
-            recovery = false;		// Normal Mode
-            break;
-
-        case ELAN_GEN8_I2CHID_NORMAL_MODE_HELLO_PACKET:
-            gen8_touch = true;		// Gen8 Touch
-            recovery = false;		// Normal Mode
-            break;
-
-        case ELAN_I2CHID_RECOVERY_MODE_HELLO_PACKET:
-            // Special Case: First BC of EM32F901 / EM32F902
-            if((HIGH_BYTE(bc_bc_version) == BC_VER_H_BYTE_FOR_EM32F901_I2CHID) /* EM32F901 */ ||
-               (HIGH_BYTE(bc_bc_version) == BC_VER_H_BYTE_FOR_EM32F902_I2CHID) /* FM32F902 */)
-                gen8_touch = true;	// Gen8 Touch
-            else
-                gen8_touch = false;	// Gen5/6/7 Touch
-            recovery = true;		// Recovery Mode
-            break;
-
-        case ELAN_GEN8_I2CHID_RECOVERY_MODE_HELLO_PACKET:
-            gen8_touch = true;		// Gen8 Touch
-            recovery = true;		// Recovery Mode
-            break;
-
-        default:
-            ERROR_PRINTF("%s: Unknown Hello Packet! (0x%02x) \r\n", __func__, hello_packet);
-            err = TP_UNKNOWN_DEVICE_TYPE;
-            goto EXIT2;
-    }
 
     // Reconfigure if Recovery Mode
     if(recovery == true)
@@ -826,10 +1192,12 @@ int main(int argc, char **argv)
     if((g_get_fw_info == true) && (g_update_fw == false))
     {
         DEBUG_PRINTF("Get FW Info.\r\n");
+        phase_begin(PHASE_INFO_QUERY);
         if(gen8_touch) // Gen8 Touch
             err = gen8_get_firmware_information(g_msg_mode);
         else // Gen5/6/7 Touch
             err = get_firmware_information(g_msg_mode);
+        phase_end(PHASE_INFO_QUERY);
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("Fail to Get FW Info!\r\n");
@@ -866,7 +1234,9 @@ int main(int argc, char **argv)
         if(gen8_touch == false) // Gen5/6/7 Touch
         {
             DEBUG_PRINTF("Calibrate Touch...\r\n");
+            phase_begin(PHASE_CALIBRATION);
             err = calibrate_touch_with_error_retry(ERROR_RETRY_COUNT);
+            phase_end(PHASE_CALIBRATION);
             if (err != TP_SUCCESS)
             {
                 ERROR_PRINTF("Fail to Calibrate Touch!\r\n");
@@ -904,10 +1274,12 @@ int main(int argc, char **argv)
         {
             // Get FW Info.
             DEBUG_PRINTF("Get FW Info.\r\n");
+            phase_begin(PHASE_INFO_QUERY);
             if(gen8_touch) // Gen8 Touch
                 err = gen8_get_firmware_information(FULL_MESSAGE); // Disable Silent Mode
             else // Gen5/6/7 Touch
                 err = get_firmware_information(FULL_MESSAGE); // Disable Silent Mode
+            phase_end(PHASE_INFO_QUERY);
             if(err != TP_SUCCESS)
             {
                 ERROR_PRINTF("Fail to Get FW Info!\r\n");
@@ -930,13 +1302,16 @@ int main(int argc, char **argv)
             ERROR_PRINTF("Fail to Update Firmware (%s)!\r\n", g_firmware_filename);
             goto EXIT2;
         }
+        run_metrics_mark_updated(); // Later FW Versions are Reported as "after"
 
         // Verify FW Update with FW Information
         DEBUG_PRINTF("Get FW Info.\r\n");
+        phase_begin(PHASE_POST_UPDATE_INFO);
         if(gen8_touch) // Gen8 Touch
             err = gen8_get_firmware_information(FULL_MESSAGE); // Disable Silent Mode
         else // Gen5/6/7 Touch
             err = get_firmware_information(FULL_MESSAGE); // Disable Silent Mode
+        phase_end(PHASE_POST_UPDATE_INFO);
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("Fail to Get FW Info!\r\n");
@@ -945,13 +1320,14 @@ int main(int argc, char **argv)
 
         // Re-calibrate Touch
         DEBUG_PRINTF("Calibrate Touch...\r\n");
+        phase_begin(PHASE_CALIBRATION);
         if(gen8_touch)
         {
             /* [Note] 2022/06/06
             * With the information from FW Solution Team, it takes 100ms for touch to self-calibrate after power-on.
             * For safety reasons, a waiting time of 300ms is recommended.
             */
-            usleep(300 * 1000); // wait 300ms
+            trace_usleep(300 * 1000); // wait 300ms
         }
         else // Gen5/6/7 Touch
         {
@@ -965,6 +1341,7 @@ int main(int argc, char **argv)
 
         // Verify Calibration with Counter
         err = get_calibration_counter(NO_MESSAGE);
+        phase_end(PHASE_CALIBRATION);
         if(err != TP_SUCCESS)
         {
             ERROR_PRINTF("Fail to Get Calibration Counter!\r\n");
@@ -976,12 +1353,32 @@ int main(int argc, char **argv)
     err = TP_SUCCESS;
 
 EXIT2:
+    /* Keep Last hidraw Traffic for Failure Analysis */
+    if((err != TP_SUCCESS) && (g_pIntfGet != NULL))
+        g_pIntfGet->DumpFlightRecorder();
+
+    /* hidraw Latency Statistics */
+    if((g_latency_stats == true) && (g_pIntfGet != NULL))
+        g_pIntfGet->PrintLatencyStats(stdout);
+
     /* Close Device */
     close_device();
 
 EXIT1:
     resource_free();
 
+    /* Finish Trace-Event Timeline */
+    trace_event_close();
+
+    /* Phase Timing Report */
+    if(g_phase_timing == true)
+    {
+        if(g_msg_mode == FULL_MESSAGE)
+            phase_timing_print_summary(stdout);
+        if((strcmp(g_timing_file, "") != 0) && (phase_timing_write_json(g_timing_file) != TP_SUCCESS))
+            ERROR_PRINTF("Fail to write phase timing to \"%s\"!\r\n", g_timing_file);
+    }
+
 EXIT:
 #ifdef __SUPPORT_RESULT_LOG__
     // Log Result
@@ -991,6 +1388,14 @@ EXIT:
         generate_result_log(g_log_file, sizeof(g_log_file), false /* FAIL */);
 #endif //__SUPPORT_RESULT_LOG__
 
+    // OpenMetrics Textfile
+    if(strcmp(g_metrics_file, "") != 0)
+    {
+        run_metrics_set_result(err);
+        if(run_metrics_write_openmetrics(g_metrics_file) != TP_SUCCESS)
+            ERROR_PRINTF("Fail to write metrics to \"%s\"!\r\n", g_metrics_file);
+    }
+
     if(g_msg_mode == FULL_MESSAGE) // Disable Silent Mode
     {
         // End of Output Stream